@@ -0,0 +1,67 @@
+mod main;
+
+import print;
+import arena;
+
+struct Point {
+    x: i32;
+    y: i32;
+}
+
+fn main(x: i32, y: i32) -> i32 {
+    if (x < 1) {
+        x = 1;
+    }
+
+    // y rounds of x points and an array of their sums, each round is freed
+    // at once by a reset
+    let arena = Arena(64);
+    let points = new (*Point)[x];
+    let first = 0;
+    let reused = true;
+    let total = 0;
+    let round = 0;
+    while (round < y) {
+        let i = 0;
+        while (i < x) {
+            let point = new Point in arena;
+            point.x = i;
+            point.y = round;
+            points[i] = point;
+            i = i + 1;
+        }
+        let sums = new i32[x] in arena;
+        i = 0;
+        while (i < x) {
+            let point = points[i];
+            sums[i] = point.x + point.y;
+            i = i + 1;
+        }
+        i = 0;
+        while (i < x) {
+            total = total + sums[i];
+            i = i + 1;
+        }
+
+        // after the first round everything fits in the chunk reset kept
+        if (round == 1) {
+            first = points[0] as i32;
+        }
+        if (round > 1 && points[0] as i32 != first) {
+            reused = false;
+        }
+        arena.reset();
+        round = round + 1;
+    }
+
+    print(total);
+    println("");
+    print(reused);
+    println("");
+    print(arena.capacity);
+    println("");
+    arena.destruct();
+    delete points;
+
+    return 0;
+}
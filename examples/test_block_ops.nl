@@ -0,0 +1,84 @@
+mod main;
+
+import print;
+
+struct Initials {
+    first: char;
+    last: char;
+}
+
+fn sum(data: *i32, n: i32) -> i32 {
+    let total = 0;
+    let i = 0;
+    while (i < n) {
+        total = total + data[i];
+        i = i + 1;
+    }
+    return total;
+}
+
+fn main(x: i32, y: i32) -> i32 {
+    if (x < 0) {
+        x = 0;
+    }
+
+    // n words filled with y and copied between two guard words
+    let n = x + 9;
+    let a = new i32[n];
+    fill(a, y, n);
+    let b = new i32[n + 2];
+    fill(b, -1, n + 2);
+    copy(b + 1, a, n);
+    print(sum(b + 1, n));
+    println("");
+    print(b[0] + b[n + 1]);
+    println("");
+
+    // overlapping copies move down
+    let i = 0;
+    while (i < n) {
+        a[i] = i;
+        i = i + 1;
+    }
+    copy(a, a + 1, n - 1);
+    print(a[0] + a[n - 2] + a[n - 1]);
+    println("");
+
+    // nothing happens for counts below one
+    copy(a, b, 0);
+    fill(a, 7, -3);
+    print(a[0]);
+    println("");
+
+    // chars and structs with chars may not be whole words
+    let s = new char[n + 1];
+    fill(s, 'z', n);
+    s[0] = 'a';
+    let t = new char[n + 2];
+    fill(t, '-', n + 2);
+    copy(t + 1, s, n);
+    t[n + 1] = 0 as char;
+    println(t);
+
+    let names = new Initials[x + 2];
+    i = 0;
+    while (i < x + 2) {
+        let name = names + i;
+        name.first = ('a' as i32 + i % 26) as char;
+        name.last = ('z' as i32 - i % 26) as char;
+        i = i + 1;
+    }
+    let copies = new Initials[x + 2];
+    copy(copies, names, x + 2);
+    let last = copies + x + 1;
+    print(last.first);
+    print(last.last);
+    println("");
+
+    let flags = new bool[3];
+    fill(flags, true, 3);
+    print(flags[2]);
+    println("");
+
+    return 0;
+}
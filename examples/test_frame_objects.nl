@@ -0,0 +1,82 @@
+mod main;
+
+import print;
+
+struct Point {
+    x: i32;
+    y: i32;
+}
+
+// the point and the buffer never leave the call, so they live in its frame
+fn distance(x: i32, y: i32) -> i32 {
+    let point = new Point;
+    point.x = x;
+    point.y = y;
+    let digits = new i32[8];
+    let i = 0;
+    while (i < 8) {
+        digits[i] = i * point.x - point.y;
+        i = i + 1;
+    }
+    let result = 0;
+    i = 0;
+    while (i < 8) {
+        if (digits[i] > 0) {
+            result = result + digits[i];
+        }
+        i = i + 1;
+    }
+    delete digits;
+    delete point;
+    return result;
+}
+
+// every call has its own object
+fn depth(n: i32) -> i32 {
+    let value = new i32;
+    *value = n;
+    let result = 0;
+    if (n > 0) {
+        result = depth(n - 1);
+    }
+    return result + *value;
+}
+
+// a returned object stays on the heap
+fn make_point(x: i32) -> *Point {
+    let point = new Point;
+    point.x = x;
+    point.y = x + 1;
+    return point;
+}
+
+fn main(x: i32, y: i32) -> i32 {
+    if (x < 0) {
+        x = 0;
+    }
+
+    let before = new i32;
+    let total = 0;
+    let i = 0;
+    while (i < x) {
+        total = total + distance(i, y);
+        i = i + 1;
+    }
+    let after = new i32;
+    print(total);
+    println("");
+    // the heap only grew by the block for before
+    print(after as i32 - before as i32);
+    println("");
+
+    print(depth(x));
+    println("");
+
+    let point = make_point(x);
+    print(point.x + point.y);
+    println("");
+    print(point as i32 - after as i32);
+    println("");
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+
+mod main;
+
+import print;
+import list;
+import string;
+
+struct Box {
+    value: i32;
+    data: *i32;
+    // points into data
+    middle: *i32;
+    name: *char;
+}
+
+fn make_box(i: i32) -> *Box {
+    let box = new Box;
+    box.value = i;
+    box.data = new i32[1 + i % 50];
+    box.middle = box.data + i % 50;
+    box.name = "box";
+    return box;
+}
+
+fn main(x: i32, y: i32) -> i32 {
+    if (x < 1) {
+        x = 1;
+    }
+    if (y < 1) {
+        y = 1;
+    }
+
+    // only a pointer into the middle of first is left on the stack
+    let first = new i32[10];
+    first[5] = 55;
+    let inner = first + 5;
+    first = 0 as *i32;
+
+    // x boxes of which the last y are kept, with garbage of up to four
+    // pages in between, is more than the heap holds without collecting
+    let boxes = new (*Box)[y];
+    let list = ListI32();
+    let str = String();
+    let i = 0;
+    while (i < x) {
+        let box = make_box(i);
+        box.middle[0] = i;
+        boxes[i % y] = box;
+        list.push_back(i);
+        str.push_back(('a' as i32 + i % 26) as char);
+        let garbage = new i32[1000 + i % 3000];
+        garbage[0] = i;
+        i = i + 1;
+    }
+
+    let kept = 0;
+    i = 0;
+    while (i < y && i < x) {
+        let box = boxes[i];
+        if (box.data[box.value % 50] == box.value && box.name[0] == 'b') {
+            kept = kept + 1;
+        }
+        i = i + 1;
+    }
+    print(kept);
+    println("");
+    print(list.size);
+    println("");
+    print(*list.at(x - 1));
+    println("");
+    print(str.data[x - 1]);
+    println("");
+    print(*inner);
+    println("");
+
+    return 0;
+}
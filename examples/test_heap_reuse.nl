@@ -0,0 +1,37 @@
+
+mod main;
+
+import print;
+
+fn main(x: i32, y: i32) -> i32 {
+    let first: *i32 = new i32;
+
+    // x rounds of blocks of changing sizes, freed ones merge back
+    // into the never used space so the heap does not grow
+    let i: i32 = 0;
+    while (i < x) {
+        let small: *i32 = new i32[i % 20];
+        let large: *i32 = new i32[100 + i % 7];
+        delete small;
+        delete large;
+        i = i + 1;
+    }
+    let end: *i32 = new i32[200];
+    let after: *i32 = new i32[100];
+    let guard: *i32 = new i32[60];
+    print(end as i32 - first as i32);
+    println("");
+
+    // neighbouring free blocks merge, requests that fit the merged block
+    // take it and leave what they do not need free
+    delete end;
+    delete after;
+    let fits: *i32 = new i32[y];
+    print(fits == end);
+    println("");
+    let rest: *i32 = new i32[50];
+    print(rest as i32 - fits as i32);
+    println("");
+
+    return 0;
+}
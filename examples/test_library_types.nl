@@ -0,0 +1,26 @@
+mod main;
+
+import string;
+import list;
+
+// fields typed with structs of library modules
+struct Entry {
+    name: *String;
+    counts: *ListI32;
+}
+
+fn main(x: i32, y: i32) -> i32 {
+    let entry = new Entry;
+    entry.name = String("entry");
+    entry.counts = ListI32();
+    let counts = entry.counts;
+    counts.push_back(x);
+    counts.push_back(y);
+    let name = entry.name;
+    name.println();
+    counts.println();
+    name.destruct();
+    counts.destruct();
+    delete entry;
+    return 0;
+}
@@ -0,0 +1,87 @@
+mod main;
+
+struct Buffer {
+    data: *i32;
+    size: i32;
+}
+
+fn Buffer(size: i32) -> *Buffer {
+    let buffer = new Buffer;
+    buffer.data = new i32[size];
+    buffer.size = size;
+    return buffer;
+}
+
+fn fill(self: *Buffer, step: i32) {
+    let i = 0;
+    while (i < self.size) {
+        self.data[i] = i * step;
+        i = i + 1;
+    }
+}
+
+fn sum_backwards(self: *Buffer) -> i32 {
+    let total = 0;
+    let i = self.size - 1;
+    while (i >= 0) {
+        total = (total * 2) + self.data[i];
+        i = i - 1;
+    }
+    return total;
+}
+
+fn grow_while_counting(self: *Buffer, limit: i32) -> i32 {
+    let i = 0;
+    while (i < self.size) {
+        if (self.size < limit) {
+            self.size = self.size + 1;
+        }
+        i = i + 1;
+    }
+    return i;
+}
+
+fn count_letters(start: i32, step: i32) -> i32 {
+    let s = "abcdefgh";
+    let total = 0;
+    let i = start;
+    while (i < 8) {
+        total = (total * 10) + ((s[i] as i32) - 97);
+        i = i + step;
+    }
+    return total;
+}
+
+fn skip_through_pointer(skip: i32) -> i32 {
+    let s = "abcdefgh";
+    let total = 0;
+    let i = 0;
+    let p = &i;
+    while (i < 8) {
+        total = (total * 10) + ((s[i] as i32) - 97);
+        *p = *p + skip;
+        i = i + 1;
+    }
+    return total;
+}
+
+fn main(test_code: i32, test_value: i32) -> i32 {
+    let buffer = Buffer(4);
+    let result = 0;
+    if (test_code == 1) {
+        buffer.fill(test_value);
+        result = sum_backwards(buffer);
+    }
+    if (test_code == 2) {
+        result = buffer.grow_while_counting(test_value);
+    }
+    if (test_code == 3) {
+        result = count_letters(test_value, 3);
+    }
+    if (test_code == 4) {
+        result = skip_through_pointer(test_value);
+    }
+    delete buffer.data;
+    delete buffer;
+    return result;
+}
@@ -0,0 +1,164 @@
+mod test;
+
+import map;
+import list;
+import string;
+import print;
+
+// keys spread over the whole i32 range, some of them multiples of large
+// powers of two
+fn key(i: i32) -> i32 {
+    return i * 7919 * 65536 - i;
+}
+
+fn main(test_code: i32, test_value: i32) -> i32 {
+    if (test_code == 1) {
+        let map = MapI32();
+        println(map.empty());
+        map.insert(5, 50);
+        map.insert(-5, -50);
+        map.insert(0, 7);
+        map.insert(65536, 1);
+        map.insert(131072, 2);
+        map.insert(5, 55);
+        println(map.size());
+        println(map.get(5, 0));
+        println(map.get(-5, 0));
+        println(map.get(0, 0));
+        println(map.get(131072, 0));
+        println(map.get(6, -1));
+        println(map.contains(65536));
+        *(map.at(65536)) = 9;
+        println(map.get(65536, 0));
+        println(map.at(3) as i32);
+        println(map.remove(0));
+        println(map.remove(0));
+        println(map.size());
+        map.destruct();
+    }
+
+    // test_value keys, every third removed, must all be found or missing
+    if (test_code == 2) {
+        let map = MapI32();
+        let i = 0;
+        while (i < test_value) {
+            map.insert(key(i), i);
+            i = i + 1;
+        }
+        i = 0;
+        while (i < test_value) {
+            if (i % 3 == 0) {
+                map.remove(key(i));
+            }
+            i = i + 1;
+        }
+        let found = 0;
+        let missing = 0;
+        let total = 0;
+        i = 0;
+        while (i < test_value) {
+            if (map.contains(key(i))) {
+                found = found + 1;
+                total = total + map.get(key(i), 0);
+            }
+            if (!map.contains(key(i)) && i % 3 == 0) {
+                missing = missing + 1;
+            }
+            i = i + 1;
+        }
+        println(map.size());
+        println(found);
+        println(missing);
+        println(total);
+        println(map.capacity);
+        map.destruct();
+    }
+
+    if (test_code == 3) {
+        let words = new (*String)[6];
+        words[0] = String("the");
+        words[1] = String("map");
+        words[2] = String("holds");
+        words[3] = String("the");
+        words[4] = String("words");
+        words[5] = String("");
+        let map = MapString();
+        let i = 0;
+        while (i < 6) {
+            map.insert(words[i], map.get(words[i], 0) + 1);
+            i = i + 1;
+        }
+        println(map.size());
+        println(map.get(String("the"), 0));
+        println(map.get(String("map"), 0));
+        println(map.get(String(""), 0));
+        println(map.contains(String("thee")));
+        println(map.remove(String("the")));
+        println(map.contains(words[0]));
+        println(map.size());
+        map.destruct();
+    }
+
+    // string keys made of the digits of test_value numbers
+    if (test_code == 4) {
+        let map = MapString();
+        let i = 0;
+        while (i < test_value) {
+            let str = String();
+            let n = i;
+            str.push_back(('0' as i32 + n % 10) as char);
+            while (n >= 10) {
+                n = n / 10;
+                str.push_back(('0' as i32 + n % 10) as char);
+            }
+            map.insert(str, i);
+            i = i + 1;
+        }
+        let str = String("71");
+        println(map.get(str, -1));
+        println(map.remove(str));
+        println(map.get(str, -1));
+        println(map.size());
+        map.destruct();
+    }
+
+    // test_value lookups in a map of test_value keys
+    if (test_code == 5) {
+        let map = MapI32();
+        let i = 0;
+        while (i < test_value) {
+            map.insert(key(i), i);
+            i = i + 1;
+        }
+        let total = 0;
+        i = 0;
+        while (i < test_value) {
+            total = total + map.get(key(i), 0);
+            i = i + 1;
+        }
+        println(total);
+    }
+
+    // the same lookups as scans over a list of keys
+    if (test_code == 6) {
+        let keys = ListI32();
+        let i = 0;
+        while (i < test_value) {
+            keys.push_back(key(i));
+            i = i + 1;
+        }
+        let total = 0;
+        i = 0;
+        while (i < test_value) {
+            let j = 0;
+            while (keys.get(j) != key(i)) {
+                j = j + 1;
+            }
+            total = total + j;
+            i = i + 1;
+        }
+        println(total);
+    }
+
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -24,44 +25,47 @@
 #include "extract_symbols.h"
 #include "flatten.h"
 #include "heap.h"
+#include "inline_calls.h"
 #include "label.h"
 #include "nex_lang_parsing.h"
 #include "nex_lang_scanning.h"
 #include "nl_lib.h"
+#include "nl_type_i32.h"
 #include "post_processing.h"
 #include "procedure.h"
+#include "profile.h"
 #include "program_context.h"
 #include "pseudo_assembly.h"
 #include "reg.h"
+#include "select_instructions.h"
 #include "symbol_table.h"
 #include "typed_procedure.h"
 #include "use_label.h"
 #include "word.h"
+#include "write_file.h"
 
 struct Variable;
 
 static uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
 
-std::vector<std::shared_ptr<Code>>
-compile(std::vector<std::string> input_file_paths) {
+LabelledProgram compile_labelled(
+    std::vector<std::string> input_file_paths,
+    CompileOptions options
+) {
     std::vector<std::pair<std::string, ASTNode>> modules;
     ProgramContext program_context;
+    program_context.packed_chars = options.select_instructions;
+    if (!options.profile_path.empty()) {
+        program_context.profile = read_profile(options.profile_path);
+    }
 
-    // add in heap as module
-    std::shared_ptr<Label> heap_start_label =
-        std::make_shared<Label>("heap start");
-    std::shared_ptr<Code> heap_start =
-        make_block({make_lis(Reg::Result), make_use(heap_start_label)});
-    std::shared_ptr<TypedProcedure> heap_allocate =
-        make_heap_allocate(heap_start);
-    std::shared_ptr<TypedProcedure> heap_free = make_heap_free(heap_start);
-    SymbolTable heap_module;
-    heap_module[{heap_allocate_id, {}}] = heap_allocate;
-    heap_module[{heap_free_id, {}}] = heap_free;
-
-    program_context.module_table[heap_module_id] = heap_module;
+    program_context.gc = options.gc;
+    program_context.frame_objects = options.frame_objects;
 
     std::vector<std::string> import_list;
+    if (options.gc) {
+        import_list.push_back("gc");
+    }
     // lex, parse and extract symbols from all provided files
     for (std::string input_file_path : input_file_paths) {
         std::ifstream file {input_file_path};
@@ -75,6 +79,7 @@ compile(std::vector<std::string> input_file_paths) {
         try {
             auto tokens = scan(input);
             auto ast_node = parse(tokens);
+            nl_lib_import_all(ast_node, import_list, program_context, modules);
             auto result_list = extract_symbols(ast_node, program_context);
             import_list.insert(
                 import_list.end(),
@@ -93,6 +98,31 @@ compile(std::vector<std::string> input_file_paths) {
         nl_lib_import(import_name, import_list, program_context, modules);
     }
 
+    // add in heap as module
+    std::shared_ptr<Label> heap_start_label =
+        std::make_shared<Label>("heap start");
+    std::shared_ptr<Code> heap_start =
+        make_block({make_lis(Reg::Result), make_use(heap_start_label)});
+    std::shared_ptr<TypedProcedure> heap_allocate;
+    std::shared_ptr<TypedProcedure> heap_free;
+    if (options.gc) {
+        auto i32 = std::make_shared<NLTypeI32>();
+        SymbolTableKey refill_key = {"refill", {i32, i32, i32}};
+        auto refill = std::dynamic_pointer_cast<TypedProcedure>(
+            program_context.module_table.at("gc").at(refill_key)
+        );
+        heap_allocate = make_gc_allocate(refill->procedure);
+        heap_free = make_gc_free();
+    } else {
+        heap_allocate = make_heap_allocate();
+        heap_free = make_heap_free();
+    }
+    SymbolTable heap_module;
+    heap_module[{heap_allocate_id, {}}] = heap_allocate;
+    heap_module[{heap_free_id, {}}] = heap_free;
+
+    program_context.module_table[heap_module_id] = heap_module;
+
     // generated intermediete code of all procedures
     std::vector<std::shared_ptr<Procedure>> procedures;
     std::vector<std::shared_ptr<Code>> static_data;
@@ -112,6 +142,14 @@ compile(std::vector<std::string> input_file_paths) {
     procedures.push_back(heap_allocate->procedure);
     procedures.push_back(heap_free->procedure);
 
+    for (auto proc : procedures) {
+        if (proc->code) {
+            proc->code =
+                make_block({make_define(proc->body_label), proc->code});
+        }
+    }
+    inline_calls(procedures, options.inline_threshold, program_context.profile);
+
     std::vector<std::shared_ptr<Code>> all_code;
 
     std::shared_ptr<Procedure> main_proc;
@@ -121,18 +159,13 @@ compile(std::vector<std::string> input_file_paths) {
         }
     }
 
-    std::map<std::shared_ptr<Procedure>, std::shared_ptr<Chunk>> param_chunks;
-    for (auto proc : procedures) {
-        param_chunks[proc] = std::make_shared<Chunk>(proc->parameters);
-    }
-
     // add program entry point
     auto start_proc = std::make_shared<Procedure>(
         "start_proc",
         std::vector<std::shared_ptr<Variable>> {}
     );
     start_proc->code = make_block(
-        {init_heap(heap_start),
+        {options.gc ? init_gc_heap(heap_start) : init_heap(heap_start),
          make_call(main_proc, {to_expr(Reg::Input1), to_expr(Reg::Input2)}),
          make_lis(Reg::TargetPC),
          make_word(TERMINATION_PC),
@@ -142,24 +175,50 @@ compile(std::vector<std::string> input_file_paths) {
 
     // compile down intermediete representations into machine code
     for (auto proc : procedures) {
-        compile_procedure(proc, param_chunks);
+        compile_procedure(proc);
     }
 
+    // hot procedures are placed together after the entry point, those that
+    // never ran last
+    const Profile& profile = program_context.profile;
+    std::stable_sort(
+        procedures.begin() + 1,
+        procedures.end(),
+        [&profile](auto& a, auto& b) {
+            return profile_count(profile, a->body_label->name)
+                > profile_count(profile, b->body_label->name);
+        }
+    );
+
     for (auto proc : procedures) {
         all_code.push_back(proc->code);
     }
 
-    auto program = make_block(
-        {make_block(all_code),
-         make_block(static_data),
-         make_define(heap_start_label)}
-    );
-
     Flatten flatten;
-    program->accept(flatten);
+    make_block(all_code)->accept(flatten);
+    auto program = flatten.get();
 
-    auto program2 = flatten.get();
+    // static data is kept out of instruction selection, its words could be
+    // mistaken for instructions
+    if (options.select_instructions) {
+        program = select_instructions(program);
+    }
+
+    Flatten flatten_data;
+    make_block({make_block(static_data), make_define(heap_start_label)})
+        ->accept(flatten_data);
+    return {program, flatten_data.get()};
+}
 
-    auto program3 = elim_labels(program2);
-    return program3;
+std::vector<std::shared_ptr<Code>>
+compile(std::vector<std::string> input_file_paths, CompileOptions options) {
+    auto [program, data] = compile_labelled(input_file_paths, options);
+    program.insert(program.end(), data.begin(), data.end());
+
+    std::map<std::shared_ptr<Label>, uint32_t> addresses;
+    program = elim_labels(program, addresses);
+    if (!options.label_map_path.empty()) {
+        write_label_map(options.label_map_path, addresses);
+    }
+    return program;
 }
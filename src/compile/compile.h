@@ -1,11 +1,50 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "code.h"
 
-std::vector<std::shared_ptr<Code>>
-compile(std::vector<std::string> input_file_paths);
+struct CompileOptions {
+    // maximum estimated size of a procedure body substituted for a call,
+    // 0 disables inlining
+    uint32_t inline_threshold = 40;
+    // use immediate, shift and byte instructions beyond the base instruction
+    // set, chars are packed one per byte. Off keeps binaries within the base
+    // set with a word per char
+    bool select_instructions = true;
+    // collect garbage with the gc module instead of reusing deleted blocks
+    bool gc = false;
+    // place objects that never outlive their function in its frame, off
+    // keeps every new on the heap
+    bool frame_objects = true;
+    // label counts from the emulator that guide inlining, procedure order
+    // and the layout of if else statements, unused when empty
+    std::string profile_path;
+    // where to write the address of every label for the emulator to count
+    // them by, unused when empty
+    std::string label_map_path;
+};
+
+// a program before its labels are given addresses, the static data ends
+// with the label the heap starts at
+struct LabelledProgram {
+    std::vector<std::shared_ptr<Code>> code;
+    std::vector<std::shared_ptr<Code>> data;
+};
+
+// everything compile does short of resolving labels, the x86-64 target
+// lowers from here. The label map option is left to compile
+LabelledProgram compile_labelled(
+    std::vector<std::string> input_file_paths,
+    CompileOptions options = {}
+);
+
+std::vector<std::shared_ptr<Code>> compile(
+    std::vector<std::string> input_file_paths,
+    CompileOptions options = {}
+);
@@ -1,24 +1,39 @@
 
+#include "compile_procedure.h"
+
 #include <map>
 #include <memory>
 #include <vector>
 
+#include "assembly.h"
+#include "assign_slots.h"
+#include "block.h"
 #include "chunk.h"
+#include "define_label.h"
+#include "definite_assignment.h"
 #include "elim_calls.h"
 #include "elim_if_stmts.h"
 #include "elim_ret_stmts.h"
 #include "elim_scopes.h"
-#include "elim_vars_proc.h"
+#include "elim_tail_calls.h"
+#include "elim_vars.h"
+#include "elim_vars_reg.h"
 #include "entry_exit.h"
+#include "reg.h"
+#include "var_access.h"
 
 struct Variable;
 struct Procedure;
 
-void compile_procedure(
-    std::shared_ptr<Procedure> proc,
-    std::map<std::shared_ptr<Procedure>, std::shared_ptr<Chunk>> param_chunks
-) {
-    ElimCalls elim_calls {proc, param_chunks};
+void compile_procedure(std::shared_ptr<Procedure> proc) {
+    ElimTailCalls elim_tail_calls {proc};
+    proc->code = proc->code->accept(elim_tail_calls);
+    auto restart_label = elim_tail_calls.get();
+
+    NeedsFrame needs_frame;
+    proc->code->accept(needs_frame);
+
+    ElimCalls elim_calls {proc};
     proc->code = proc->code->accept(elim_calls);
 
     ElimIfStmts elim_if_stmts;
@@ -30,19 +45,106 @@ void compile_procedure(
     ElimScopes elim_scopes;
     proc->code = proc->code->accept(elim_scopes);
     auto local_vars = elim_scopes.get();
+    auto unassigned = maybe_unassigned(proc->code, proc->parameters);
+    // objects in the frame start out uncleared, as heap blocks do
+    for (auto var : local_vars) {
+        if (var->words > 1) {
+            unassigned.erase(var);
+        }
+    }
+
+    // self tail calls jump back here, so locals that need zeroing are
+    // cleared on every restart rather than once with the frame
+    if (restart_label) {
+        std::vector<std::shared_ptr<Code>> restart = {
+            make_define(restart_label)};
+        for (auto var : local_vars) {
+            if (unassigned.contains(var)) {
+                restart.push_back(make_write(var, Reg::Zero));
+            }
+        }
+        restart.push_back(proc->code);
+        proc->code = make_block(restart);
+        unassigned.clear();
+    }
+
+    // locals that are never live at the same time share a register or slot
+    auto slots = assign_slots(proc->code, local_vars);
+    uint32_t local_slots = slot_count(slots);
+
+    // leaf procedures whose variables all fit in registers need no frame
+    if (!needs_frame.get() && proc->stack_parameters().empty()
+        && proc->parameters.size() + local_slots
+            <= arg_regs.size() + local_regs.size()) {
+        std::map<std::shared_ptr<Variable>, Reg> registers;
+        std::vector<Reg> free_regs(local_regs.begin(), local_regs.end());
+        for (size_t i = 0; i < arg_regs.size(); ++i) {
+            if (i < proc->parameters.size()) {
+                registers[proc->parameters.at(i)] = arg_regs.at(i);
+            } else {
+                free_regs.push_back(arg_regs.at(i));
+            }
+        }
+        std::vector<std::shared_ptr<Code>> zero_locals;
+        for (auto var : local_vars) {
+            Reg reg = free_regs.at(slots.at(var));
+            registers[var] = reg;
+            if (unassigned.contains(var)) {
+                zero_locals.push_back(make_add(reg, Reg::Zero, Reg::Zero));
+            }
+        }
+
+        zero_locals.push_back(proc->code);
+        proc->code = make_block(zero_locals);
+        proc->code = add_leaf_entry_exit(proc);
+
+        ElimVarsReg elim_vars_reg {registers};
+        proc->code = proc->code->accept(elim_vars_reg);
+        return;
+    }
 
     std::vector<std::shared_ptr<Variable>> all_local_vars = {
-        proc->param_ptr,
         proc->dynamic_link,
         proc->saved_pc};
+    auto register_params = proc->register_parameters();
+    all_local_vars.insert(
+        all_local_vars.end(),
+        register_params.begin(),
+        register_params.end()
+    );
+    // the fixed variables come first, locals follow in their shared slots
+    std::map<std::shared_ptr<Variable>, uint32_t> frame_slots;
+    uint32_t fixed_slots = all_local_vars.size();
+    for (uint32_t i = 0; i < fixed_slots; ++i) {
+        frame_slots[all_local_vars.at(i)] = i;
+    }
+    for (auto var : local_vars) {
+        frame_slots[var] = fixed_slots + slots.at(var);
+    }
     all_local_vars
         .insert(all_local_vars.end(), local_vars.begin(), local_vars.end());
-    std::shared_ptr<Chunk> local_vars_chunk =
-        std::make_shared<Chunk>(all_local_vars);
+    // stack parameters end the frame, where the caller stored them
+    auto stack_params = proc->stack_parameters();
+    for (uint32_t i = 0; i < stack_params.size(); ++i) {
+        frame_slots[stack_params.at(i)] = fixed_slots + local_slots + i;
+    }
+    all_local_vars
+        .insert(all_local_vars.end(), stack_params.begin(), stack_params.end());
+    std::vector<std::shared_ptr<Variable>> zeroed;
+    for (auto var : local_vars) {
+        if (unassigned.contains(var)) {
+            zeroed.push_back(var);
+        }
+    }
+    std::shared_ptr<Chunk> frame = std::make_shared<Chunk>(
+        all_local_vars,
+        zeroed,
+        frame_slots,
+        fixed_slots + local_slots + stack_params.size()
+    );
 
-    proc->code = add_entry_exit(proc, local_vars_chunk);
+    proc->code = add_entry_exit(proc, frame, elim_tail_calls.tail_calls());
 
-    auto param_chunk = std::make_shared<Chunk>(proc->parameters);
-    ElimVarsProc elim_vars_proc(local_vars_chunk, param_chunk, proc->param_ptr);
-    proc->code = proc->code->accept(elim_vars_proc);
+    ElimVars elim_vars {frame};
+    proc->code = proc->code->accept(elim_vars);
 }
@@ -6,6 +6,7 @@
 
 #include "ast_node.h"
 #include "compile_error.h"
+#include "extract_imports.h"
 #include "extract_symbols.h"
 #include "nex_lang_parsing.h"
 #include "nex_lang_scanning.h"
@@ -27,11 +28,26 @@ static const std::string string_module(
 #include "string_module.nl"
 );
 
+static const std::string map_module(
+#include "map_module.nl"
+);
+
+static const std::string gc_module(
+#include "gc_module.nl"
+);
+
+static const std::string arena_module(
+#include "arena_module.nl"
+);
+
 static std::map<std::string, std::string> nl_lib {
     {"print", print_module},
     {"math", math_module},
     {"list", list_module},
-    {"string", string_module}};
+    {"string", string_module},
+    {"map", map_module},
+    {"gc", gc_module},
+    {"arena", arena_module}};
 
 void nl_lib_import(
     std::string import_name,
@@ -46,6 +62,10 @@ void nl_lib_import(
         try {
             auto tokens = scan(input);
             auto ast_node = parse(tokens);
+            // recorded before its imports, so modules importing each other
+            // stop here instead of recursing
+            program_context.module_table[import_name] = SymbolTable();
+            nl_lib_import_all(ast_node, import_list, program_context, modules);
             auto result_list = extract_symbols(ast_node, program_context);
             import_list.insert(
                 import_list.end(),
@@ -59,3 +79,15 @@ void nl_lib_import(
         }
     }
 }
+
+void nl_lib_import_all(
+    ASTNode root,
+    std::vector<std::string>& import_list,
+    ProgramContext& program_context,
+    std::vector<std::pair<std::string, ASTNode>>& modules
+) {
+    ASTNode imports = root.children.at(2);
+    for (std::string import_name : extract_imports(imports, program_context)) {
+        nl_lib_import(import_name, import_list, program_context, modules);
+    }
+}
@@ -18,3 +18,12 @@ void nl_lib_import(
     ProgramContext& program_context,
     std::vector<std::pair<std::string, ASTNode>>& modules
 );
+
+// imports the library modules root imports, their types must be known before
+// the symbols of root are extracted
+void nl_lib_import_all(
+    ASTNode root,
+    std::vector<std::string>& import_list,
+    ProgramContext& program_context,
+    std::vector<std::pair<std::string, ASTNode>>& modules
+);
@@ -0,0 +1,85 @@
+R"(
+mod arena;
+
+// objects placed with new T in arena follow each other in chunks taken from
+// the heap and are freed all at once by reset or destruct
+struct Arena {
+    // the next object goes here unless it would pass end
+    bump: i32;
+    end: i32;
+    // the chunk being filled, its first word links to the one before it
+    chunk: *i32;
+    // bytes for objects in all chunks
+    capacity: i32;
+}
+
+fn add_chunk(self: *Arena, bytes: i32) {
+    let words = (bytes + 7) / 4;
+    let chunk = new i32[words];
+    chunk[0] = self.chunk as i32;
+    self.chunk = chunk;
+    self.bump = chunk as i32 + 4;
+    self.end = chunk as i32 + words * 4;
+    self.capacity = self.capacity + words * 4 - 4;
+}
+
+fn Arena(bytes: i32) -> *Arena {
+    let arena = new Arena;
+    arena.chunk = 0 as *i32;
+    arena.capacity = 0;
+    arena.add_chunk(bytes);
+    return arena;
+}
+
+// adds a chunk at least as big as all before it
+fn grow(self: *Arena, bytes: i32) -> i32 {
+    let size = self.capacity;
+    if (size < bytes) {
+        size = bytes;
+    }
+    self.add_chunk(size);
+    let result = self.bump;
+    self.bump = result + bytes;
+    return result;
+}
+
+// the address of the next bytes in the arena, new T in arena calls this.
+// The word before them holds their size, as on the heap
+fn alloc(self: *Arena, bytes: i32) -> i32 {
+    let result = self.bump;
+    self.bump = result + bytes + 4;
+    if (self.bump > self.end) {
+        result = self.grow(bytes + 4);
+    }
+    let size = result as *i32;
+    size[0] = bytes;
+    return result + 4;
+}
+
+fn free_chunks(self: *Arena) {
+    while (self.chunk as i32 != 0) {
+        let chunk = self.chunk;
+        self.chunk = chunk[0] as *i32;
+        delete chunk;
+    }
+}
+
+// frees every object in the arena, when it had to grow its chunks are
+// replaced by one that holds as much
+fn reset(self: *Arena) {
+    if (self.chunk[0] != 0) {
+        let capacity = self.capacity;
+        self.free_chunks();
+        self.capacity = 0;
+        self.add_chunk(capacity);
+    }
+    else {
+        self.bump = self.chunk as i32 + 4;
+    }
+}
+
+fn destruct(self: *Arena) {
+    self.free_chunks();
+    delete self;
+}
+)"
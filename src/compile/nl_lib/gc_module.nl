@@ -0,0 +1,365 @@
+R"(
+mod gc;
+
+import print;
+
+// the copying collector behind cnl --gc. heap_allocate bumps HeapPtr up to
+// FromSpaceEnd and calls refill for a new region when an object does not
+// fit
+//
+// the heap starts with this control block, a table with an entry per page
+// follows and the pages come last. A region is a run of pages whose objects
+// follow each other from its start until a zero size word or its end. Each
+// object starts with its layout and its size in bytes, so the size is just
+// before the data as with the default heap. The layout is 0 without
+// pointers, 1 when every word is a pointer, otherwise the address of a table
+// of the bytes per element, the number of pointers in an element and their
+// offsets. A copied object gets 1 added to its size and its new address in
+// place of its layout
+//
+// words on the stack may or may not be pointers, each that points into a
+// page keeps that page's region where it is. Pointers in objects are known
+// by their layout, what they point to is copied to new regions
+struct GcControl {
+    // HeapPtr and FromSpaceEnd while the collector runs
+    bump: i32;
+    limit: i32;
+    // where the stack started
+    stack_top: i32;
+    pages: i32;
+    page_count: i32;
+    // more than half the pages are in use only after a collection
+    used: i32;
+    // pages in use belong to this space, collections move to the next one
+    space: i32;
+    // where the search for free pages goes on
+    cursor: i32;
+    // copied objects are in a list of regions, each linked to the next one
+    // through its first page, the last one is being filled
+    copy_first: i32;
+    copy_last: i32;
+    copy_bump: i32;
+    copy_limit: i32;
+    // regions kept in place
+    pinned: i32;
+}
+
+struct GcPage {
+    // 0 for free pages
+    space: i32;
+    // first page of the region
+    first: i32;
+    // first page of the next region in a list plus one, 0 ends the list
+    next: i32;
+    // end of the region, on its first page
+    end: i32;
+}
+
+fn page_bytes() -> i32 {
+    return 4096;
+}
+
+fn page(control: *GcControl, p: i32) -> *GcPage {
+    return (control + 1) as *GcPage + p;
+}
+
+fn page_address(control: *GcControl, p: i32) -> i32 {
+    return control.pages + p * page_bytes();
+}
+
+// -1 outside the pages
+fn page_of(control: *GcControl, address: i32) -> i32 {
+    let p = -1;
+    if (address >= control.pages) {
+        p = (address - control.pages) / page_bytes();
+        if (p >= control.page_count) {
+            p = -1;
+        }
+    }
+    return p;
+}
+
+fn out_of_memory(control: *GcControl) {
+    println("out of memory");
+    // stops the program on a division by zero
+    control.used = control.used / (control.used - control.used);
+}
+
+fn init(control: *GcControl) {
+    // the stack keeps the top megabyte of memory
+    let end = control.stack_top - 1048576;
+    let entries = (end - (page(control, 0) as i32)) / (page_bytes() + 16);
+    let table_end = page(control, entries) as i32;
+    control.pages = ((table_end + page_bytes() - 1) / page_bytes())
+        * page_bytes();
+    control.page_count = (end - control.pages) / page_bytes();
+    if (control.page_count > entries) {
+        control.page_count = entries;
+    }
+    control.space = 1;
+}
+
+// the first page of a new region of count free pages in space
+fn new_region(control: *GcControl, count: i32, space: i32) -> i32 {
+    let run = 0;
+    let searched = 0;
+    let p = control.cursor;
+    while (run < count) {
+        if (searched == control.page_count + count) {
+            out_of_memory(control);
+        }
+        if (p == control.page_count) {
+            p = 0;
+            run = 0;
+        }
+        let entry = page(control, p);
+        if (entry.space == 0) {
+            run = run + 1;
+        }
+        else {
+            run = 0;
+        }
+        p = p + 1;
+        searched = searched + 1;
+    }
+
+    control.cursor = p;
+    control.used = control.used + count;
+    let first = p - count;
+    let region = page(control, first);
+    region.next = 0;
+    region.end = page_address(control, p);
+    while (p > first) {
+        p = p - 1;
+        let taken = page(control, p);
+        taken.space = space;
+        taken.first = first;
+    }
+    return first;
+}
+
+// a zero size word ends a region before its end
+fn finish(bump: i32, limit: i32) {
+    if (bump + 8 < limit) {
+        let header = bump as *i32;
+        header[1] = 0;
+    }
+}
+
+// the size of the object at object, 0 past the last one in a region ending
+// at end
+fn object_size(object: i32, end: i32) -> i32 {
+    if (object + 8 >= end) {
+        return 0;
+    }
+    let header = object as *i32;
+    return header[1];
+}
+
+// the object of the region starting at page first that value points into,
+// 0 if none
+fn find(control: *GcControl, first: i32, value: i32) -> i32 {
+    let result = 0;
+    let object = page_address(control, first);
+    let region = page(control, first);
+    while (object < region.end) {
+        let size = object_size(object, region.end);
+        let next = object + 8 + size - size % 2;
+        if (size == 0) {
+            object = region.end;
+        }
+        else {
+            if (value < next) {
+                result = object;
+                object = region.end;
+            }
+            else {
+                object = next;
+            }
+        }
+    }
+    return result;
+}
+
+fn copy(control: *GcControl, object: i32) {
+    let header = object as *i32;
+    let bytes = header[1] + 8;
+    if (control.copy_bump + bytes > control.copy_limit) {
+        finish(control.copy_bump, control.copy_limit);
+        let count = (bytes + page_bytes() - 1) / page_bytes();
+        let first = new_region(control, count, control.space);
+        if (control.copy_last == 0) {
+            control.copy_first = first + 1;
+        }
+        else {
+            let last = page(control, control.copy_last - 1);
+            last.next = first + 1;
+        }
+        control.copy_last = first + 1;
+        control.copy_bump = page_address(control, first);
+        let region = page(control, first);
+        control.copy_limit = region.end;
+    }
+
+    let to = control.copy_bump as *i32;
+    let i = 0;
+    while (i < bytes / 4) {
+        to[i] = header[i];
+        i = i + 1;
+    }
+    control.copy_bump = control.copy_bump + bytes;
+    header[0] = to as i32;
+    header[1] = header[1] + 1;
+}
+
+// where value points once objects in space from have been copied
+fn forward(control: *GcControl, value: i32, from: i32) -> i32 {
+    let result = value;
+    let p = page_of(control, value);
+    if (p >= 0) {
+        let entry = page(control, p);
+        if (entry.space == from) {
+            let object = find(control, entry.first, value);
+            if (object != 0) {
+                let header = object as *i32;
+                if (header[1] % 2 == 0) {
+                    copy(control, object);
+                }
+                result = header[0] + (value - object);
+            }
+        }
+    }
+    return result;
+}
+
+fn forward_word(control: *GcControl, address: i32, from: i32) {
+    let word = address as *i32;
+    *word = forward(control, *word, from);
+}
+
+// forwards the pointers of the object and returns the next one
+fn scan_object(control: *GcControl, object: i32, from: i32) -> i32 {
+    let header = object as *i32;
+    let layout = header[0];
+    let size = header[1];
+    let data = object + 8;
+    if (layout == 1) {
+        let i = 0;
+        while (i < size) {
+            forward_word(control, data + i, from);
+            i = i + 4;
+        }
+    }
+    else {
+        if (layout != 0) {
+            let table = layout as *i32;
+            let element = 0;
+            while (element + table[0] <= size) {
+                let j = 0;
+                while (j < table[1]) {
+                    forward_word(control, data + element + table[2 + j], from);
+                    j = j + 1;
+                }
+                element = element + table[0];
+            }
+        }
+    }
+    return data + size;
+}
+
+fn pin(control: *GcControl, value: i32, from: i32) {
+    let p = page_of(control, value);
+    if (p >= 0) {
+        let entry = page(control, p);
+        if (entry.space == from) {
+            let first = entry.first;
+            let region = page(control, first);
+            let end = page_of(control, region.end - 1) + 1;
+            let q = first;
+            while (q < end) {
+                let kept = page(control, q);
+                kept.space = control.space;
+                q = q + 1;
+            }
+            control.used = control.used + end - first;
+            region.next = control.pinned;
+            control.pinned = first + 1;
+        }
+    }
+}
+
+fn collect(control: *GcControl, stack: i32) {
+    let from = control.space;
+    control.space = from + 1;
+    control.used = 0;
+    control.cursor = 0;
+    control.pinned = 0;
+    control.copy_first = 0;
+    control.copy_last = 0;
+    control.copy_bump = 0;
+    control.copy_limit = 0;
+
+    let word = stack;
+    while (word < control.stack_top) {
+        pin(control, *(word as *i32), from);
+        word = word + 4;
+    }
+
+    // objects kept in place first, then copied ones in the order they were
+    // copied until no more are
+    let pinned = control.pinned;
+    while (pinned != 0) {
+        let region = page(control, pinned - 1);
+        let object = page_address(control, pinned - 1);
+        while (object_size(object, region.end) != 0) {
+            object = scan_object(control, object, from);
+        }
+        pinned = region.next;
+    }
+    let copied = control.copy_first;
+    while (copied != 0) {
+        let region = page(control, copied - 1);
+        let object = page_address(control, copied - 1);
+        while (object != control.copy_bump
+               && object_size(object, region.end) != 0) {
+            object = scan_object(control, object, from);
+        }
+        if (object == control.copy_bump) {
+            copied = 0;
+        }
+        else {
+            copied = region.next;
+        }
+    }
+    finish(control.copy_bump, control.copy_limit);
+
+    let p = 0;
+    while (p < control.page_count) {
+        let entry = page(control, p);
+        if (entry.space == from) {
+            entry.space = 0;
+        }
+        p = p + 1;
+    }
+}
+
+// called by heap_allocate with the control block, the size of the object
+// that did not fit and its stack pointer, gives it a new region where the
+// object fits
+fn refill(address: i32, bytes: i32, stack: i32) {
+    let control = address as *GcControl;
+    if (control.page_count == 0) {
+        init(control);
+    }
+    finish(control.bump, control.limit);
+    let count = (bytes + 8 + page_bytes() - 1) / page_bytes();
+    if ((control.used + count) * 2 > control.page_count) {
+        collect(control, stack);
+    }
+
+    let first = new_region(control, count, control.space);
+    let region = page(control, first);
+    control.bump = page_address(control, first);
+    control.limit = region.end;
+}
+)"
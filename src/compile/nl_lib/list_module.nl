@@ -25,16 +25,12 @@ fn destruct(self: *ListI32) {
 
 fn realloc(self: *ListI32, new_capacity: i32, default: i32) {
     let new_data = new i32[new_capacity];
-    let i = 0;
-    while (i < new_capacity) {
-        if (i < self.size) {
-            new_data[i] = self.data[i];
-        }
-        else {
-            new_data[i] = default;
-        }
-        i = i + 1;
+    let kept = self.size;
+    if (kept > new_capacity) {
+        kept = new_capacity;
     }
+    copy(new_data, self.data, kept);
+    fill(new_data + kept, default, new_capacity - kept);
     delete self.data;
     self.data = new_data;
     self.capacity = new_capacity;
@@ -0,0 +1,348 @@
+R"(
+mod map;
+
+import string;
+
+// maps from i32 and from *String keys to i32 values, kept in open addressing
+// tables probed linearly. The capacity is a power of two and at most three
+// quarters of it is used, so every probe sequence ends at an empty slot.
+// Removing an entry moves the ones after it back instead of leaving a
+// tombstone behind
+struct MapI32 {
+    keys: *i32;
+    values: *i32;
+    // whether each slot holds an entry
+    used: *bool;
+    size: i32;
+    capacity: i32;
+    // 2 to the 32 over capacity, dividing a hash by it keeps its top bits
+    divisor: i32;
+}
+
+// keys are not copied and must not change while they are in the map
+struct MapString {
+    keys: *(*String);
+    values: *i32;
+    used: *bool;
+    // the hash of each key, so growing and removing never rehash strings
+    hashes: *i32;
+    size: i32;
+    capacity: i32;
+    divisor: i32;
+}
+
+// Fibonacci hashing, the top bits of the product depend on every bit of key
+fn hash(key: i32) -> i32 {
+    return key * -1640531535;
+}
+
+fn hash(key: *String) -> i32 {
+    let result = 0;
+    let i = 0;
+    while (i < key.size) {
+        result = result * 31 + key.data[i] as i32;
+        i = i + 1;
+    }
+    return hash(result);
+}
+
+fn equals(a: *String, b: *String) -> bool {
+    if (a.size != b.size) {
+        return false;
+    }
+    let i = 0;
+    while (i < a.size) {
+        if (a.data[i] != b.data[i]) {
+            return false;
+        }
+        i = i + 1;
+    }
+    return true;
+}
+
+// the slot a hash starts probing from, its top bits rounded down
+fn home(key_hash: i32, capacity: i32, divisor: i32) -> i32 {
+    if (key_hash < 0) {
+        return capacity / 2 - 1 - (-1 - key_hash) / divisor;
+    }
+    return capacity / 2 + key_hash / divisor;
+}
+
+// whether the entry in slot j, which starts probing from slot k, can move
+// back to the empty slot i without leaving its probe sequence
+fn can_move(i: i32, j: i32, k: i32) -> bool {
+    if (i <= j) {
+        return k <= i || k > j;
+    }
+    return k <= i && k > j;
+}
+
+fn init_slots(self: *MapI32, capacity: i32) {
+    self.keys = new i32[capacity];
+    self.values = new i32[capacity];
+    self.used = new bool[capacity];
+    fill(self.used, false, capacity);
+    self.capacity = capacity;
+    self.divisor = 1073741824 / capacity * 4;
+}
+
+fn MapI32() -> *MapI32 {
+    let map = new MapI32;
+    map.size = 0;
+    map.init_slots(8);
+    return map;
+}
+
+fn destruct(self: *MapI32) {
+    delete self.keys;
+    delete self.values;
+    delete self.used;
+    delete self;
+}
+
+fn next_slot(self: *MapI32, i: i32) -> i32 {
+    i = i + 1;
+    if (i == self.capacity) {
+        i = 0;
+    }
+    return i;
+}
+
+// the slot holding key, or the empty slot where it would go
+fn find(self: *MapI32, key: i32) -> i32 {
+    let i = home(hash(key), self.capacity, self.divisor);
+    while (self.used[i] && self.keys[i] != key) {
+        i = self.next_slot(i);
+    }
+    return i;
+}
+
+fn grow(self: *MapI32) {
+    let keys = self.keys;
+    let values = self.values;
+    let used = self.used;
+    let capacity = self.capacity;
+    self.init_slots(capacity * 2);
+    let i = 0;
+    while (i < capacity) {
+        if (used[i]) {
+            let slot = self.find(keys[i]);
+            self.keys[slot] = keys[i];
+            self.values[slot] = values[i];
+            self.used[slot] = true;
+        }
+        i = i + 1;
+    }
+    delete keys;
+    delete values;
+    delete used;
+}
+
+// sets the value of key, adding key when it is missing
+fn insert(self: *MapI32, key: i32, value: i32) {
+    let i = self.find(key);
+    if (!self.used[i]) {
+        if ((self.size + 1) * 4 > self.capacity * 3) {
+            self.grow();
+            i = self.find(key);
+        }
+        self.keys[i] = key;
+        self.used[i] = true;
+        self.size = self.size + 1;
+    }
+    self.values[i] = value;
+}
+
+fn contains(self: *MapI32, key: i32) -> bool {
+    return self.used[self.find(key)];
+}
+
+fn get(self: *MapI32, key: i32, default: i32) -> i32 {
+    let i = self.find(key);
+    if (self.used[i]) {
+        return self.values[i];
+    }
+    return default;
+}
+
+// the value of key, which moves when the map grows, or null when missing
+fn at(self: *MapI32, key: i32) -> *i32 {
+    let i = self.find(key);
+    if (self.used[i]) {
+        return self.values + i;
+    }
+    return 0 as *i32;
+}
+
+// removes key, returning whether it was in the map
+fn remove(self: *MapI32, key: i32) -> bool {
+    let i = self.find(key);
+    if (!self.used[i]) {
+        return false;
+    }
+    let j = self.next_slot(i);
+    while (self.used[j]) {
+        let k = home(hash(self.keys[j]), self.capacity, self.divisor);
+        if (can_move(i, j, k)) {
+            self.keys[i] = self.keys[j];
+            self.values[i] = self.values[j];
+            i = j;
+        }
+        j = self.next_slot(j);
+    }
+    self.used[i] = false;
+    self.size = self.size - 1;
+    return true;
+}
+
+fn size(self: *MapI32) -> i32 {
+    return self.size;
+}
+
+fn empty(self: *MapI32) -> bool {
+    return self.size == 0;
+}
+
+fn init_slots(self: *MapString, capacity: i32) {
+    self.keys = new (*String)[capacity];
+    self.values = new i32[capacity];
+    self.used = new bool[capacity];
+    self.hashes = new i32[capacity];
+    fill(self.used, false, capacity);
+    self.capacity = capacity;
+    self.divisor = 1073741824 / capacity * 4;
+}
+
+fn MapString() -> *MapString {
+    let map = new MapString;
+    map.size = 0;
+    map.init_slots(8);
+    return map;
+}
+
+fn destruct(self: *MapString) {
+    delete self.keys;
+    delete self.values;
+    delete self.used;
+    delete self.hashes;
+    delete self;
+}
+
+fn next_slot(self: *MapString, i: i32) -> i32 {
+    i = i + 1;
+    if (i == self.capacity) {
+        i = 0;
+    }
+    return i;
+}
+
+// strings are only compared when their hashes match
+fn find(self: *MapString, key: *String, key_hash: i32) -> i32 {
+    let i = home(key_hash, self.capacity, self.divisor);
+    while (self.used[i]
+           && (self.hashes[i] != key_hash || !equals(self.keys[i], key))) {
+        i = self.next_slot(i);
+    }
+    return i;
+}
+
+fn find(self: *MapString, key: *String) -> i32 {
+    return self.find(key, hash(key));
+}
+
+fn grow(self: *MapString) {
+    let keys = self.keys;
+    let values = self.values;
+    let used = self.used;
+    let hashes = self.hashes;
+    let capacity = self.capacity;
+    self.init_slots(capacity * 2);
+    let i = 0;
+    while (i < capacity) {
+        if (used[i]) {
+            // keys are distinct, so the first empty slot is theirs
+            let slot = home(hashes[i], self.capacity, self.divisor);
+            while (self.used[slot]) {
+                slot = self.next_slot(slot);
+            }
+            self.keys[slot] = keys[i];
+            self.values[slot] = values[i];
+            self.hashes[slot] = hashes[i];
+            self.used[slot] = true;
+        }
+        i = i + 1;
+    }
+    delete keys;
+    delete values;
+    delete used;
+    delete hashes;
+}
+
+// sets the value of key, adding key when it is missing
+fn insert(self: *MapString, key: *String, value: i32) {
+    let key_hash = hash(key);
+    let i = self.find(key, key_hash);
+    if (!self.used[i]) {
+        if ((self.size + 1) * 4 > self.capacity * 3) {
+            self.grow();
+            i = self.find(key, key_hash);
+        }
+        self.keys[i] = key;
+        self.hashes[i] = key_hash;
+        self.used[i] = true;
+        self.size = self.size + 1;
+    }
+    self.values[i] = value;
+}
+
+fn contains(self: *MapString, key: *String) -> bool {
+    return self.used[self.find(key)];
+}
+
+fn get(self: *MapString, key: *String, default: i32) -> i32 {
+    let i = self.find(key);
+    if (self.used[i]) {
+        return self.values[i];
+    }
+    return default;
+}
+
+// the value of key, which moves when the map grows, or null when missing
+fn at(self: *MapString, key: *String) -> *i32 {
+    let i = self.find(key);
+    if (self.used[i]) {
+        return self.values + i;
+    }
+    return 0 as *i32;
+}
+
+// removes key, returning whether it was in the map
+fn remove(self: *MapString, key: *String) -> bool {
+    let i = self.find(key);
+    if (!self.used[i]) {
+        return false;
+    }
+    let j = self.next_slot(i);
+    while (self.used[j]) {
+        let k = home(self.hashes[j], self.capacity, self.divisor);
+        if (can_move(i, j, k)) {
+            self.keys[i] = self.keys[j];
+            self.values[i] = self.values[j];
+            self.hashes[i] = self.hashes[j];
+            i = j;
+        }
+        j = self.next_slot(j);
+    }
+    self.used[i] = false;
+    self.size = self.size - 1;
+    return true;
+}
+
+fn size(self: *MapString) -> i32 {
+    return self.size;
+}
+
+fn empty(self: *MapString) -> bool {
+    return self.size == 0;
+}
+)"
@@ -4,7 +4,7 @@ mod print;
 fn print(word: *char) {
     while ((*word) != (0 as char)) {
         print(*word);
-        word = ((word as i32) + 4) as (*char);
+        word = word + 1;
     }
 }
 
@@ -18,8 +18,8 @@ fn println(word: *char) {
 }
 
 fn print(letter: char) {
-    let print_addr: *char = (-65524) as *char;
-    (*print_addr) = letter;
+    let print_addr: *i32 = (-65524) as *i32;
+    (*print_addr) = letter as i32;
 }
 
 fn println(letter: char) {
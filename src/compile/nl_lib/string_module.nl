@@ -19,12 +19,21 @@ fn String() -> *String {
 }
 
 fn String(word: *char) -> *String {
+    let size = 0;
+    while (word[size] != 0 as char) {
+        size = size + 1;
+    }
+    // the capacity pushing each char back would have reached
     let str = String();
-    let i = 0;
-    while (word[i] != 0 as char) {
-        str.push_back(word[i]);
-        i = i + 1;
+    let capacity = str.capacity;
+    while (capacity < size) {
+        capacity = capacity * 2;
     }
+    if (capacity != str.capacity) {
+        str.realloc(capacity, ' ');
+    }
+    copy(str.data, word, size);
+    str.size = size;
     return str;
 }
 
@@ -35,16 +44,12 @@ fn destruct(self: *String) {
 
 fn realloc(self: *String, new_capacity: i32, default: char) {
     let new_data = new char[new_capacity];
-    let i = 0;
-    while (i < new_capacity) {
-        if (i < self.size) {
-            new_data[i] = self.data[i];
-        }
-        else {
-            new_data[i] = default;
-        }
-        i = i + 1;
+    let kept = self.size;
+    if (kept > new_capacity) {
+        kept = new_capacity;
     }
+    copy(new_data, self.data, kept);
+    fill(new_data + kept, default, new_capacity - kept);
     delete self.data;
     self.data = new_data;
     self.capacity = new_capacity;
@@ -87,7 +92,7 @@ fn back(self: *String) -> char {
 }
 
 fn at(self: *String, index: i32) -> *char {
-    return (self.data as i32 + 4 * index) as *char;
+    return self.data + index;
 }
 
 fn get(self: *String, index: i32) -> char {
@@ -121,11 +126,7 @@ fn println(self: *String) {
 
 fn c_str(self: *String) -> *char {
     let result = new char[self.size + 1];
-    let i = 0;
-    while (i < self.size) {
-        result[i] = self.data[i];
-        i = i + 1;
-    }
+    copy(result, self.data, self.size);
     result[self.size] = 0 as char;
     return result;
 }
@@ -0,0 +1,98 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+// sums the counts of the instructions at each label of a --label-map file
+// into lines of "<count> <label name>" for --profile-use
+static void write_profile(
+    std::string label_map_path,
+    std::string profile_path,
+    const std::vector<uint64_t>& counts
+) {
+    std::ifstream label_map {label_map_path};
+    if (!label_map) {
+        std::cerr << "Invalid label map path: " << label_map_path
+                  << std::endl;
+        exit(1);
+    }
+
+    std::map<std::string, uint64_t> profile;
+    std::string line;
+    while (std::getline(label_map, line)) {
+        std::istringstream fields {line};
+        uint32_t address;
+        std::string name;
+        if (!(fields >> address) || !std::getline(fields >> std::ws, name)) {
+            continue;
+        }
+        uint64_t count = address / 4 < counts.size() ? counts[address / 4] : 0;
+        profile[name] += count;
+    }
+
+    std::ofstream file {profile_path};
+    for (auto& [name, count] : profile) {
+        file << count << " " << name << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args;
+    std::string label_map_path;
+    std::string profile_path;
+    bool print_steps = false;
+    bool interpret = false;
+    const std::string label_map_flag = "--label-map=";
+    const std::string profile_flag = "--profile=";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.starts_with(label_map_flag)) {
+            label_map_path = arg.substr(label_map_flag.length());
+        } else if (arg.starts_with(profile_flag)) {
+            profile_path = arg.substr(profile_flag.length());
+        } else if (arg == "--steps") {
+            print_steps = true;
+        } else if (arg == "--interpret") {
+            interpret = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() != 3 || label_map_path.empty() != profile_path.empty()) {
+        std::cerr << "Usage: emulate <binary> <input1> <input2> "
+                     "[--label-map=<path> --profile=<path>] [--steps] "
+                     "[--interpret]"
+                  << std::endl;
+        exit(1);
+    }
+
+    try {
+        auto program = read_program(args[0]);
+        int32_t input1 = std::stoi(args[1]);
+        int32_t input2 = std::stoi(args[2]);
+        // only the interpreter counts instructions for profiles
+        auto result = interpret || !profile_path.empty()
+            ? run(program, input1, input2, !profile_path.empty())
+            : run_jit(program, input1, input2, print_steps);
+        std::cout << result.output << result.result << std::endl;
+        if (print_steps) {
+            std::cerr << "steps " << result.steps << std::endl;
+        }
+        if (!profile_path.empty()) {
+            write_profile(label_map_path, profile_path, result.counts);
+        }
+    } catch (EmulatorError& error) {
+        std::cerr << error.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
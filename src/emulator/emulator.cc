@@ -0,0 +1,507 @@
+
+#include "emulator.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "machine.h"
+
+static uint8_t dest(uint8_t reg) {
+    return reg == 0 ? DISCARD : reg;
+}
+
+Decoded decode(uint32_t word) {
+    uint8_t s = (word >> 21) & 31;
+    uint8_t t = (word >> 16) & 31;
+    uint8_t d = (word >> 11) & 31;
+    uint32_t shift = (word >> 6) & 31;
+    uint32_t signed_imm = (uint32_t)(int32_t)(int16_t)(word & 0xffff);
+    uint32_t unsigned_imm = word & 0xffff;
+
+    if (word >> 26 == 0) {
+        switch (word & 63) {
+            case 0x20:
+                return {Op::Add, s, t, dest(d), 0};
+            case 0x22:
+                return {Op::Sub, s, t, dest(d), 0};
+            case 0x18:
+                return {Op::Mult, s, t, 0, 0};
+            case 0x19:
+                return {Op::Multu, s, t, 0, 0};
+            case 0x1a:
+                return {Op::Div, s, t, 0, 0};
+            case 0x1b:
+                return {Op::Divu, s, t, 0, 0};
+            case 0x10:
+                return {Op::Mfhi, 0, 0, dest(d), 0};
+            case 0x12:
+                return {Op::Mflo, 0, 0, dest(d), 0};
+            case 0x14:
+                return {Op::Lis, 0, 0, dest(d), 0};
+            case 0x2a:
+                return {Op::Slt, s, t, dest(d), 0};
+            case 0x2b:
+                return {Op::Sltu, s, t, dest(d), 0};
+            case 0x08:
+                return {Op::Jr, s, 0, 0, 0};
+            case 0x09:
+                return {Op::Jalr, s, 0, 0, 0};
+            case 0x24:
+                return {Op::And, s, t, dest(d), 0};
+            case 0x25:
+                return {Op::Or, s, t, dest(d), 0};
+            case 0x26:
+                return {Op::Xor, s, t, dest(d), 0};
+            case 0x27:
+                return {Op::Nor, s, t, dest(d), 0};
+            case 0x00:
+                return {Op::Sll, 0, t, dest(d), shift};
+            case 0x02:
+                return {Op::Srl, 0, t, dest(d), shift};
+            case 0x03:
+                return {Op::Sra, 0, t, dest(d), shift};
+            case 0x04:
+                return {Op::Sllv, s, t, dest(d), 0};
+            case 0x06:
+                return {Op::Srlv, s, t, dest(d), 0};
+            case 0x07:
+                return {Op::Srav, s, t, dest(d), 0};
+        }
+        return {Op::Invalid, 0, 0, 0, 0};
+    }
+
+    switch (word >> 26) {
+        case 0x04:
+            return {Op::Beq, s, t, 0, signed_imm};
+        case 0x05:
+            return {Op::Bne, s, t, 0, signed_imm};
+        case 0x23:
+            return {Op::Lw, s, dest(t), 0, signed_imm};
+        case 0x2b:
+            return {Op::Sw, s, t, 0, signed_imm};
+        case 0x20:
+            return {Op::Lb, s, dest(t), 0, signed_imm};
+        case 0x24:
+            return {Op::Lbu, s, dest(t), 0, signed_imm};
+        case 0x28:
+            return {Op::Sb, s, t, 0, signed_imm};
+        case 0x08:
+        case 0x09:
+            return {Op::Addi, s, dest(t), 0, signed_imm};
+        case 0x0a:
+            return {Op::Slti, s, dest(t), 0, signed_imm};
+        case 0x0c:
+            return {Op::Andi, s, dest(t), 0, unsigned_imm};
+        case 0x0d:
+            return {Op::Ori, s, dest(t), 0, unsigned_imm};
+        case 0x0e:
+            return {Op::Xori, s, dest(t), 0, unsigned_imm};
+        case 0x0f:
+            return {Op::Lui, 0, dest(t), 0, unsigned_imm << 16};
+    }
+    return {Op::Invalid, 0, 0, 0, 0};
+}
+
+static std::string hex(uint32_t value) {
+    std::ostringstream result;
+    result << "0x" << std::hex << value;
+    return result.str();
+}
+
+static EmulatorError error_at(std::string message, uint32_t address) {
+    return EmulatorError(message + " at pc " + hex(address));
+}
+
+EmulatorError::EmulatorError(const std::string& message) :
+    std::runtime_error(message) {}
+
+std::vector<uint32_t> read_program(std::string path) {
+    std::ifstream file {path, std::ios::binary};
+    if (!file) {
+        throw EmulatorError("Invalid binary path: " + path);
+    }
+    std::vector<unsigned char> bytes {
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()};
+    if (bytes.size() % 4 != 0) {
+        throw EmulatorError("Binary is not a whole number of words: " + path);
+    }
+
+    std::vector<uint32_t> program;
+    for (size_t i = 0; i < bytes.size(); i += 4) {
+        program.push_back(
+            (bytes[i] << 24) | (bytes[i + 1] << 16) | (bytes[i + 2] << 8)
+            | bytes[i + 3]
+        );
+    }
+    return program;
+}
+
+#if defined(__GNUC__)
+// computed goto, every handler jumps straight to the next one
+#define HANDLER(name) name:
+#define DISPATCH() goto* handlers[static_cast<size_t>(instruction->op)]
+#define DISPATCH_BEGIN DISPATCH();
+#define DISPATCH_END
+#else
+#define HANDLER(name) case Op::name:
+#define DISPATCH() continue
+#define DISPATCH_BEGIN \
+    for (;;) { \
+        switch (instruction->op) {
+#define DISPATCH_END \
+    } \
+    }
+#endif
+
+// fetches the instruction at pc and runs its handler
+#define NEXT() \
+    { \
+        if constexpr (counting) { \
+            ++counts[pc]; \
+        } \
+        instruction = &code[pc]; \
+        ++pc; \
+        ++steps; \
+        DISPATCH(); \
+    }
+
+Machine load(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2
+) {
+    if (program.size() > MEMORY_SIZE / 4) {
+        throw EmulatorError("Program does not fit in memory");
+    }
+    Machine machine;
+    machine.memory.reset((uint32_t*)calloc(MEMORY_SIZE / 4, 4));
+    if (!machine.memory) {
+        throw EmulatorError("Out of memory");
+    }
+    std::copy(program.begin(), program.end(), machine.memory.get());
+    machine.program_size = program.size();
+    machine.r[1] = input1;
+    machine.r[2] = input2;
+    machine.r[30] = MEMORY_SIZE;
+    machine.r[31] = TERMINATION_PC;
+    return machine;
+}
+
+template<bool counting>
+static EmulatorResult execute(Machine& machine) {
+#if defined(__GNUC__)
+#define HANDLER_ADDRESS(name) &&name,
+    static void* const handlers[] = {INSTRUCTIONS(HANDLER_ADDRESS)};
+#undef HANDLER_ADDRESS
+#endif
+
+    uint32_t* memory = machine.memory.get();
+    const uint32_t program_size = machine.program_size;
+    const uint32_t program_bytes = program_size * 4;
+
+    std::vector<Decoded> code;
+    code.reserve(program_size + 1);
+    for (uint32_t i = 0; i < program_size; ++i) {
+        code.push_back(decode(memory[i]));
+    }
+    code.push_back({Op::End, 0, 0, 0, 0});
+
+    std::vector<uint64_t> counts;
+    if constexpr (counting) {
+        counts.resize(code.size());
+    }
+
+    // registers are copied out so stores to memory cannot alias them
+    uint32_t r[33];
+    std::copy(machine.r, machine.r + 33, r);
+    uint32_t hi = machine.hi;
+    uint32_t lo = machine.lo;
+    std::string& output = machine.output;
+    uint64_t steps = machine.steps;
+
+    // index of the next word, the word after the running instruction
+    uint32_t pc = machine.pc;
+    const Decoded* instruction;
+    uint32_t address;
+    uint32_t target;
+
+    NEXT();
+    DISPATCH_BEGIN
+
+    HANDLER(Add) {
+        r[instruction->d] = r[instruction->s] + r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Sub) {
+        r[instruction->d] = r[instruction->s] - r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Mult) {
+        int64_t product = (int64_t)(int32_t)r[instruction->s]
+            * (int32_t)r[instruction->t];
+        lo = (uint32_t)product;
+        hi = (uint32_t)(product >> 32);
+        NEXT();
+    }
+    HANDLER(Multu) {
+        uint64_t product = (uint64_t)r[instruction->s] * r[instruction->t];
+        lo = (uint32_t)product;
+        hi = (uint32_t)(product >> 32);
+        NEXT();
+    }
+    HANDLER(Div) {
+        int32_t dividend = r[instruction->s];
+        int32_t divisor = r[instruction->t];
+        if (divisor == 0) {
+            throw error_at("Division by zero", (pc - 1) * 4);
+        }
+        if (dividend == INT32_MIN && divisor == -1) {
+            lo = dividend;
+            hi = 0;
+        } else {
+            lo = dividend / divisor;
+            hi = dividend % divisor;
+        }
+        NEXT();
+    }
+    HANDLER(Divu) {
+        if (r[instruction->t] == 0) {
+            throw error_at("Division by zero", (pc - 1) * 4);
+        }
+        lo = r[instruction->s] / r[instruction->t];
+        hi = r[instruction->s] % r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Mfhi) {
+        r[instruction->d] = hi;
+        NEXT();
+    }
+    HANDLER(Mflo) {
+        r[instruction->d] = lo;
+        NEXT();
+    }
+    HANDLER(Lis) {
+        // the constant is read from memory, it is never run
+        if (pc >= program_size) {
+            throw error_at("Missing word after lis", (pc - 1) * 4);
+        }
+        r[instruction->d] = memory[pc];
+        ++pc;
+        NEXT();
+    }
+    HANDLER(Slt) {
+        r[instruction->d] =
+            (int32_t)r[instruction->s] < (int32_t)r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Sltu) {
+        r[instruction->d] = r[instruction->s] < r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Jr) {
+        target = r[instruction->s];
+        goto jump;
+    }
+    HANDLER(Jalr) {
+        target = r[instruction->s];
+        r[31] = pc * 4;
+        goto jump;
+    }
+    HANDLER(And) {
+        r[instruction->d] = r[instruction->s] & r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Or) {
+        r[instruction->d] = r[instruction->s] | r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Xor) {
+        r[instruction->d] = r[instruction->s] ^ r[instruction->t];
+        NEXT();
+    }
+    HANDLER(Nor) {
+        r[instruction->d] = ~(r[instruction->s] | r[instruction->t]);
+        NEXT();
+    }
+    HANDLER(Sll) {
+        r[instruction->d] = r[instruction->t] << instruction->imm;
+        NEXT();
+    }
+    HANDLER(Srl) {
+        r[instruction->d] = r[instruction->t] >> instruction->imm;
+        NEXT();
+    }
+    HANDLER(Sra) {
+        r[instruction->d] = (int32_t)r[instruction->t] >> instruction->imm;
+        NEXT();
+    }
+    HANDLER(Sllv) {
+        r[instruction->d] = r[instruction->t] << (r[instruction->s] & 31);
+        NEXT();
+    }
+    HANDLER(Srlv) {
+        r[instruction->d] = r[instruction->t] >> (r[instruction->s] & 31);
+        NEXT();
+    }
+    HANDLER(Srav) {
+        r[instruction->d] =
+            (int32_t)r[instruction->t] >> (r[instruction->s] & 31);
+        NEXT();
+    }
+    HANDLER(Beq) {
+        if (r[instruction->s] == r[instruction->t]) {
+            goto branch;
+        }
+        NEXT();
+    }
+    HANDLER(Bne) {
+        if (r[instruction->s] != r[instruction->t]) {
+            goto branch;
+        }
+        NEXT();
+    }
+    HANDLER(Lw) {
+        address = r[instruction->s] + instruction->imm;
+        if (address >= MEMORY_SIZE || address % 4 != 0) {
+            throw error_at("Invalid load from " + hex(address), (pc - 1) * 4);
+        }
+        r[instruction->t] = memory[address / 4];
+        NEXT();
+    }
+    HANDLER(Sw) {
+        address = r[instruction->s] + instruction->imm;
+        if (address >= MEMORY_SIZE || address % 4 != 0) {
+            if (address == PRINT_ADDRESS) {
+                output.push_back((char)r[instruction->t]);
+                NEXT();
+            }
+            throw error_at("Invalid store to " + hex(address), (pc - 1) * 4);
+        }
+        memory[address / 4] = r[instruction->t];
+        if (address < program_bytes) {
+            code[address / 4] = decode(memory[address / 4]);
+        }
+        NEXT();
+    }
+    HANDLER(Lb) {
+        address = r[instruction->s] + instruction->imm;
+        if (address >= MEMORY_SIZE) {
+            throw error_at("Invalid load from " + hex(address), (pc - 1) * 4);
+        }
+        // bytes are little endian within a word
+        r[instruction->t] = (uint32_t)(int32_t)(int8_t)(
+            memory[address / 4] >> (address % 4 * 8)
+        );
+        NEXT();
+    }
+    HANDLER(Lbu) {
+        address = r[instruction->s] + instruction->imm;
+        if (address >= MEMORY_SIZE) {
+            throw error_at("Invalid load from " + hex(address), (pc - 1) * 4);
+        }
+        r[instruction->t] = (memory[address / 4] >> (address % 4 * 8)) & 0xff;
+        NEXT();
+    }
+    HANDLER(Sb) {
+        address = r[instruction->s] + instruction->imm;
+        if (address >= MEMORY_SIZE) {
+            if (address == PRINT_ADDRESS) {
+                output.push_back((char)r[instruction->t]);
+                NEXT();
+            }
+            throw error_at("Invalid store to " + hex(address), (pc - 1) * 4);
+        }
+        uint32_t shift = address % 4 * 8;
+        memory[address / 4] = (memory[address / 4] & ~(0xffu << shift))
+            | ((r[instruction->t] & 0xff) << shift);
+        if (address < program_bytes) {
+            code[address / 4] = decode(memory[address / 4]);
+        }
+        NEXT();
+    }
+    HANDLER(Addi) {
+        r[instruction->t] = r[instruction->s] + instruction->imm;
+        NEXT();
+    }
+    HANDLER(Slti) {
+        r[instruction->t] =
+            (int32_t)r[instruction->s] < (int32_t)instruction->imm;
+        NEXT();
+    }
+    HANDLER(Andi) {
+        r[instruction->t] = r[instruction->s] & instruction->imm;
+        NEXT();
+    }
+    HANDLER(Ori) {
+        r[instruction->t] = r[instruction->s] | instruction->imm;
+        NEXT();
+    }
+    HANDLER(Xori) {
+        r[instruction->t] = r[instruction->s] ^ instruction->imm;
+        NEXT();
+    }
+    HANDLER(Lui) {
+        r[instruction->t] = instruction->imm;
+        NEXT();
+    }
+    HANDLER(Invalid) {
+        throw error_at(
+            "Invalid instruction " + hex(memory[pc - 1]),
+            (pc - 1) * 4
+        );
+    }
+    HANDLER(End) {
+        throw error_at("Ran past the end of the program", (pc - 1) * 4);
+    }
+
+branch:
+    // offsets count words from the instruction after the branch
+    target = (pc + instruction->imm) * 4;
+jump:
+    if (target == TERMINATION_PC) {
+        if constexpr (counting) {
+            counts.pop_back();
+        }
+        return {std::move(output), (int32_t)r[3], steps, std::move(counts)};
+    }
+    if (target % 4 != 0 || target / 4 > program_size) {
+        throw error_at("Invalid jump to " + hex(target), (pc - 1) * 4);
+    }
+    pc = target / 4;
+    NEXT();
+
+    DISPATCH_END
+
+    // every handler leaves through NEXT, a jump or an exception
+    throw EmulatorError("Unreachable");
+}
+
+#undef NEXT
+#undef DISPATCH_END
+#undef DISPATCH_BEGIN
+#undef DISPATCH
+#undef HANDLER
+
+EmulatorResult interpret(Machine& machine, bool count_instructions) {
+    if (count_instructions) {
+        return execute<true>(machine);
+    }
+    return execute<false>(machine);
+}
+
+EmulatorResult run(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2,
+    bool count_instructions
+) {
+    Machine machine = load(program, input1, input2);
+    return interpret(machine, count_instructions);
+}
@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// returning to this address ends the program, it is in the link register
+// when the program starts
+static const uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
+// storing a word or byte here prints its low byte
+static const uint32_t PRINT_ADDRESS = 0xffff000c;
+// bytes of memory, the program is loaded at 0 and the stack starts at the top
+static const uint32_t MEMORY_SIZE = 1 << 24;
+
+class EmulatorError: public std::runtime_error {
+  public:
+    EmulatorError(const std::string& message);
+};
+
+struct EmulatorResult {
+    // everything printed through PRINT_ADDRESS
+    std::string output;
+    // value of $3 when the program returned
+    int32_t result;
+    // instructions executed
+    uint64_t steps;
+    // times the instruction at each word of the program ran, empty unless
+    // counting was requested
+    std::vector<uint64_t> counts;
+};
+
+// reads a binary written by cnl, words are stored big endian
+std::vector<uint32_t> read_program(std::string path);
+
+// runs program with input1 and input2 in $1 and $2 until it jumps to
+// TERMINATION_PC, throws an EmulatorError on invalid instructions and
+// accesses
+EmulatorResult run(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2,
+    bool count_instructions = false
+);
+
+// same as run, but translates the program to x86-64 a basic block at a time
+// and runs it natively, stores into translated code and anything the
+// translation does not handle continue in the interpreter, hosts other than
+// x86-64 Linux only interpret. Steps are only counted with count_steps,
+// which costs an add per translated block
+EmulatorResult run_jit(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2,
+    bool count_steps = false
+);
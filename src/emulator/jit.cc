@@ -0,0 +1,806 @@
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+#include "machine.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/mman.h>
+
+namespace {
+
+// state the translated code reads and writes through rbx
+struct JitContext {
+    uint32_t r[33];
+    uint32_t hi;
+    uint32_t lo;
+    uint64_t steps;
+    // left by the exit routine for the dispatcher
+    uint32_t exit_value;
+    uint64_t exit_site;
+    Machine* machine;
+    // 1 for each program word read by translated code
+    const uint8_t* translated;
+};
+
+// why translated code returned to the dispatcher
+enum Exit : uint32_t {
+    // the program returned, value and site are unused
+    Terminated,
+    // value is the word index of an untranslated block, site is the rel32
+    // field of the jump to point at it once translated, or 0
+    Lookup,
+    // value is the word index the interpreter resumes at, site is the
+    // number of instructions counted on block entry that did not run
+    Fallback,
+};
+
+// what a store helper did
+enum StoreResult : uint32_t {
+    Stored,
+    // the store hit translated code, resume interpreting after it
+    StoredCode,
+    // the interpreter redoes the store and reports the error
+    Invalid,
+};
+
+enum Host : uint8_t {
+    Eax = 0,
+    Ecx = 1,
+    Edx = 2,
+    Rbp = 5,
+    Rsi = 6,
+    Rdi = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11,
+    R14 = 14,
+    R15 = 15,
+};
+
+// the busiest registers of compiled programs stay in host registers while
+// translated code runs, the rest live in the context
+struct Mapping {
+    uint8_t reg;
+    Host host;
+    // clobbered by calls to the store helpers
+    bool caller_saved;
+};
+const Mapping MAPPINGS[] = {
+    {3, Rbp, false},
+    {4, Rsi, true},
+    {6, Rdi, true},
+    {10, R8, true},
+    {11, R9, true},
+    {12, R10, true},
+    {15, R11, true},
+    {29, R14, false},
+};
+
+// host register of reg, -1 for registers in the context
+int host_of(uint8_t reg) {
+    for (auto& mapping : MAPPINGS) {
+        if (mapping.reg == reg) {
+            return mapping.host;
+        }
+    }
+    return -1;
+}
+
+enum Condition : uint8_t {
+    Below = 0x2,
+    AboveOrEqual = 0x3,
+    Equal = 0x4,
+    NotEqual = 0x5,
+    Above = 0x7,
+};
+
+const uint32_t MAX_BLOCK_LENGTH = 64;
+// more than the largest block can take, with its out of line stubs
+const size_t MAX_BLOCK_BYTES = MAX_BLOCK_LENGTH * 160 + 256;
+
+uint32_t store_word(JitContext* context, uint32_t address, uint32_t value) {
+    Machine& machine = *context->machine;
+    if (address == PRINT_ADDRESS) {
+        machine.output.push_back((char)value);
+        return Stored;
+    }
+    if (address >= MEMORY_SIZE || address % 4 != 0) {
+        return Invalid;
+    }
+    machine.memory[address / 4] = value;
+    if (address / 4 < machine.program_size
+        && context->translated[address / 4]) {
+        return StoredCode;
+    }
+    return Stored;
+}
+
+uint32_t store_byte(JitContext* context, uint32_t address, uint32_t value) {
+    Machine& machine = *context->machine;
+    if (address == PRINT_ADDRESS) {
+        machine.output.push_back((char)value);
+        return Stored;
+    }
+    if (address >= MEMORY_SIZE) {
+        return Invalid;
+    }
+    ((uint8_t*)machine.memory.get())[address] = value;
+    if (address / 4 < machine.program_size
+        && context->translated[address / 4]) {
+        return StoredCode;
+    }
+    return Stored;
+}
+
+// translates basic blocks of the program to x86-64 on demand, blocks jump
+// straight to each other once both are translated
+class Translator {
+    Machine& machine;
+    // whether blocks add their length to the step count in r15
+    bool count_steps;
+    uint8_t* buffer;
+    size_t capacity;
+    size_t used = 0;
+    uint8_t* enter;
+    uint8_t* exit;
+    uint8_t* terminate;
+
+    // placed after the block body once its length is known
+    struct Stub {
+        enum Kind { Lookup, Fallback, Store } kind;
+        // rel32 field jumping to the stub
+        uint8_t* site;
+        uint32_t index;
+        // position of the instruction in the block
+        uint32_t position = 0;
+        // where a store continues, and whether it stores a byte
+        uint8_t* resume = nullptr;
+        bool byte = false;
+    };
+    std::vector<Stub> stubs;
+    uint32_t block_length;
+
+    uint8_t* here() {
+        return buffer + used;
+    }
+
+    void emit(uint8_t byte) {
+        buffer[used++] = byte;
+    }
+
+    void emit(std::initializer_list<uint8_t> bytes) {
+        for (uint8_t byte : bytes) {
+            emit(byte);
+        }
+    }
+
+    void emit32(uint32_t value) {
+        memcpy(here(), &value, 4);
+        used += 4;
+    }
+
+    void emit64(uint64_t value) {
+        memcpy(here(), &value, 8);
+        used += 8;
+    }
+
+    static void patch(uint8_t* site, uint8_t* target) {
+        int32_t offset = target - (site + 4);
+        memcpy(site, &offset, 4);
+    }
+
+    void rex(bool wide, uint8_t reg, int rm) {
+        uint8_t prefix =
+            0x40 | wide << 3 | (reg >= 8) << 2 | (rm >= 8 ? 1 : 0);
+        if (prefix != 0x40) {
+            emit(prefix);
+        }
+    }
+
+    // opcode with a [rbx + offset] operand
+    void context_op(
+        uint8_t opcode,
+        uint8_t reg,
+        uint32_t offset,
+        bool wide = false
+    ) {
+        rex(wide, reg, 0);
+        emit(opcode);
+        if (offset < 128) {
+            emit(0x43 | (reg & 7) << 3);
+            emit(offset);
+        } else {
+            emit(0x83 | (reg & 7) << 3);
+            emit32(offset);
+        }
+    }
+
+    // opcode with the MIPS register mips as its r/m operand
+    void reg_op(uint8_t opcode, uint8_t reg, uint8_t mips) {
+        int host = host_of(mips);
+        if (host < 0) {
+            context_op(opcode, reg, reg_offset(mips));
+            return;
+        }
+        rex(false, reg, host);
+        emit(opcode);
+        emit(0xc0 | (reg & 7) << 3 | (host & 7));
+    }
+
+    void spill(bool caller_saved_only) {
+        for (auto& mapping : MAPPINGS) {
+            if (mapping.caller_saved || !caller_saved_only) {
+                context_op(0x89, mapping.host, reg_offset(mapping.reg));
+            }
+        }
+    }
+
+    void reload(bool caller_saved_only) {
+        for (auto& mapping : MAPPINGS) {
+            if (mapping.caller_saved || !caller_saved_only) {
+                context_op(0x8b, mapping.host, reg_offset(mapping.reg));
+            }
+        }
+    }
+
+    static uint32_t reg_offset(uint8_t reg) {
+        return offsetof(JitContext, r) + 4 * reg;
+    }
+
+    void load(Host host, uint8_t reg) {
+        if (reg == 0) {
+            // xor host, host
+            rex(false, host, host);
+            emit({0x31, (uint8_t)(0xc0 | (host & 7) << 3 | (host & 7))});
+            return;
+        }
+        reg_op(0x8b, host, reg);
+    }
+
+    void store(uint8_t reg, Host host) {
+        reg_op(0x89, host, reg);
+    }
+
+    void store_imm(uint8_t reg, uint32_t value) {
+        int host = host_of(reg);
+        if (host < 0) {
+            context_op(0xc7, 0, reg_offset(reg));
+        } else {
+            rex(false, 0, host);
+            emit(0xb8 | (host & 7));
+        }
+        emit32(value);
+    }
+
+    // jcc or jmp with a rel32 to fill in, returns the rel32 field
+    uint8_t* jump(Condition condition) {
+        emit({0x0f, (uint8_t)(0x80 | condition)});
+        emit32(0);
+        return here() - 4;
+    }
+
+    uint8_t* jump() {
+        emit(0xe9);
+        emit32(0);
+        return here() - 4;
+    }
+
+    void exit_with(Exit status) {
+        emit(0xb8);
+        emit32(status);
+        patch(jump(), exit);
+    }
+
+    void fallback_stub(uint32_t index, uint32_t remaining) {
+        emit(0xba);
+        emit32(index);
+        emit(0xb9);
+        emit32(remaining);
+        exit_with(Fallback);
+    }
+
+    // resumes the interpreter at the instruction at position
+    void fallback_at(uint8_t* site, uint32_t index, uint32_t position) {
+        stubs.push_back({Stub::Fallback, site, index, position});
+    }
+
+    // continues at the block for index
+    void goto_block(uint8_t* site, uint32_t index) {
+        if (blocks[index]) {
+            patch(site, blocks[index]);
+        } else {
+            stubs.push_back({Stub::Lookup, site, index});
+        }
+    }
+
+    void emit_stubs() {
+        for (auto& stub : stubs) {
+            patch(stub.site, here());
+            if (stub.kind == Stub::Lookup) {
+                emit(0xba);
+                emit32(stub.index);
+                emit({0x48, 0xb9});
+                emit64((uint64_t)stub.site);
+                exit_with(Lookup);
+            } else if (stub.kind == Stub::Fallback) {
+                fallback_stub(stub.index, block_length - stub.position);
+            } else {
+                // rdi = context, esi = address, edx = value
+                spill(true);
+                emit({0x48, 0x89, 0xdf, 0x89, 0xc6, 0x89, 0xca});
+                emit({0x48, 0xb8});
+                emit64((uint64_t)(stub.byte ? &store_byte : &store_word));
+                emit({0xff, 0xd0});
+                reload(true);
+                emit({0x85, 0xc0});
+                patch(jump(Equal), stub.resume);
+                emit({0x83, 0xf8, StoredCode});
+                uint8_t* invalid = jump(NotEqual);
+                fallback_stub(stub.index + 1, block_length - stub.position - 1);
+                patch(invalid, here());
+                fallback_stub(stub.index, block_length - stub.position);
+            }
+        }
+        stubs.clear();
+    }
+
+    // eax = reg + imm, the address of a load or store
+    void address(const Decoded& instruction) {
+        load(Eax, instruction.s);
+        if (instruction.imm != 0) {
+            emit(0x05);
+            emit32(instruction.imm);
+        }
+    }
+
+    // eax < limit, with the fallback for other addresses
+    void check_address(uint32_t limit, uint32_t index, uint32_t position) {
+        emit(0x3d);
+        emit32(limit);
+        fallback_at(jump(AboveOrEqual), index, position);
+    }
+
+    void check_aligned(uint32_t index, uint32_t position) {
+        emit({0xa8, 0x03});
+        fallback_at(jump(NotEqual), index, position);
+    }
+
+    // stores ecx to eax, addresses outside the memory above the program go
+    // through a helper
+    void store_memory(uint32_t index, uint32_t position, bool byte) {
+        if (!byte) {
+            check_aligned(index, position);
+        }
+        uint32_t program_bytes = machine.program_size * 4;
+        // edx = eax - program_bytes, unsigned compare against the rest
+        emit({0x89, 0xc2, 0x81, 0xea});
+        emit32(program_bytes);
+        emit({0x81, 0xfa});
+        emit32(MEMORY_SIZE - program_bytes);
+        uint8_t* site = jump(AboveOrEqual);
+        emit({0x41, (uint8_t)(byte ? 0x88 : 0x89), 0x0c, 0x04});
+        stubs.push_back({Stub::Store, site, index, position, here(), byte});
+    }
+
+    // jumps to the word address in eax
+    void indirect_jump(uint32_t index, uint32_t position, bool link) {
+        emit(0x3d);
+        emit32(TERMINATION_PC);
+        patch(jump(Equal), terminate);
+        check_aligned(index, position);
+        emit(0x3d);
+        emit32(machine.program_size * 4);
+        fallback_at(jump(Above), index, position);
+        if (link) {
+            store_imm(31, (index + 1) * 4);
+        }
+        // rcx = blocks[eax / 4]
+        emit({0x49, 0x8b, 0x4c, 0x45, 0x00});
+        emit({0x48, 0x85, 0xc9});
+        uint8_t* miss = jump(Equal);
+        emit({0xff, 0xe1});
+        patch(miss, here());
+        // edx = eax / 4, rcx = 0
+        emit({0x89, 0xc2, 0xc1, 0xea, 0x02, 0x31, 0xc9});
+        exit_with(Lookup);
+    }
+
+    void set_flag_result(uint8_t setcc, uint8_t reg) {
+        emit({0x0f, setcc, 0xc0, 0x0f, 0xb6, 0xc0});
+        store(reg, Eax);
+    }
+
+    // emits one instruction, returns false when it ends the block
+    bool translate(const Decoded& instruction, uint32_t index, uint32_t pos);
+
+  public:
+    // entry point of the translated block at each word index, translated
+    // code looks up jump targets here
+    std::vector<uint8_t*> blocks;
+    std::vector<uint8_t> translated;
+
+    Translator(Machine& machine, bool count_steps);
+    ~Translator();
+
+    bool ready() {
+        return buffer != nullptr;
+    }
+
+    // nullptr once the buffer is full
+    uint8_t* block(uint32_t index);
+
+    uint32_t run(JitContext& context, uint8_t* target) {
+        using Enter = uint32_t (*)(JitContext*, uint32_t*, uint8_t**, uint8_t*);
+        return ((Enter)enter)(
+            &context,
+            machine.memory.get(),
+            blocks.data(),
+            target
+        );
+    }
+};
+
+Translator::Translator(Machine& machine, bool count_steps) :
+    machine {machine},
+    count_steps {count_steps},
+    blocks(machine.program_size + 1),
+    translated(machine.program_size + 1) {
+    capacity = std::max<size_t>(
+        1 << 22,
+        (size_t)machine.program_size * 4 * MAX_BLOCK_LENGTH
+    );
+    void* memory = mmap(
+        nullptr,
+        capacity,
+        PROT_READ | PROT_WRITE | PROT_EXEC,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    buffer = memory == MAP_FAILED ? nullptr : (uint8_t*)memory;
+    if (!buffer) {
+        return;
+    }
+
+    // enter(context, memory, blocks, target) saves the callee saved
+    // registers, keeps the stack 16 byte aligned for helpers and loads the
+    // mapped registers and the step count into r15
+    enter = here();
+    emit({0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57});
+    emit({0x48, 0x83, 0xec, 0x08});
+    emit({0x48, 0x89, 0xfb, 0x49, 0x89, 0xf4, 0x49, 0x89, 0xd5});
+    reload(false);
+    context_op(0x8b, R15, offsetof(JitContext, steps), true);
+    emit({0xff, 0xe1});
+
+    // returns eax after saving edx and rcx for the dispatcher
+    exit = here();
+    spill(false);
+    context_op(0x89, R15, offsetof(JitContext, steps), true);
+    context_op(0x89, Edx, offsetof(JitContext, exit_value));
+    context_op(0x89, Ecx, offsetof(JitContext, exit_site), true);
+    emit({0x48, 0x83, 0xc4, 0x08});
+    emit({0x41, 0x5f, 0x41, 0x5e, 0x41, 0x5d, 0x41, 0x5c, 0x5d, 0x5b, 0xc3});
+
+    terminate = here();
+    exit_with(Terminated);
+}
+
+Translator::~Translator() {
+    if (buffer) {
+        munmap(buffer, capacity);
+    }
+}
+
+uint8_t* Translator::block(uint32_t index) {
+    if (blocks[index]) {
+        return blocks[index];
+    }
+    if (capacity - used < MAX_BLOCK_BYTES) {
+        return nullptr;
+    }
+
+    // the length is known once the block is translated, the step count
+    // added on entry is filled in then
+    uint8_t* start = here();
+    uint8_t* step_count = nullptr;
+    if (count_steps) {
+        emit({0x49, 0x81, 0xc7});
+        step_count = here();
+        emit32(0);
+    }
+
+    block_length = 0;
+    uint32_t position = 0;
+    uint32_t i = index;
+    for (;;) {
+        Decoded instruction = i < machine.program_size
+            ? decode(machine.memory[i])
+            : Decoded {Op::End, 0, 0, 0, 0};
+        if (i < machine.program_size) {
+            translated[i] = 1;
+        }
+        ++block_length;
+        bool next = translate(instruction, i, position);
+        i += instruction.op == Op::Lis ? 2 : 1;
+        ++position;
+        if (!next) {
+            break;
+        }
+        if (position == MAX_BLOCK_LENGTH) {
+            goto_block(jump(), i);
+            break;
+        }
+    }
+    if (step_count) {
+        memcpy(step_count, &block_length, 4);
+    }
+    emit_stubs();
+
+    blocks[index] = start;
+    return start;
+}
+
+bool Translator::translate(
+    const Decoded& instruction,
+    uint32_t index,
+    uint32_t position
+) {
+    uint8_t s = instruction.s;
+    uint8_t t = instruction.t;
+    uint8_t d = instruction.d;
+    uint32_t imm = instruction.imm;
+    const uint32_t hi = offsetof(JitContext, hi);
+    const uint32_t lo = offsetof(JitContext, lo);
+
+    switch (instruction.op) {
+        case Op::Add:
+        case Op::Sub:
+        case Op::And:
+        case Op::Or:
+        case Op::Xor:
+        case Op::Nor: {
+            uint8_t opcode = instruction.op == Op::Add ? 0x03
+                : instruction.op == Op::Sub            ? 0x2b
+                : instruction.op == Op::And            ? 0x23
+                : instruction.op == Op::Xor            ? 0x33
+                                                       : 0x0b;
+            load(Eax, s);
+            reg_op(opcode, Eax, t);
+            if (instruction.op == Op::Nor) {
+                emit({0xf7, 0xd0});
+            }
+            store(d, Eax);
+            return true;
+        }
+        case Op::Mult:
+        case Op::Multu:
+            load(Eax, s);
+            reg_op(0xf7, instruction.op == Op::Mult ? 5 : 4, t);
+            context_op(0x89, Eax, lo);
+            context_op(0x89, Edx, hi);
+            return true;
+        case Op::Div:
+        case Op::Divu: {
+            load(Ecx, t);
+            emit({0x85, 0xc9});
+            fallback_at(jump(Equal), index, position);
+            load(Eax, s);
+            if (instruction.op == Op::Div) {
+                // INT32_MIN / -1 is left to the interpreter
+                emit({0x83, 0xf9, 0xff, 0x75, 0x0b});
+                emit(0x3d);
+                emit32(0x80000000);
+                fallback_at(jump(Equal), index, position);
+                emit({0x99, 0xf7, 0xf9});
+            } else {
+                emit({0x31, 0xd2, 0xf7, 0xf1});
+            }
+            context_op(0x89, Eax, lo);
+            context_op(0x89, Edx, hi);
+            return true;
+        }
+        case Op::Mfhi:
+        case Op::Mflo:
+            context_op(0x8b, Eax, instruction.op == Op::Mfhi ? hi : lo);
+            store(d, Eax);
+            return true;
+        case Op::Lis:
+            if (index + 1 >= machine.program_size) {
+                fallback_at(jump(), index, position);
+                return false;
+            }
+            translated[index + 1] = 1;
+            store_imm(d, machine.memory[index + 1]);
+            return true;
+        case Op::Slt:
+        case Op::Sltu:
+            load(Eax, s);
+            reg_op(0x3b, Eax, t);
+            set_flag_result(instruction.op == Op::Slt ? 0x9c : 0x92, d);
+            return true;
+        case Op::Jr:
+        case Op::Jalr:
+            load(Eax, s);
+            indirect_jump(index, position, instruction.op == Op::Jalr);
+            return false;
+        case Op::Sll:
+        case Op::Srl:
+        case Op::Sra: {
+            uint8_t kind = instruction.op == Op::Sll ? 0xe0
+                : instruction.op == Op::Srl          ? 0xe8
+                                                     : 0xf8;
+            load(Eax, t);
+            emit({0xc1, kind, (uint8_t)imm});
+            store(d, Eax);
+            return true;
+        }
+        case Op::Sllv:
+        case Op::Srlv:
+        case Op::Srav: {
+            uint8_t kind = instruction.op == Op::Sllv ? 0xe0
+                : instruction.op == Op::Srlv          ? 0xe8
+                                                      : 0xf8;
+            load(Ecx, s);
+            load(Eax, t);
+            emit({0xd3, kind});
+            store(d, Eax);
+            return true;
+        }
+        case Op::Beq:
+        case Op::Bne: {
+            uint32_t target = index + 1 + imm;
+            uint8_t* taken;
+            if (s == t) {
+                if (instruction.op == Op::Bne) {
+                    return true;
+                }
+                taken = jump();
+            } else {
+                load(Eax, s);
+                reg_op(0x3b, Eax, t);
+                taken = jump(instruction.op == Op::Beq ? Equal : NotEqual);
+            }
+            if (target > machine.program_size) {
+                fallback_at(taken, index, position);
+            } else {
+                goto_block(taken, target);
+            }
+            if (s != t) {
+                goto_block(jump(), index + 1);
+            }
+            return false;
+        }
+        case Op::Lw:
+            address(instruction);
+            check_aligned(index, position);
+            check_address(MEMORY_SIZE, index, position);
+            emit({0x41, 0x8b, 0x04, 0x04});
+            store(t, Eax);
+            return true;
+        case Op::Lb:
+        case Op::Lbu:
+            address(instruction);
+            check_address(MEMORY_SIZE, index, position);
+            // movsx or movzx eax, byte [r12 + rax]
+            emit({0x41, 0x0f});
+            emit(instruction.op == Op::Lb ? 0xbe : 0xb6);
+            emit({0x04, 0x04});
+            store(t, Eax);
+            return true;
+        case Op::Sw:
+        case Op::Sb:
+            address(instruction);
+            load(Ecx, t);
+            store_memory(index, position, instruction.op == Op::Sb);
+            return true;
+        case Op::Addi:
+        case Op::Andi:
+        case Op::Ori:
+        case Op::Xori: {
+            uint8_t opcode = instruction.op == Op::Addi ? 0x05
+                : instruction.op == Op::Andi            ? 0x25
+                : instruction.op == Op::Ori             ? 0x0d
+                                                        : 0x35;
+            load(Eax, s);
+            emit(opcode);
+            emit32(imm);
+            store(t, Eax);
+            return true;
+        }
+        case Op::Slti:
+            load(Eax, s);
+            emit(0x3d);
+            emit32(imm);
+            set_flag_result(0x9c, t);
+            return true;
+        case Op::Lui:
+            store_imm(t, imm);
+            return true;
+        case Op::Invalid:
+        case Op::End:
+            fallback_at(jump(), index, position);
+            return false;
+    }
+    return false;
+}
+
+}  // namespace
+
+EmulatorResult run_jit(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2,
+    bool count_steps
+) {
+    Machine machine = load(program, input1, input2);
+    Translator translator {machine, count_steps};
+    if (!translator.ready()) {
+        return interpret(machine, false);
+    }
+
+    JitContext context {};
+    std::copy(machine.r, machine.r + 33, context.r);
+    context.machine = &machine;
+    context.translated = translator.translated.data();
+
+    uint32_t index = 0;
+    uint8_t* site = nullptr;
+    for (;;) {
+        uint8_t* target = translator.block(index);
+        if (!target) {
+            machine.pc = index;
+            break;
+        }
+        if (site) {
+            int32_t offset = target - (site + 4);
+            memcpy(site, &offset, 4);
+        }
+
+        uint32_t status = translator.run(context, target);
+        if (status == Terminated) {
+            return {
+                std::move(machine.output),
+                (int32_t)context.r[3],
+                context.steps,
+                {}};
+        }
+        if (status == Fallback) {
+            machine.pc = context.exit_value;
+            if (count_steps) {
+                context.steps -= context.exit_site;
+            }
+            break;
+        }
+        index = context.exit_value;
+        site = (uint8_t*)context.exit_site;
+    }
+
+    std::copy(context.r, context.r + 33, machine.r);
+    machine.hi = context.hi;
+    machine.lo = context.lo;
+    machine.steps = context.steps;
+    return interpret(machine, false);
+}
+
+#else
+
+EmulatorResult run_jit(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2,
+    bool
+) {
+    return run(program, input1, input2);
+}
+
+#endif
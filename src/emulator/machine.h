@@ -0,0 +1,99 @@
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+// every instruction cnl emits, End marks the word past the program
+#define INSTRUCTIONS(X) \
+    X(Add) \
+    X(Sub) \
+    X(Mult) \
+    X(Multu) \
+    X(Div) \
+    X(Divu) \
+    X(Mfhi) \
+    X(Mflo) \
+    X(Lis) \
+    X(Slt) \
+    X(Sltu) \
+    X(Jr) \
+    X(Jalr) \
+    X(And) \
+    X(Or) \
+    X(Xor) \
+    X(Nor) \
+    X(Sll) \
+    X(Srl) \
+    X(Sra) \
+    X(Sllv) \
+    X(Srlv) \
+    X(Srav) \
+    X(Beq) \
+    X(Bne) \
+    X(Lw) \
+    X(Sw) \
+    X(Lb) \
+    X(Lbu) \
+    X(Sb) \
+    X(Addi) \
+    X(Slti) \
+    X(Andi) \
+    X(Ori) \
+    X(Xori) \
+    X(Lui) \
+    X(Invalid) \
+    X(End)
+
+enum class Op : uint8_t {
+#define OP_ENTRY(name) name,
+    INSTRUCTIONS(OP_ENTRY)
+#undef OP_ENTRY
+};
+
+// an instruction word split into its fields once, when it is loaded
+struct Decoded {
+    Op op;
+    uint8_t s;
+    uint8_t t;
+    uint8_t d;
+    // extended immediate or shift amount
+    uint32_t imm;
+};
+
+// writes to $0 land here so $0 always reads as 0
+static const uint8_t DISCARD = 32;
+
+// state of a running program, the translator hands it to the interpreter
+// when it cannot continue
+struct Machine {
+    // zeroed lazily by calloc, most programs touch little of it
+    std::unique_ptr<uint32_t[], decltype(&free)> memory {nullptr, &free};
+    // words of memory holding the program, code and static data
+    uint32_t program_size = 0;
+    uint32_t r[33] = {0};
+    uint32_t hi = 0;
+    uint32_t lo = 0;
+    // index of the next instruction word
+    uint32_t pc = 0;
+    std::string output;
+    uint64_t steps = 0;
+};
+
+Decoded decode(uint32_t word);
+
+// copies program to address 0 and sets up the registers for its start
+Machine load(
+    const std::vector<uint32_t>& program,
+    int32_t input1,
+    int32_t input2
+);
+
+// runs machine from its pc until the program returns
+EmulatorResult interpret(Machine& machine, bool count_instructions);
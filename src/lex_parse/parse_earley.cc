@@ -85,6 +85,11 @@ static std::optional<std::vector<ASTNode>> search_sets(
         }
     } else {
         for (auto item : complete_sets.at(from)) {
+            // longer items can not fit, searching them anyway would cache
+            // failures of spans still being searched further up
+            if (item.end - from > length) {
+                continue;
+            }
             Production prod = productions.at(item.rule);
             if (std::holds_alternative<NonTerminal>(lhs.front())
                 && prod.lhs == std::get<NonTerminal>(lhs.front())) {
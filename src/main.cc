@@ -16,12 +16,46 @@
 int main(int argc, char* argv[]) {
     std::vector<std::string> input_file_paths;
     std::string output_file_path = "a.out";
+    CompileOptions options;
+    bool native = false;
+    const std::string inline_threshold_flag = "--inline-threshold=";
+    const std::string profile_use_flag = "--profile-use=";
+    const std::string label_map_flag = "--label-map=";
     size_t i = 1;
     while (i < argc) {
+        std::string arg = argv[i];
         if (std::strcmp(argv[i], "-o") == 0) {
             assert(i + 1 < argc);
             output_file_path = argv[i + 1];
             i += 2;
+        } else if (arg == "--target=x86-64") {
+            native = true;
+            i += 1;
+        } else if (arg == "--target=mips") {
+            native = false;
+            i += 1;
+        } else if (arg == "--gc") {
+            options.gc = true;
+            i += 1;
+        } else if (arg == "--select-instructions") {
+            options.select_instructions = true;
+            i += 1;
+        } else if (arg == "--no-select-instructions") {
+            options.select_instructions = false;
+            i += 1;
+        } else if (arg == "--no-frame-objects") {
+            options.frame_objects = false;
+            i += 1;
+        } else if (arg.starts_with(inline_threshold_flag)) {
+            options.inline_threshold =
+                std::stoul(arg.substr(inline_threshold_flag.length()));
+            i += 1;
+        } else if (arg.starts_with(profile_use_flag)) {
+            options.profile_path = arg.substr(profile_use_flag.length());
+            i += 1;
+        } else if (arg.starts_with(label_map_flag)) {
+            options.label_map_path = arg.substr(label_map_flag.length());
+            i += 1;
         } else {
             input_file_paths.push_back(argv[i]);
             i += 1;
@@ -29,8 +63,13 @@ int main(int argc, char* argv[]) {
     }
 
     try {
-        auto program = compile(input_file_paths);
-        write_file(output_file_path, program);
+        if (native) {
+            auto [program, data] = compile_labelled(input_file_paths, options);
+            write_elf(output_file_path, program, data);
+        } else {
+            auto program = compile(input_file_paths, options);
+            write_file(output_file_path, program);
+        }
     } catch (CompileError& compile_error) {
         std::cerr << compile_error.what() << std::endl;
 
@@ -13,17 +13,36 @@
 struct Variable;
 
 Chunk::Chunk(std::vector<std::shared_ptr<Variable>> variables) :
+    Chunk(variables, variables) {}
+
+Chunk::Chunk(
+    std::vector<std::shared_ptr<Variable>> variables,
+    std::vector<std::shared_ptr<Variable>> zeroed
+) :
     variables {variables},
+    zeroed {zeroed},
     words {static_cast<uint32_t>(variables.size() + 1)},
-    bytes {static_cast<uint32_t>(4 * (variables.size() + 1))} {}
+    bytes {static_cast<uint32_t>(4 * (variables.size() + 1))} {
+    for (uint32_t i = 0; i < variables.size(); ++i) {
+        slots[variables.at(i)] = i;
+    }
+}
+
+Chunk::Chunk(
+    std::vector<std::shared_ptr<Variable>> variables,
+    std::vector<std::shared_ptr<Variable>> zeroed,
+    std::map<std::shared_ptr<Variable>, uint32_t> slots,
+    uint32_t slot_count
+) :
+    slots {slots},
+    variables {variables},
+    zeroed {zeroed},
+    words {slot_count + 1},
+    bytes {4 * (slot_count + 1)} {}
 
 uint32_t Chunk::get_offset(std::shared_ptr<Variable>& variable) {
-    uint32_t offset = 4;
-    for (auto& v : variables) {
-        if (variable == v) {
-            return offset;
-        }
-        offset += 4;
+    if (slots.contains(variable)) {
+        return 4 * (slots.at(variable) + 1);
     }
     std::cerr << "Variable not found in chunk: " << variable->name << std::endl;
     exit(1);
@@ -48,15 +67,10 @@ Chunk::store(Reg base, std::shared_ptr<Variable>& variable, Reg reg) {
     return make_sw(reg, get_offset(variable), base);
 }
 
-std::shared_ptr<Code> Chunk::initialize() {
+std::shared_ptr<Code> Chunk::clear(Reg base) {
     std::vector<std::shared_ptr<Code>> result;
-    result.push_back(make_lis(Reg::Scratch));
-    result.push_back(make_word(bytes));
-    result.push_back(make_sw(Reg::Scratch, 0, Reg::Result));
-
-    for (auto& v : variables) {
-        result.push_back(store(Reg::Result, v, Reg::Zero));
+    for (auto& v : zeroed) {
+        result.push_back(store(base, v, Reg::Zero));
     }
-
     return make_block(result);
 }
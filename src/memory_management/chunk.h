@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -14,13 +15,28 @@ enum class Reg;
 struct Variable;
 
 class Chunk {
+    // word index of each variable past the size word, variables may share
+    // a word when they are never live at the same time
+    std::map<std::shared_ptr<Variable>, uint32_t> slots;
     uint32_t get_offset(std::shared_ptr<Variable>& variable);
 
   public:
     std::vector<std::shared_ptr<Variable>> variables;
+    // variables cleared by clear, all of them unless given
+    std::vector<std::shared_ptr<Variable>> zeroed;
     const uint32_t words;
     const uint32_t bytes;
     explicit Chunk(std::vector<std::shared_ptr<Variable>> variables);
+    Chunk(
+        std::vector<std::shared_ptr<Variable>> variables,
+        std::vector<std::shared_ptr<Variable>> zeroed
+    );
+    Chunk(
+        std::vector<std::shared_ptr<Variable>> variables,
+        std::vector<std::shared_ptr<Variable>> zeroed,
+        std::map<std::shared_ptr<Variable>, uint32_t> slots,
+        uint32_t slot_count
+    );
 
     std::shared_ptr<Code>
     load(Reg base, Reg reg, std::shared_ptr<Variable>& variable);
@@ -29,5 +45,6 @@ class Chunk {
     std::shared_ptr<Code>
     store(Reg base, std::shared_ptr<Variable>& variable, Reg reg);
 
-    std::shared_ptr<Code> initialize();
+    // zeroes the cleared variables of the chunk at base
+    std::shared_ptr<Code> clear(Reg base);
 };
@@ -9,6 +9,8 @@
 #include "beq_label.h"
 #include "bin_op.h"
 #include "block.h"
+#include "call.h"
+#include "constant_ops.h"
 #include "define_label.h"
 #include "if_stmt.h"
 #include "label.h"
@@ -22,82 +24,480 @@
 #include "typed_variable.h"
 #include "var_access.h"
 #include "variable.h"
+#include "while_loop.h"
+
+// the heap starts with a control block, the first never used block follows
+// it. Every block is a header word and the bytes handed out. The header of
+// a block in use holds its size in bytes plus PREV_FREE when the block
+// before it is free and has a footer. A free block's header holds its size
+// negated, the first word after it links to the next free block of its
+// list. Free blocks of at least LINKED_BYTES also hold the address of the
+// word linking to them and end with a footer repeating their size, so their
+// neighbours can take them off their list and merge with them
+//
+// free blocks of up to SMALL_BYTES are kept on a list per size, larger ones
+// on one list searched first fit
+static const uint32_t SMALL_BYTES = 128;
+static const uint32_t LINKED_BYTES = 12;
+static const uint32_t PREV_FREE = 1;
+// address of the first never used block
+static const uint32_t BUMP = 0;
+// no free block on the small and the large lists is larger than these
+static const uint32_t SMALL_TOP = 4;
+static const uint32_t LARGE_TOP = 8;
+static const uint32_t LARGE = 12;
+// head of the list of free blocks of size bytes is at SIZE_LISTS + bytes
+static const uint32_t SIZE_LISTS = 12;
+static const uint32_t CONTROL_BYTES = SIZE_LISTS + 4 + SMALL_BYTES;
+// offsets of the links in a free block
+static const uint32_t NEXT = 4;
+static const uint32_t LINKED_FROM = 8;
+
+static std::shared_ptr<Code>
+plus(std::shared_ptr<Code> e1, std::shared_ptr<Code> e2) {
+    return bin_op(e1, op::plus(), e2);
+}
+
+static std::shared_ptr<Code>
+minus(std::shared_ptr<Code> e1, std::shared_ptr<Code> e2) {
+    return bin_op(e1, op::minus(), e2);
+}
+
+static std::shared_ptr<Code> negate(std::shared_ptr<Code> expr) {
+    return bin_op(to_expr(Reg::Zero), op::minus(), expr);
+}
+
+static std::shared_ptr<Code> jump(std::shared_ptr<Label> label) {
+    return make_beq(Reg::Zero, Reg::Zero, label);
+}
+
+// HeapPtr holds the control block for the whole run
+static std::shared_ptr<Code> control(uint32_t offset) {
+    return deref(to_expr(Reg::HeapPtr), offset);
+}
+
+static std::shared_ptr<Code>
+set_control(uint32_t offset, std::shared_ptr<Code> expr) {
+    return assign_to_address(to_expr(Reg::HeapPtr), expr, offset);
+}
+
+static std::shared_ptr<Code> control_address(uint32_t offset) {
+    return plus(to_expr(Reg::HeapPtr), int_literal(offset));
+}
+
+// address of the head of the list of free blocks of size bytes
+static std::shared_ptr<Code> size_list(std::shared_ptr<Variable> bytes) {
+    return plus(
+        to_expr(Reg::HeapPtr),
+        plus(bytes->to_expr(), int_literal(SIZE_LISTS))
+    );
+}
+
+// takes the linked free block off its list, clobbers link and next
+static std::shared_ptr<Code> unlink(
+    std::shared_ptr<Variable> block,
+    std::shared_ptr<Variable> link,
+    std::shared_ptr<Variable> next
+) {
+    return make_block(
+        {assign(link, deref(block->to_expr(), LINKED_FROM)),
+         assign(next, deref(block->to_expr(), NEXT)),
+         assign_to_address(link->to_expr(), next->to_expr()),
+         make_if(
+             next->to_expr(),
+             op::ne_cmp(),
+             to_expr(Reg::Zero),
+             assign_to_address(next->to_expr(), link->to_expr(), LINKED_FROM)
+         )}
+    );
+}
+
+// marks the block free and pushes it on the list for its size, linked
+// blocks get their footer and the block after them is told, clobbers link
+// and next
+static std::shared_ptr<Code> insert(
+    std::shared_ptr<Variable> block,
+    std::shared_ptr<Variable> size,
+    std::shared_ptr<Variable> link,
+    std::shared_ptr<Variable> next
+) {
+    auto push = [&](uint32_t top) {
+        return make_block(
+            {assign_to_address(block->to_expr(), negate(size->to_expr())),
+             assign(next, deref(link->to_expr())),
+             assign_to_address(block->to_expr(), next->to_expr(), NEXT),
+             make_if(
+                 size->to_expr(),
+                 op::ge_cmp(),
+                 int_literal(LINKED_BYTES),
+                 make_block(
+                     {assign_to_address(
+                          block->to_expr(),
+                          link->to_expr(),
+                          LINKED_FROM
+                      ),
+                      make_if(
+                          next->to_expr(),
+                          op::ne_cmp(),
+                          to_expr(Reg::Zero),
+                          assign_to_address(
+                              next->to_expr(),
+                              plus(block->to_expr(), int_literal(NEXT)),
+                              LINKED_FROM
+                          )
+                      ),
+                      // footer
+                      assign_to_address(
+                          plus(block->to_expr(), size->to_expr()),
+                          size->to_expr()
+                      ),
+                      assign(
+                          next,
+                          plus(
+                              plus(block->to_expr(), int_literal(4)),
+                              size->to_expr()
+                          )
+                      ),
+                      // it may know already when block took in a free
+                      // block before it
+                      make_if(
+                          deref(next->to_expr()),
+                          op::gt_cmp(),
+                          to_expr(Reg::Zero),
+                          assign_to_address(
+                              next->to_expr(),
+                              plus(
+                                  minus(
+                                      deref(next->to_expr()),
+                                      remainder_constant(
+                                          deref(next->to_expr()),
+                                          4
+                                      )
+                                  ),
+                                  int_literal(PREV_FREE)
+                              )
+                          )
+                      )}
+                 )
+             ),
+             assign_to_address(link->to_expr(), block->to_expr()),
+             make_if(
+                 size->to_expr(),
+                 op::gt_cmp(),
+                 control(top),
+                 set_control(top, size->to_expr())
+             )}
+        );
+    };
+
+    return make_if(
+        size->to_expr(),
+        op::le_cmp(),
+        int_literal(SMALL_BYTES),
+        make_block({assign(link, size_list(size)), push(SMALL_TOP)}),
+        make_block({assign(link, control_address(LARGE)), push(LARGE_TOP)})
+    );
+}
 
 std::shared_ptr<Code> init_heap(std::shared_ptr<Code> heap_start) {
     return make_block(
-        {heap_start, make_add(Reg::HeapPtr, Reg::Result, Reg::Zero)}
+        {heap_start,
+         make_add(Reg::HeapPtr, Reg::Result, Reg::Zero),
+         set_control(BUMP, control_address(CONTROL_BYTES))}
     );
 }
 
-std::shared_ptr<TypedProcedure>
-make_heap_allocate(std::shared_ptr<Code> heap_start) {
+std::shared_ptr<TypedProcedure> make_heap_allocate() {
     std::shared_ptr<Variable> num_bytes =
         std::make_shared<Variable>("num bytes to heap allocate");
     std::shared_ptr<Variable> result =
         std::make_shared<Variable>("pointer to heap block");
+    std::shared_ptr<Variable> size =
+        std::make_shared<Variable>("size of free block");
+    std::shared_ptr<Variable> link =
+        std::make_shared<Variable>("address of link to free block");
+    std::shared_ptr<Variable> next =
+        std::make_shared<Variable>("next free block");
+    std::shared_ptr<Variable> rest =
+        std::make_shared<Variable>("rest of split block");
+    std::shared_ptr<Variable> rest_size =
+        std::make_shared<Variable>("size of rest of split block");
     std::shared_ptr<Procedure> proc = std::make_shared<Procedure>(
         "heap allocate",
         std::vector<std::shared_ptr<Variable>> {num_bytes}
     );
-    std::shared_ptr<Label> loop_start = std::make_shared<Label>("loop start");
-    std::shared_ptr<Label> loop_end = std::make_shared<Label>("loop end");
-    proc->code = make_scope(
-        {result},
-        {heap_start,
-         make_add(Reg::HeapPtr, Reg::Result, Reg::Zero),
-         make_define(loop_start),
+    std::shared_ptr<Label> found = std::make_shared<Label>("found block");
+    std::shared_ptr<Label> done = std::make_shared<Label>("allocated");
+
+    // the smallest free block at least num_bytes large, sizes above
+    // SMALL_TOP are known to have none
+    auto small = make_block(
+        {assign(size, num_bytes->to_expr()),
+         make_while(
+             size->to_expr(),
+             op::le_cmp(),
+             control(SMALL_TOP),
+             make_block(
+                 {assign(link, size_list(size)),
+                  assign(result, deref(link->to_expr())),
+                  make_if(
+                      result->to_expr(),
+                      op::ne_cmp(),
+                      to_expr(Reg::Zero),
+                      jump(found)
+                  ),
+                  assign(size, plus(size->to_expr(), int_literal(4)))}
+             )
+         ),
          make_if(
-             bin_op(
+             num_bytes->to_expr(),
+             op::le_cmp(),
+             control(SMALL_TOP),
+             set_control(
+                 SMALL_TOP,
+                 minus(num_bytes->to_expr(), int_literal(4))
+             )
+         )}
+    );
+
+    // the first free block large enough, a search that fails records the
+    // largest block it passed
+    auto large = make_if(
+        num_bytes->to_expr(),
+        op::le_cmp(),
+        control(LARGE_TOP),
+        make_block(
+            {assign(link, control_address(LARGE)),
+             assign(size, to_expr(Reg::Zero)),
+             make_while(
+                 deref(link->to_expr()),
+                 op::ne_cmp(),
                  to_expr(Reg::Zero),
-                 op::minus(),
-                 deref(to_expr(Reg::HeapPtr))
+                 make_block(
+                     {assign(result, deref(link->to_expr())),
+                      make_if(
+                          negate(deref(result->to_expr())),
+                          op::ge_cmp(),
+                          num_bytes->to_expr(),
+                          jump(found)
+                      ),
+                      make_if(
+                          negate(deref(result->to_expr())),
+                          op::gt_cmp(),
+                          size->to_expr(),
+                          assign(size, negate(deref(result->to_expr())))
+                      ),
+                      assign(
+                          link,
+                          plus(result->to_expr(), int_literal(NEXT))
+                      )}
+                 )
              ),
+             set_control(LARGE_TOP, size->to_expr())}
+        )
+    );
+
+    // takes the found block off its list, a block with room for another
+    // linked block after num_bytes is split and the rest stays free
+    auto take = make_block(
+        {assign(size, negate(deref(result->to_expr()))),
+         make_if(
+             size->to_expr(),
              op::ge_cmp(),
-             num_bytes->to_expr(),
+             int_literal(LINKED_BYTES),
+             unlink(result, link, next),
+             assign_to_address(
+                 link->to_expr(),
+                 deref(result->to_expr(), NEXT)
+             )
+         ),
+         assign(
+             rest_size,
+             minus(
+                 minus(size->to_expr(), num_bytes->to_expr()),
+                 int_literal(4)
+             )
+         ),
+         make_if(
+             rest_size->to_expr(),
+             op::ge_cmp(),
+             int_literal(LINKED_BYTES),
              make_block(
-                 {bin_op(
-                      to_expr(Reg::Zero),
-                      op::minus(),
-                      deref(to_expr(Reg::HeapPtr))
+                 {assign_to_address(result->to_expr(), num_bytes->to_expr()),
+                  assign(
+                      rest,
+                      plus(
+                          plus(result->to_expr(), int_literal(4)),
+                          num_bytes->to_expr()
+                      )
+                  ),
+                  insert(rest, rest_size, link, next)}
+             ),
+             make_block(
+                 {assign_to_address(result->to_expr(), size->to_expr()),
+                  // the block after is no longer preceded by a free one
+                  assign(
+                      next,
+                      plus(
+                          plus(result->to_expr(), int_literal(4)),
+                          size->to_expr()
+                      )
                   ),
-                  make_sw(Reg::Result, 0, Reg::HeapPtr),
-                  make_write(result, Reg::HeapPtr),
-                  make_beq(Reg::Zero, Reg::Zero, loop_end)}
+                  make_if(
+                      size->to_expr(),
+                      op::ge_cmp(),
+                      int_literal(LINKED_BYTES),
+                      make_if(
+                          deref(next->to_expr()),
+                          op::gt_cmp(),
+                          to_expr(Reg::Zero),
+                          assign_to_address(
+                              next->to_expr(),
+                              minus(
+                                  deref(next->to_expr()),
+                                  remainder_constant(
+                                      deref(next->to_expr()),
+                                      4
+                                  )
+                              )
+                          )
+                      )
+                  )}
              )
+         )}
+    );
+
+    proc->code = make_scope(
+        {result, size, link, next, rest, rest_size},
+        {// every block has room for the link of a free list
+         make_if(
+             num_bytes->to_expr(),
+             op::lt_cmp(),
+             int_literal(4),
+             assign(num_bytes, int_literal(4))
          ),
          make_if(
-             deref(to_expr(Reg::HeapPtr)),
-             op::eq_cmp(),
+             num_bytes->to_expr(),
+             op::le_cmp(),
+             int_literal(SMALL_BYTES),
+             small,
+             large
+         ),
+         // nothing free fits, the block comes from the never used space
+         assign(result, control(BUMP)),
+         assign_to_address(result->to_expr(), num_bytes->to_expr()),
+         set_control(
+             BUMP,
+             plus(
+                 plus(result->to_expr(), int_literal(4)),
+                 num_bytes->to_expr()
+             )
+         ),
+         jump(done),
+         make_define(found),
+         take,
+         make_define(done),
+         plus(result->to_expr(), int_literal(4))}
+    );
+
+    std::shared_ptr<TypedVariable> typed_var = std::make_shared<TypedVariable>(
+        num_bytes,
+        std::make_shared<NLTypeI32>()
+    );
+    return std::make_shared<TypedProcedure>(
+        proc,
+        std::make_shared<NLTypeNone>(),
+        std::vector<std::shared_ptr<TypedVariable>> {typed_var}
+    );
+}
+
+std::shared_ptr<TypedProcedure> make_heap_free() {
+    std::shared_ptr<Variable> mem_addr =
+        std::make_shared<Variable>("address to free");
+    std::shared_ptr<Variable> block =
+        std::make_shared<Variable>("block to free");
+    std::shared_ptr<Variable> size =
+        std::make_shared<Variable>("size of block to free");
+    std::shared_ptr<Variable> neighbour =
+        std::make_shared<Variable>("neighbouring block");
+    std::shared_ptr<Variable> link =
+        std::make_shared<Variable>("address of free list link");
+    std::shared_ptr<Variable> next =
+        std::make_shared<Variable>("next free block");
+    std::shared_ptr<Procedure> proc = std::make_shared<Procedure>(
+        "heap free",
+        std::vector<std::shared_ptr<Variable>> {mem_addr}
+    );
+    std::shared_ptr<Label> done = std::make_shared<Label>("freed");
+
+    proc->code = make_scope(
+        {block, size, neighbour, link, next},
+        {assign(block, minus(mem_addr->to_expr(), int_literal(4))),
+         assign(size, deref(block->to_expr())),
+         // blocks already free are left alone
+         make_if(size->to_expr(), op::le_cmp(), to_expr(Reg::Zero), jump(done)),
+         // merge with a free block before, found through its footer
+         make_if(
+             remainder_constant(size->to_expr(), 4),
+             op::ne_cmp(),
              to_expr(Reg::Zero),
              make_block(
-                 {num_bytes->to_expr(),
-                  make_sw(Reg::Result, 0, Reg::HeapPtr),
-                  make_write(result, Reg::HeapPtr),
-                  make_beq(Reg::Zero, Reg::Zero, loop_end)}
+                 {assign(
+                      size,
+                      minus(size->to_expr(), int_literal(PREV_FREE))
+                  ),
+                  assign(
+                      neighbour,
+                      minus(
+                          minus(block->to_expr(), int_literal(4)),
+                          deref(minus(block->to_expr(), int_literal(4)))
+                      )
+                  ),
+                  unlink(neighbour, link, next),
+                  assign(
+                      size,
+                      plus(
+                          plus(size->to_expr(), int_literal(4)),
+                          negate(deref(neighbour->to_expr()))
+                      )
+                  ),
+                  assign(block, neighbour->to_expr())}
              )
          ),
+         // a block ending at the never used space joins it
+         assign(
+             neighbour,
+             plus(plus(block->to_expr(), int_literal(4)), size->to_expr())
+         ),
          make_if(
-             deref(to_expr(Reg::HeapPtr)),
-             op::lt_cmp(),
-             to_expr(Reg::Zero),
-             bin_op(
-                 to_expr(Reg::Zero),
-                 op::minus(),
-                 deref(to_expr(Reg::HeapPtr))
-             ),
-             deref(to_expr(Reg::HeapPtr))
+             neighbour->to_expr(),
+             op::eq_cmp(),
+             control(BUMP),
+             make_block({set_control(BUMP, block->to_expr()), jump(done)})
          ),
-         make_add(Reg::HeapPtr, Reg::HeapPtr, Reg::Result),
-         int_literal(4),
-         make_add(Reg::HeapPtr, Reg::HeapPtr, Reg::Result),
-         make_beq(Reg::Zero, Reg::Zero, loop_start),
-         make_define(loop_end),
-         bin_op(result->to_expr(), op::plus(), int_literal(4))}
+         // merge with a linked free block after
+         make_if(
+             deref(neighbour->to_expr()),
+             op::le_cmp(),
+             int_literal(-(int32_t)LINKED_BYTES),
+             make_block(
+                 {unlink(neighbour, link, next),
+                  assign(
+                      size,
+                      plus(
+                          plus(size->to_expr(), int_literal(4)),
+                          negate(deref(neighbour->to_expr()))
+                      )
+                  )}
+             )
+         ),
+         insert(block, size, link, next),
+         make_define(done)}
     );
 
     std::shared_ptr<TypedVariable> typed_var = std::make_shared<TypedVariable>(
-        num_bytes,
-        std::make_shared<NLTypeI32>()
+        mem_addr,
+        std::make_shared<NLTypeNone>()
     );
     return std::make_shared<TypedProcedure>(
         proc,
@@ -106,20 +506,118 @@ make_heap_allocate(std::shared_ptr<Code> heap_start) {
     );
 }
 
-std::shared_ptr<TypedProcedure> make_heap_free(std::shared_ptr<Code> heap_start
-) {
+// with the collector, ScratchPtrForGC holds its control block, laid out as
+// GcControl in the gc module, and objects are bumped from HeapPtr up to
+// FromSpaceEnd
+static const uint32_t GC_BUMP = 0;
+static const uint32_t GC_LIMIT = 4;
+static const uint32_t GC_STACK_TOP = 8;
+// layout and size words before every object, the size just before the data
+// as with the default heap
+static const uint32_t GC_HEADER_BYTES = 8;
+
+static std::shared_ptr<Code>
+set_gc_control(uint32_t offset, std::shared_ptr<Code> expr) {
+    return assign_to_address(to_expr(Reg::ScratchPtrForGC), expr, offset);
+}
+
+static std::shared_ptr<Code> set_reg(Reg reg, std::shared_ptr<Code> expr) {
+    return make_block({expr, make_add(reg, Reg::Result, Reg::Zero)});
+}
+
+std::shared_ptr<Code> init_gc_heap(std::shared_ptr<Code> heap_start) {
+    // the first allocation finds no room and sets up the pages
+    return make_block(
+        {set_reg(Reg::ScratchPtrForGC, heap_start),
+         set_gc_control(GC_STACK_TOP, to_expr(Reg::StackPtr)),
+         make_add(Reg::HeapPtr, Reg::Zero, Reg::Zero),
+         make_add(Reg::FromSpaceEnd, Reg::Zero, Reg::Zero)}
+    );
+}
+
+std::shared_ptr<TypedProcedure>
+make_gc_allocate(std::shared_ptr<Procedure> refill) {
+    std::shared_ptr<Variable> num_bytes =
+        std::make_shared<Variable>("num bytes to heap allocate");
+    std::shared_ptr<Variable> layout =
+        std::make_shared<Variable>("layout of heap object");
+    std::shared_ptr<Variable> result =
+        std::make_shared<Variable>("pointer to heap object");
+    std::shared_ptr<Procedure> proc = std::make_shared<Procedure>(
+        "heap allocate",
+        std::vector<std::shared_ptr<Variable>> {num_bytes, layout}
+    );
+
+    auto bump = [&]() {
+        return set_reg(
+            Reg::HeapPtr,
+            plus(
+                plus(result->to_expr(), int_literal(GC_HEADER_BYTES)),
+                num_bytes->to_expr()
+            )
+        );
+    };
+    proc->code = make_scope(
+        {result},
+        {// a zero size would end the region
+         make_if(
+             num_bytes->to_expr(),
+             op::lt_cmp(),
+             int_literal(4),
+             assign(num_bytes, int_literal(4))
+         ),
+         assign(result, to_expr(Reg::HeapPtr)),
+         bump(),
+         make_if(
+             to_expr(Reg::HeapPtr),
+             op::gt_cmp(),
+             to_expr(Reg::FromSpaceEnd),
+             make_block(
+                 {set_gc_control(GC_BUMP, result->to_expr()),
+                  set_gc_control(GC_LIMIT, to_expr(Reg::FromSpaceEnd)),
+                  make_call(
+                      refill,
+                      {to_expr(Reg::ScratchPtrForGC),
+                       num_bytes->to_expr(),
+                       to_expr(Reg::StackPtr)}
+                  ),
+                  set_reg(
+                      Reg::FromSpaceEnd,
+                      deref(to_expr(Reg::ScratchPtrForGC), GC_LIMIT)
+                  ),
+                  assign(
+                      result,
+                      deref(to_expr(Reg::ScratchPtrForGC), GC_BUMP)
+                  ),
+                  bump()}
+             )
+         ),
+         assign_to_address(result->to_expr(), layout->to_expr()),
+         assign_to_address(result->to_expr(), num_bytes->to_expr(), 4),
+         plus(result->to_expr(), int_literal(GC_HEADER_BYTES))}
+    );
+
+    std::vector<std::shared_ptr<TypedVariable>> typed_vars = {
+        std::make_shared<TypedVariable>(
+            num_bytes,
+            std::make_shared<NLTypeI32>()
+        ),
+        std::make_shared<TypedVariable>(layout, std::make_shared<NLTypeI32>())};
+    return std::make_shared<TypedProcedure>(
+        proc,
+        std::make_shared<NLTypeNone>(),
+        typed_vars
+    );
+}
+
+std::shared_ptr<TypedProcedure> make_gc_free() {
     std::shared_ptr<Variable> mem_addr =
         std::make_shared<Variable>("address to free");
     std::shared_ptr<Procedure> proc = std::make_shared<Procedure>(
         "heap free",
         std::vector<std::shared_ptr<Variable>> {mem_addr}
     );
-    proc->code = make_block({
-        mem_addr->to_expr(),
-        make_lw(Reg::Scratch, (uint16_t)(-4), Reg::Result),
-        make_sub(Reg::Scratch, Reg::Zero, Reg::Scratch),
-        make_sw(Reg::Scratch, (uint16_t)(-4), Reg::Result),
-    });
+    proc->code = make_block({});
 
     std::shared_ptr<TypedVariable> typed_var = std::make_shared<TypedVariable>(
         mem_addr,
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "code.h"
+#include "procedure.h"
 #include "symbol_table.h"
 #include "typed_procedure.h"
 
@@ -12,8 +13,21 @@ const std::string heap_allocate_id = "heap_allocate";
 const std::string heap_free_id = "heap_free";
 const std::string heap_module_id = "heap";
 
+// points HeapPtr at the heap's control block, which heap_start loads into
+// Result, for the rest of the run
 std::shared_ptr<Code> init_heap(std::shared_ptr<Code> heap_start);
+// allocations reuse a free block of the same or the next larger sizes up to
+// 128 bytes, or the first large enough block above that, and otherwise take
+// never used space. What a reused block has to spare is split off and stays
+// free
+std::shared_ptr<TypedProcedure> make_heap_allocate();
+// freed blocks merge with free neighbours and with the never used space
+std::shared_ptr<TypedProcedure> make_heap_free();
+
+// with the collector allocations bump HeapPtr and call refill from the gc
+// module when they reach FromSpaceEnd, heap_allocate takes the object's
+// pointer layout after its size and heap_free does nothing
+std::shared_ptr<Code> init_gc_heap(std::shared_ptr<Code> heap_start);
 std::shared_ptr<TypedProcedure>
-make_heap_allocate(std::shared_ptr<Code> heap_start);
-std::shared_ptr<TypedProcedure> make_heap_free(std::shared_ptr<Code> heap_start
-);
+make_gc_allocate(std::shared_ptr<Procedure> refill);
+std::shared_ptr<TypedProcedure> make_gc_free();
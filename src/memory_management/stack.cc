@@ -14,7 +14,8 @@ std::shared_ptr<Code> stack::allocate(std::shared_ptr<Chunk> chunk) {
         make_word(chunk->bytes),
         make_sub(Reg::StackPtr, Reg::StackPtr, Reg::Scratch),
         make_add(Reg::Result, Reg::StackPtr, Reg::Zero),
-        chunk->initialize()};
+        make_sw(Reg::Scratch, 0, Reg::Result),
+        chunk->clear(Reg::Result)};
     return make_block(result);
 }
 
@@ -24,3 +25,11 @@ std::shared_ptr<Code> stack::pop() {
         make_add(Reg::StackPtr, Reg::StackPtr, Reg::Scratch)};
     return make_block(result);
 }
+
+std::shared_ptr<Code> stack::pop(std::shared_ptr<Chunk> chunk) {
+    std::vector<std::shared_ptr<Code>> result = {
+        make_lis(Reg::Scratch3),
+        make_word(chunk->bytes),
+        make_add(Reg::StackPtr, Reg::StackPtr, Reg::Scratch3)};
+    return make_block(result);
+}
@@ -9,4 +9,6 @@
 namespace stack {
 std::shared_ptr<Code> allocate(std::shared_ptr<Chunk> chunk);
 std::shared_ptr<Code> pop();
+// pops chunk without reading its size back from the stack
+std::shared_ptr<Code> pop(std::shared_ptr<Chunk> chunk);
 }  // namespace stack
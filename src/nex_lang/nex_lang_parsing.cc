@@ -39,6 +39,13 @@ static const std::map<NonTerminal, std::vector<Production>> productions = {
         Terminal::SEMI}},
       {NonTerminal::typedecl,
        {Terminal::STRUCT,
+        Terminal::ID,
+        Terminal::LBRACE,
+        NonTerminal::typestmts,
+        Terminal::RBRACE}},
+      {NonTerminal::typedecl,
+       {Terminal::COMPACT,
+        Terminal::STRUCT,
         Terminal::ID,
         Terminal::LBRACE,
         NonTerminal::typestmts,
@@ -212,6 +219,8 @@ static const std::map<NonTerminal, std::vector<Production>> productions = {
            NonTerminal::optargs,
            Terminal::RPAREN}},
          {NonTerminal::exprp9, {Terminal::NEW, NonTerminal::typeinit}},
+         {NonTerminal::exprp9,
+          {Terminal::NEW, NonTerminal::typeinit, Terminal::IN, Terminal::ID}},
          {NonTerminal::exprp9,
           {NonTerminal::exprp9,
            Terminal::LBRACKET,
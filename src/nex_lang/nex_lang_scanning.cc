@@ -172,7 +172,8 @@ static const std::map<std::string, Terminal> keywords = {
     {"bool", Terminal::BOOL},     {"char", Terminal::CHAR},
     {"none", Terminal::CHAR},     {"true", Terminal::TRUE},
     {"false", Terminal::FALSE},   {"new", Terminal::NEW},
-    {"delete", Terminal::DELETE},
+    {"delete", Terminal::DELETE}, {"compact", Terminal::COMPACT},
+    {"in", Terminal::IN},
 };
 
 std::vector<Token> scan(std::string_view input) {
@@ -58,15 +58,18 @@ void extract_typedecl(ASTNode root, ProgramContext& program_context) {
             visit_type(type_node, program_context);
 
         program_context.type_table[name] = nl_type;
-    } else if (prod == std::vector<State> {NonTerminal::typedecl, Terminal::STRUCT, Terminal::ID, Terminal::LBRACE, NonTerminal::typestmts, Terminal::RBRACE}) {
-        ASTNode id = root.children.at(1);
+    } else if (prod == std::vector<State> {NonTerminal::typedecl, Terminal::STRUCT, Terminal::ID, Terminal::LBRACE, NonTerminal::typestmts, Terminal::RBRACE} || prod == std::vector<State> {NonTerminal::typedecl, Terminal::COMPACT, Terminal::STRUCT, Terminal::ID, Terminal::LBRACE, NonTerminal::typestmts, Terminal::RBRACE}) {
+        bool compact = prod.size() == 7;
+        size_t start = compact ? 1 : 0;
+
+        ASTNode id = root.children.at(start + 1);
         std::string name = id.lexeme;
 
-        ASTNode typestmts = root.children.at(3);
+        ASTNode typestmts = root.children.at(start + 3);
         auto child_result = extract_typestmts(typestmts, program_context);
 
         std::shared_ptr<NLType> nl_type =
-            std::make_shared<NLTypeStruct>(name, child_result);
+            std::make_shared<NLTypeStruct>(name, child_result, compact);
         program_context.type_table[name] = nl_type;
     } else {
         std::cerr << "Invalid production found while extracting typedecl."
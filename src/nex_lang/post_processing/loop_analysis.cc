@@ -0,0 +1,467 @@
+
+#include "loop_analysis.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+
+#include "nl_type.h"
+#include "nl_type_i32.h"
+#include "nl_type_ptr.h"
+#include "nl_type_struct.h"
+#include "state.h"
+#include "typed_variable.h"
+
+namespace {
+const std::set<NonTerminal> expr_non_terminals = {
+    NonTerminal::expr,
+    NonTerminal::exprp1,
+    NonTerminal::exprp2,
+    NonTerminal::exprp3,
+    NonTerminal::exprp4,
+    NonTerminal::exprp5,
+    NonTerminal::exprp6,
+    NonTerminal::exprp7,
+    NonTerminal::exprp8,
+    NonTerminal::exprp9};
+
+bool is_expr(const ASTNode& node) {
+    return std::holds_alternative<NonTerminal>(node.state)
+        && expr_non_terminals.count(std::get<NonTerminal>(node.state));
+}
+
+// strips single child productions and parentheses off an expression
+ASTNode unwrap(ASTNode node) {
+    while (is_expr(node)) {
+        // copied out first, assigning a child to its parent would free it
+        ASTNode inner;
+        if (node.children.size() == 1 && is_expr(node.children.at(0))) {
+            inner = node.children.at(0);
+        } else if (node.get_production() == std::vector<State> {NonTerminal::exprp9, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN}) {
+            inner = node.children.at(1);
+        } else {
+            break;
+        }
+        node = inner;
+    }
+    return node;
+}
+
+bool is_id(ASTNode node) {
+    return node.get_production()
+        == std::vector<State> {NonTerminal::exprp9, Terminal::ID};
+}
+
+bool is_field(ASTNode node) {
+    return node.get_production() == std::vector<State> {NonTerminal::exprp9, Terminal::ID, Terminal::DOT, Terminal::ID};
+}
+
+bool is_index(ASTNode node) {
+    return node.get_production() == std::vector<State> {NonTerminal::exprp9, NonTerminal::exprp9, Terminal::LBRACKET, NonTerminal::expr, Terminal::RBRACKET};
+}
+
+bool is_deref(ASTNode node) {
+    return node.get_production()
+        == std::vector<State> {NonTerminal::exprp7, Terminal::STAR, NonTerminal::exprp8};
+}
+
+std::optional<int32_t> constant(ASTNode node) {
+    node = unwrap(node);
+    if (node.get_production()
+        == std::vector<State> {NonTerminal::exprp9, Terminal::NUM}) {
+        return stoi(node.children.at(0).lexeme);
+    }
+    if (node.get_production() == std::vector<State> {NonTerminal::exprp9, Terminal::MINUS, Terminal::NUM}) {
+        return -stoi(node.children.at(1).lexeme);
+    }
+    return std::nullopt;
+}
+
+struct Facts {
+    // declared inside the loop, shadowing anything outside of it
+    std::set<std::string> declared;
+    std::map<std::string, size_t> assigned;
+    std::set<std::string> stored_fields;
+    // targets of stores through indexing or dereferencing
+    std::vector<ASTNode> stored_through;
+    bool calls = false;
+    // field loads and array accesses, weighted by how often they run per
+    // iteration
+    std::vector<std::pair<ASTNode, double>> loads;
+    std::vector<std::pair<ASTNode, double>> accesses;
+};
+
+void collect(ASTNode node, double weight, Facts& facts);
+
+void collect_expr(ASTNode node, double weight, bool lvalue, Facts& facts) {
+    node = unwrap(node);
+    std::vector<State> prod = node.get_production();
+    if (is_field(node)) {
+        if (!lvalue) {
+            facts.loads.push_back({node, weight});
+        }
+    } else if (is_index(node)) {
+        facts.accesses.push_back({node, weight});
+        collect_expr(node.children.at(0), weight, false, facts);
+        collect_expr(node.children.at(2), weight, false, facts);
+    } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::ID, Terminal::LPAREN, NonTerminal::optargs, Terminal::RPAREN}) {
+        facts.calls = true;
+        collect(node.children.at(2), weight, facts);
+    } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::ID, Terminal::DOT, Terminal::ID, Terminal::LPAREN, NonTerminal::optargs, Terminal::RPAREN}) {
+        facts.calls = true;
+        collect(node.children.at(4), weight, facts);
+    } else {
+        collect(node, weight, facts);
+    }
+}
+
+// walks statements and anything else that is not an expression itself
+void collect(ASTNode node, double weight, Facts& facts) {
+    std::vector<State> prod = node.get_production();
+    if (is_expr(node)) {
+        for (auto& child : node.children) {
+            if (is_expr(child)) {
+                collect_expr(child, weight, false, facts);
+            } else {
+                collect(child, weight, facts);
+            }
+        }
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::LET, NonTerminal::vardef, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
+        facts.declared.insert(node.children.at(1).children.at(0).lexeme);
+        collect_expr(node.children.at(3), weight, false, facts);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::LET, Terminal::ID, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
+        facts.declared.insert(node.children.at(1).lexeme);
+        collect_expr(node.children.at(3), weight, false, facts);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, NonTerminal::expr, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
+        ASTNode lhs = unwrap(node.children.at(0));
+        if (is_id(lhs)) {
+            facts.assigned[lhs.children.at(0).lexeme] += 1;
+        } else if (is_field(lhs)) {
+            facts.stored_fields.insert(lhs.children.at(2).lexeme);
+        } else {
+            facts.stored_through.push_back(lhs);
+        }
+        collect_expr(lhs, weight, true, facts);
+        collect_expr(node.children.at(2), weight, false, facts);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::IF, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock, Terminal::ELSE, NonTerminal::stmtblock}) {
+        collect_expr(node.children.at(2), weight, false, facts);
+        collect(node.children.at(4), weight / 2, facts);
+        collect(node.children.at(6), weight / 2, facts);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::IF, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock}) {
+        collect_expr(node.children.at(2), weight, false, facts);
+        collect(node.children.at(4), weight / 2, facts);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::WHILE, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock}) {
+        // an inner loop runs its body several times per outer iteration
+        collect_expr(node.children.at(2), weight * 4, false, facts);
+        collect(node.children.at(4), weight * 4, facts);
+    } else {
+        for (auto& child : node.children) {
+            if (is_expr(child)) {
+                collect_expr(child, weight, false, facts);
+            } else {
+                collect(child, weight, facts);
+            }
+        }
+    }
+}
+
+std::shared_ptr<NLType> pointee(std::shared_ptr<NLType> nl_type) {
+    if (auto nl_type_ptr = std::dynamic_pointer_cast<NLTypePtr>(nl_type)) {
+        return nl_type_ptr->nl_type;
+    }
+    return nullptr;
+}
+
+// the type of an expression built from variables declared outside the
+// loop, field loads, indexing and dereferencing, otherwise null
+std::shared_ptr<NLType>
+simple_type(ASTNode node, SymbolTable& symbol_table, const Facts& facts) {
+    node = unwrap(node);
+    if (is_id(node)) {
+        std::string name = node.children.at(0).lexeme;
+        if (facts.declared.count(name) || !symbol_table.count({name, {}})) {
+            return nullptr;
+        }
+        if (auto typed_var = std::dynamic_pointer_cast<TypedVariable>(
+                symbol_table.at({name, {}})
+            )) {
+            return typed_var->nl_type;
+        }
+        return nullptr;
+    }
+    if (is_field(node)) {
+        auto nl_type_struct = std::dynamic_pointer_cast<NLTypeStruct>(
+            pointee(simple_type(node.children.at(0), symbol_table, facts))
+        );
+        if (!nl_type_struct) {
+            return nullptr;
+        }
+        for (auto& child_type : nl_type_struct->child_types) {
+            if (child_type.first == node.children.at(2).lexeme) {
+                return child_type.second;
+            }
+        }
+        return nullptr;
+    }
+    if (is_index(node)) {
+        return pointee(simple_type(node.children.at(0), symbol_table, facts));
+    }
+    if (is_deref(node)) {
+        return pointee(simple_type(node.children.at(1), symbol_table, facts));
+    }
+    return nullptr;
+}
+
+// finds the last statement of a statement block
+std::optional<ASTNode> last_stmt(ASTNode node) {
+    std::optional<ASTNode> last = std::nullopt;
+    for (auto& child : node.children) {
+        if (!std::holds_alternative<NonTerminal>(child.state)) {
+            continue;
+        }
+        NonTerminal non_terminal = std::get<NonTerminal>(child.state);
+        if (non_terminal == NonTerminal::stmt) {
+            last = child;
+        } else if (non_terminal == NonTerminal::stmts) {
+            if (auto rest = last_stmt(child)) {
+                last = rest;
+            }
+        }
+    }
+    return last;
+}
+
+// what frame_objects needs to know about the variables of a procedure
+struct Uses {
+    std::map<std::string, size_t> declared;
+    std::map<std::string, FrameObject> allocated;
+    // used in any other way than through the pointer they hold
+    std::set<std::string> escaping;
+};
+
+void collect_uses(ASTNode node, Uses& uses) {
+    std::vector<State> prod = node.get_production();
+    if (is_id(node)) {
+        uses.escaping.insert(node.children.at(0).lexeme);
+        return;
+    }
+    if (is_field(node)) {
+        return;
+    }
+    if (is_index(node) && is_id(node.children.at(0))) {
+        collect_uses(node.children.at(2), uses);
+        return;
+    }
+    if (is_deref(node) && is_id(unwrap(node.children.at(1)))) {
+        return;
+    }
+    if (prod == std::vector<State> {NonTerminal::stmt, Terminal::DELETE, NonTerminal::expr, Terminal::SEMI}
+        && is_id(unwrap(node.children.at(1)))) {
+        return;
+    }
+    if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::AMPERSAND, Terminal::ID}) {
+        uses.escaping.insert(node.children.at(1).lexeme);
+    } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::ID, Terminal::DOT, Terminal::ID, Terminal::LPAREN, NonTerminal::optargs, Terminal::RPAREN}) {
+        uses.escaping.insert(node.children.at(0).lexeme);
+    } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::NEW, NonTerminal::typeinit, Terminal::IN, Terminal::ID}) {
+        uses.escaping.insert(node.children.at(3).lexeme);
+    } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::LET, NonTerminal::vardef, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}
+               || prod == std::vector<State> {NonTerminal::stmt, Terminal::LET, Terminal::ID, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
+        ASTNode id = node.children.at(1);
+        std::string name = id.children.empty() ? id.lexeme
+                                               : id.children.at(0).lexeme;
+        uses.declared[name] += 1;
+
+        ASTNode expr = unwrap(node.children.at(3));
+        if (expr.get_production()
+            == std::vector<State> {NonTerminal::exprp9, Terminal::NEW, NonTerminal::typeinit}) {
+            ASTNode typeinit = expr.children.at(1);
+            std::optional<int32_t> count = 1;
+            if (typeinit.children.size() > 1) {
+                count = constant(typeinit.children.at(2));
+            }
+            if (count && *count >= 0) {
+                uses.allocated[name] =
+                    FrameObject {typeinit.children.at(0), (uint32_t)*count};
+            }
+        }
+    }
+    for (auto& child : node.children) {
+        collect_uses(child, uses);
+    }
+}
+}  // namespace
+
+std::string access_key(ASTNode root) {
+    root = unwrap(root);
+    if (is_id(root)) {
+        return root.children.at(0).lexeme;
+    }
+    if (is_field(root)) {
+        return root.children.at(0).lexeme + "." + root.children.at(2).lexeme;
+    }
+    if (is_index(root)) {
+        std::string base = access_key(root.children.at(0));
+        std::string index = access_key(root.children.at(2));
+        if (base.empty() || index.empty()) {
+            return "";
+        }
+        return base + "[" + index + "]";
+    }
+    return "";
+}
+
+std::set<std::string> address_taken(ASTNode root) {
+    std::set<std::string> result;
+    if (root.get_production()
+        == std::vector<State> {NonTerminal::exprp9, Terminal::AMPERSAND, Terminal::ID}) {
+        result.insert(root.children.at(1).lexeme);
+    }
+    for (auto& child : root.children) {
+        result.merge(address_taken(child));
+    }
+    return result;
+}
+
+std::map<std::string, FrameObject> frame_objects(ASTNode root) {
+    Uses uses;
+    collect_uses(root, uses);
+
+    // a name declared twice may hold either object where it is used
+    std::map<std::string, FrameObject> result;
+    for (auto& [name, frame_object] : uses.allocated) {
+        if (uses.declared.at(name) == 1 && !uses.escaping.count(name)) {
+            result.insert({name, frame_object});
+        }
+    }
+    return result;
+}
+
+LoopPlan plan_loop(
+    ASTNode cond,
+    ASTNode body,
+    SymbolTable& symbol_table,
+    const std::set<std::string>& address_taken
+) {
+    Facts facts;
+    collect_expr(cond, 1, false, facts);
+    collect(body, 1, facts);
+
+    auto invariant = [&](std::string name) {
+        return !facts.declared.count(name) && !facts.assigned.count(name)
+            && !address_taken.count(name);
+    };
+
+    LoopPlan plan;
+
+    // a field keeps its value unless the loop stores to a field of that name
+    // or stores a value of its type through a pointer; calls could do either
+    std::set<std::string> invariant_keys;
+    std::map<std::string, size_t> load_counts;
+    for (auto& [load, weight] : facts.loads) {
+        std::string key = access_key(load);
+        load_counts[key] += 1;
+        if (invariant_keys.count(key) || facts.calls
+            || !invariant(load.children.at(0).lexeme)
+            || facts.stored_fields.count(load.children.at(2).lexeme)) {
+            continue;
+        }
+        auto field_type = simple_type(load, symbol_table, facts);
+        if (!field_type) {
+            continue;
+        }
+        bool aliased = false;
+        for (auto& target : facts.stored_through) {
+            auto stored_type = simple_type(target, symbol_table, facts);
+            aliased |= !stored_type || *stored_type == *field_type;
+        }
+        if (!aliased) {
+            invariant_keys.insert(key);
+            plan.invariant_loads.push_back(load);
+        }
+    }
+
+    // the induction variable is stepped by a constant as the last statement
+    std::optional<ASTNode> last = last_stmt(body);
+    if (!last
+        || last->get_production() != std::vector<State> {NonTerminal::stmt, NonTerminal::expr, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
+        return plan;
+    }
+    ASTNode lhs = unwrap(last->children.at(0));
+    ASTNode rhs = unwrap(last->children.at(2));
+    if (!is_id(lhs) || rhs.children.size() != 3) {
+        return plan;
+    }
+    std::string name = lhs.children.at(0).lexeme;
+    std::vector<State> rhs_prod = rhs.get_production();
+    ASTNode left = rhs.children.at(0);
+    ASTNode right = rhs.children.at(2);
+    std::optional<int32_t> step = std::nullopt;
+    if (rhs_prod == std::vector<State> {NonTerminal::exprp5, NonTerminal::exprp5, Terminal::PLUS, NonTerminal::exprp6}) {
+        if (access_key(left) == name) {
+            step = constant(right);
+        } else if (access_key(right) == name) {
+            step = constant(left);
+        }
+    } else if (rhs_prod == std::vector<State> {NonTerminal::exprp5, NonTerminal::exprp5, Terminal::MINUS, NonTerminal::exprp6}) {
+        if (access_key(left) == name && constant(right)) {
+            step = -*constant(right);
+        }
+    }
+    auto var_type = simple_type(lhs, symbol_table, facts);
+    if (!step || !var_type || *var_type != NLTypeI32 {}
+        || facts.assigned.at(name) != 1 || address_taken.count(name)) {
+        return plan;
+    }
+
+    // accesses through a pointer the loop keeps, which pay for updating
+    // their own pointer once they run about once per iteration
+    std::map<std::string, double> weights;
+    std::map<std::string, size_t> occurrences;
+    std::map<std::string, ASTNode> nodes;
+    std::vector<std::string> order;
+    for (auto& [access, weight] : facts.accesses) {
+        ASTNode base = unwrap(access.children.at(0));
+        std::string base_key = access_key(base);
+        bool stable_base = (is_id(base) && invariant(base_key))
+            || (is_field(base) && invariant_keys.count(base_key));
+        if (access_key(access.children.at(2)) != name || !stable_base
+            || !simple_type(access, symbol_table, facts)) {
+            continue;
+        }
+        std::string key = access_key(access);
+        if (!nodes.count(key)) {
+            nodes.emplace(key, access);
+            order.push_back(key);
+        }
+        weights[key] += weight;
+        occurrences[key] += 1;
+    }
+
+    std::map<std::string, size_t> base_counts;
+    for (auto& key : order) {
+        if (weights.at(key) >= 1) {
+            plan.induction_accesses.push_back(nodes.at(key));
+            std::string base_key = access_key(nodes.at(key).children.at(0));
+            base_counts[base_key] += occurrences.at(key);
+        }
+    }
+    if (plan.induction_accesses.empty()) {
+        return plan;
+    }
+    plan.induction_var = name;
+    plan.step = *step;
+
+    // loads only feeding induction pointers need no hoisting of their own
+    std::vector<ASTNode> loads;
+    for (auto& load : plan.invariant_loads) {
+        std::string key = access_key(load);
+        if (load_counts.at(key) > base_counts[key]) {
+            loads.push_back(load);
+        }
+    }
+    plan.invariant_loads = loads;
+    return plan;
+}
@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ast_node.h"
+#include "symbol_table.h"
+#include "typed_procedure.h"
+
+// what can be moved out of a while loop or strength reduced
+struct LoopPlan {
+    // field loads like self.size whose value the loop cannot change
+    std::vector<ASTNode> invariant_loads;
+    // accesses like data[i] through an invariant pointer indexed by the
+    // induction variable, which can follow i with a pointer of their own
+    std::vector<ASTNode> induction_accesses;
+    // incremented by step as the last statement of every iteration and
+    // assigned nowhere else in the loop
+    std::string induction_var;
+    int32_t step = 0;
+};
+
+// the name a hoisted load or induction pointer is entered into the symbol
+// table under, never a valid identifier
+std::string access_key(ASTNode root);
+
+// variables whose address is taken anywhere in root
+std::set<std::string> address_taken(ASTNode root);
+
+// lets in root of a new object of constant size whose pointer is only
+// dereferenced, indexed, has its fields accessed or is deleted, and so
+// never outlives the procedure
+std::map<std::string, FrameObject> frame_objects(ASTNode root);
+
+LoopPlan plan_loop(
+    ASTNode cond,
+    ASTNode body,
+    SymbolTable& symbol_table,
+    const std::set<std::string>& address_taken
+);
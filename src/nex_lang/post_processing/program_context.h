@@ -1,10 +1,29 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <string>
+
+#include "label.h"
 #include "module_table.h"
+#include "profile.h"
 #include "type_table.h"
 
 struct ProgramContext {
     ModuleTable module_table;
     TypeTable type_table;
+    // string literals already placed in static data, shared by all modules
+    std::map<std::string, std::shared_ptr<Label>> string_literals;
+    // store chars one per byte, needs byte loads and stores beyond the base
+    // instruction set
+    bool packed_chars = false;
+    // objects are garbage collected, each records where its pointers are
+    bool gc = false;
+    // objects that never outlive their function are placed in its frame
+    bool frame_objects = true;
+    // pointer layouts of element types already placed in static data
+    std::map<std::string, std::shared_ptr<Label>> gc_layouts;
+    // counts from earlier runs, empty unless compiling with a profile
+    Profile profile;
 };
@@ -0,0 +1,122 @@
+
+#include "typed_access.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "nl_type_bool.h"
+#include "nl_type_char.h"
+#include "nl_type_ptr.h"
+#include "pseudo_assembly.h"
+
+// packed chars and bools take one byte wherever they are stored in memory,
+// in variables they still fill a word of which the lowest addressed byte is
+// the value
+static bool is_byte(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+) {
+    return program_context.packed_chars
+        && ((*nl_type) == NLTypeChar {} || (*nl_type) == NLTypeBool {});
+}
+
+static uint32_t element_align(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+) {
+    if (auto nl_type_struct =
+            std::dynamic_pointer_cast<NLTypeStruct>(nl_type)) {
+        return struct_layout(*nl_type_struct, program_context).align;
+    }
+    return element_bytes(nl_type, program_context);
+}
+
+StructLayout struct_layout(
+    const NLTypeStruct& nl_type_struct,
+    const ProgramContext& program_context
+) {
+    std::vector<std::pair<std::string, std::shared_ptr<NLType>>> fields =
+        nl_type_struct.child_types;
+    if (nl_type_struct.compact) {
+        // with power of two alignments no padding is needed between fields
+        // in this order
+        std::stable_sort(
+            fields.begin(),
+            fields.end(),
+            [&](const auto& lhs, const auto& rhs) {
+                return element_align(lhs.second, program_context)
+                    > element_align(rhs.second, program_context);
+            }
+        );
+    }
+
+    StructLayout result;
+    for (auto& [name, nl_type] : fields) {
+        uint32_t align = element_align(nl_type, program_context);
+        result.bytes = (result.bytes + align - 1) / align * align;
+        result.offsets[name] = result.bytes;
+        result.bytes += element_bytes(nl_type, program_context);
+        result.align = std::max(result.align, align);
+    }
+    result.bytes = (result.bytes + result.align - 1) / result.align
+        * result.align;
+    return result;
+}
+
+uint32_t element_bytes(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+) {
+    if (auto nl_type_struct =
+            std::dynamic_pointer_cast<NLTypeStruct>(nl_type)) {
+        return struct_layout(*nl_type_struct, program_context).bytes;
+    }
+    return is_byte(nl_type, program_context) ? 1 : nl_type->bytes();
+}
+
+std::vector<uint32_t> pointer_offsets(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+) {
+    if (std::dynamic_pointer_cast<NLTypePtr>(nl_type)) {
+        return {0};
+    }
+    std::vector<uint32_t> result;
+    if (auto nl_type_struct =
+            std::dynamic_pointer_cast<NLTypeStruct>(nl_type)) {
+        StructLayout layout = struct_layout(*nl_type_struct, program_context);
+        for (auto& [name, child_type] : nl_type_struct->child_types) {
+            auto offsets = pointer_offsets(child_type, program_context);
+            for (uint32_t offset : offsets) {
+                result.push_back(layout.offsets.at(name) + offset);
+            }
+        }
+        std::sort(result.begin(), result.end());
+    }
+    return result;
+}
+
+std::shared_ptr<Code> load_typed(
+    std::shared_ptr<Code> expr,
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context,
+    uint32_t offset
+) {
+    if (is_byte(nl_type, program_context)) {
+        return deref_byte(expr, offset);
+    }
+    return deref(expr, offset);
+}
+
+std::shared_ptr<Code> store_typed(
+    std::shared_ptr<Code> addr,
+    std::shared_ptr<Code> expr,
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+) {
+    if (is_byte(nl_type, program_context)) {
+        return assign_to_byte_address(addr, expr);
+    }
+    return assign_to_address(addr, expr);
+}
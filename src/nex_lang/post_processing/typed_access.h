@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "code.h"
+#include "nl_type.h"
+#include "nl_type_struct.h"
+#include "program_context.h"
+
+// where the fields of a struct live relative to its start
+struct StructLayout {
+    std::map<std::string, uint32_t> offsets;
+    // padded to a multiple of align so arrays keep every field aligned
+    uint32_t bytes = 0;
+    uint32_t align = 1;
+};
+
+// fields are placed in declaration order at their natural alignment,
+// compact structs order them by decreasing alignment first
+StructLayout struct_layout(
+    const NLTypeStruct& nl_type_struct,
+    const ProgramContext& program_context
+);
+
+// size of one element of an array of nl_type
+uint32_t element_bytes(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+);
+
+// byte offsets of the pointers in one element of an array of nl_type
+std::vector<uint32_t> pointer_offsets(
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+);
+
+// loads a value of nl_type from the address expr evaluates to
+std::shared_ptr<Code> load_typed(
+    std::shared_ptr<Code> expr,
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context,
+    uint32_t offset = 0
+);
+
+// stores a value of nl_type to the address addr evaluates to
+std::shared_ptr<Code> store_typed(
+    std::shared_ptr<Code> addr,
+    std::shared_ptr<Code> expr,
+    std::shared_ptr<NLType> nl_type,
+    const ProgramContext& program_context
+);
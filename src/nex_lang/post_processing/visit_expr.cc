@@ -16,14 +16,19 @@
 #include "ast_node.h"
 #include "bin_op.h"
 #include "block.h"
+#include "block_ops.h"
+#include "branch.h"
 #include "call.h"
 #include "compile_error.h"
+#include "constant_ops.h"
 #include "define_label.h"
 #include "label.h"
+#include "loop_analysis.h"
 #include "nl_type.h"
 #include "nl_type_bool.h"
 #include "nl_type_char.h"
 #include "nl_type_i32.h"
+#include "nl_type_none.h"
 #include "nl_type_ptr.h"
 #include "nl_type_struct.h"
 #include "operators.h"
@@ -33,6 +38,7 @@
 #include "state.h"
 #include "symbol_not_found_error.h"
 #include "type_mismatch_error.h"
+#include "typed_access.h"
 #include "typed_procedure.h"
 #include "typed_variable.h"
 #include "use_label.h"
@@ -57,6 +63,54 @@ static std::set<NonTerminal> expr_non_terminals = {
     NonTerminal::exprp8,
     NonTerminal::exprp9};
 
+// copy(dst, src, n) and fill(dst, value, n) over n elements of the type dst
+// points to, lowered in place to unrolled loops rather than called
+static TypedExpr visit_block_op(
+    const std::string& name,
+    const std::vector<TypedExpr>& args,
+    size_t line_no,
+    const ProgramContext& program_context
+) {
+    auto nl_type_ptr = args.size() == 3
+        ? std::dynamic_pointer_cast<NLTypePtr>(args.at(0).nl_type)
+        : nullptr;
+    if (!nl_type_ptr || *args.at(2).nl_type != NLTypeI32 {}) {
+        throw TypeMismatchError(
+            name + " takes a pointer, a source or value and a count.",
+            line_no
+        );
+    }
+    std::shared_ptr<NLType> element = nl_type_ptr->nl_type;
+    uint32_t bytes = element_bytes(element, program_context);
+    // elements of whole words are moved a word at a time
+    uint32_t width = bytes % 4 == 0 ? 4 : 1;
+    std::shared_ptr<Code> count = times_constant(args.at(2).code, bytes);
+    std::shared_ptr<NLType> none = std::make_shared<NLTypeNone>();
+
+    if (name == "copy") {
+        if (*args.at(1).nl_type != *nl_type_ptr) {
+            throw TypeMismatchError(
+                "Copies require pointers of the same type.",
+                line_no
+            );
+        }
+        return TypedExpr {
+            make_copy(args.at(0).code, args.at(1).code, count, width),
+            none};
+    }
+    if (*args.at(1).nl_type != *element || bytes != width
+        || std::dynamic_pointer_cast<NLTypeStruct>(element)) {
+        throw TypeMismatchError(
+            "Fills require a value of the type pointed to, structs can not "
+            "be filled.",
+            line_no
+        );
+    }
+    return TypedExpr {
+        make_fill(args.at(0).code, args.at(1).code, count, width),
+        none};
+}
+
 TypedExpr visit_expr(
     ASTNode root,
     bool read_address,
@@ -95,7 +149,16 @@ TypedExpr visit_expr(
         ASTNode var_id = root.children.at(2);
         std::string var_name = var_id.lexeme;
 
-        if (symbol_table.count({name, {}})) {
+        // loaded once in front of the enclosing loop
+        std::string key = access_key(root);
+        if (!read_address && symbol_table.count({key, {}})) {
+            auto typed_var =
+                std::dynamic_pointer_cast<TypedVariable>(symbol_table[{key, {}}]);
+            assert(typed_var);
+            result = TypedExpr {
+                typed_var->variable->to_expr(),
+                typed_var->nl_type};
+        } else if (symbol_table.count({name, {}})) {
             if (auto typed_var = std::dynamic_pointer_cast<TypedVariable>(
                     symbol_table[{name, {}}]
                 )) {
@@ -105,24 +168,28 @@ TypedExpr visit_expr(
                             std::dynamic_pointer_cast<NLTypeStruct>(
                                 nl_type_ptr->nl_type
                             )) {
-                        uint32_t offset = 0;
                         std::shared_ptr<NLType> child_nl_type = nullptr;
                         for (auto& child_type : nl_type_struct->child_types) {
-                            if (child_type.first != var_name) {
-                                offset += child_type.second->bytes();
-                            } else {
+                            if (child_type.first == var_name) {
                                 child_nl_type = child_type.second;
                                 break;
                             }
                         }
+                        StructLayout layout =
+                            struct_layout(*nl_type_struct, program_context);
+                        uint32_t offset = layout.offsets.count(var_name)
+                            ? layout.offsets.at(var_name)
+                            : 0;
                         std::shared_ptr<Code> code = make_block(
                             {read_address ? bin_op(
                                  typed_var->variable->to_expr(),
                                  op::plus(),
                                  int_literal(offset)
                              )
-                                          : deref(
+                                          : load_typed(
                                               typed_var->variable->to_expr(),
+                                              child_nl_type,
+                                              program_context,
                                               offset
                                           )}
                         );
@@ -149,12 +216,16 @@ TypedExpr visit_expr(
         ASTNode num = root.children.at(0);
         result = TypedExpr {
             int_literal(stoi(num.lexeme)),
-            std::make_shared<NLTypeI32>()};
+            std::make_shared<NLTypeI32>(),
+            nullptr,
+            stoi(num.lexeme)};
     } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::MINUS, Terminal::NUM}) {
         ASTNode num = root.children.at(1);
         result = TypedExpr {
             int_literal(-stoi(num.lexeme)),
-            std::make_shared<NLTypeI32>()};
+            std::make_shared<NLTypeI32>(),
+            nullptr,
+            -stoi(num.lexeme)};
     } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::TRUE}) {
         ASTNode expr = root.children.at(0);
         result = TypedExpr {int_literal(1), std::make_shared<NLTypeBool>()};
@@ -192,14 +263,36 @@ TypedExpr visit_expr(
     } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::STRLITERAL}) {
         ASTNode id = root.children.at(0);
         std::string str_literal = id.lexeme.substr(1, id.lexeme.length() - 2);
-        std::vector<std::shared_ptr<Code>> code_str;
-        std::shared_ptr<Label> label = std::make_shared<Label>(str_literal);
-        code_str.push_back(make_define(label));
-        for (char c : str_literal) {
-            code_str.push_back(make_word(static_cast<uint32_t>(c)));
+        // identical literals anywhere in the program share their data
+        std::shared_ptr<Label> label;
+        if (program_context.string_literals.count(str_literal)) {
+            label = program_context.string_literals.at(str_literal);
+        } else {
+            label = std::make_shared<Label>(str_literal);
+            program_context.string_literals[str_literal] = label;
+            std::vector<std::shared_ptr<Code>> code_str;
+            code_str.push_back(make_define(label));
+            if (program_context.packed_chars) {
+                // four chars to a word, lowest address in the low byte,
+                // the terminator padding out the last word
+                for (size_t i = 0; i <= str_literal.length(); i += 4) {
+                    uint32_t bits = 0;
+                    for (size_t j = 0; j < 4; ++j) {
+                        if (i + j < str_literal.length()) {
+                            bits |= (uint32_t)(uint8_t)str_literal[i + j]
+                                << (8 * j);
+                        }
+                    }
+                    code_str.push_back(make_word(bits));
+                }
+            } else {
+                for (char c : str_literal) {
+                    code_str.push_back(make_word(static_cast<uint32_t>(c)));
+                }
+                code_str.push_back(make_word(0));
+            }
+            static_data.push_back(make_block(code_str));
         }
-        code_str.push_back(make_word(0));
-        static_data.push_back(make_block(code_str));
         result = TypedExpr {
             make_block({make_lis(Reg::Result), make_use(label)}),
             std::make_shared<NLTypePtr>(std::make_shared<NLTypeChar>())};
@@ -225,6 +318,17 @@ TypedExpr visit_expr(
             arg_types.push_back(typed_arg.nl_type);
         }
 
+        // functions of the same name and argument types take precedence
+        if ((name == "copy" || name == "fill")
+            && !symbol_table.count({name, arg_types})) {
+            return visit_block_op(
+                name,
+                typed_args,
+                id.line_no,
+                program_context
+            );
+        }
+
         if (symbol_table.count({name, arg_types})) {
             if (auto typed_procedure =
                     std::dynamic_pointer_cast<TypedProcedure>(
@@ -349,7 +453,59 @@ TypedExpr visit_expr(
             program_context,
             static_data
         );
+    } else if (prod == std::vector<State> {NonTerminal::exprp9, Terminal::NEW, NonTerminal::typeinit, Terminal::IN, Terminal::ID}) {
+        ASTNode id = root.children.at(3);
+        std::string name = id.lexeme;
+
+        auto typed_var = std::dynamic_pointer_cast<TypedVariable>(
+            symbol_table.count({name, {}}) ? symbol_table[{name, {}}] : nullptr
+        );
+        if (!typed_var) {
+            throw SymbolNotFoundError(name, id.line_no);
+        }
+
+        // anything with an alloc(self, bytes) -> i32 method holds objects
+        SymbolTableKey alloc_key = {
+            "alloc",
+            {typed_var->nl_type, std::make_shared<NLTypeI32>()}};
+        auto alloc = std::dynamic_pointer_cast<TypedProcedure>(
+            symbol_table.count(alloc_key) ? symbol_table[alloc_key] : nullptr
+        );
+        if (!alloc || !(*alloc->ret_type == NLTypeI32 {})) {
+            throw TypeMismatchError(
+                "Objects can only be placed in an arena.",
+                id.line_no
+            );
+        }
+
+        ASTNode typeinit = root.children.at(1);
+        return visit_typeinit(
+            typeinit,
+            read_address,
+            symbol_table,
+            program_context,
+            static_data,
+            alloc->procedure,
+            typed_var->variable->to_expr()
+        );
     } else if (prod == std::vector<State> {NonTerminal::exprp9, NonTerminal::exprp9, Terminal::LBRACKET, NonTerminal::expr, Terminal::RBRACKET}) {
+        // addressed through a pointer following the loop's induction variable
+        std::string key = access_key(root);
+        if (!key.empty() && symbol_table.count({key, {}})) {
+            auto typed_var =
+                std::dynamic_pointer_cast<TypedVariable>(symbol_table[{key, {}}]);
+            assert(typed_var);
+            std::shared_ptr<Code> address = typed_var->variable->to_expr();
+            return TypedExpr {
+                read_address ? address
+                             : load_typed(
+                                 address,
+                                 typed_var->nl_type,
+                                 program_context
+                             ),
+                typed_var->nl_type};
+        }
+
         ASTNode lhs_expr_node = root.children.at(0);
         TypedExpr lhs_expr = visit_expr(
             lhs_expr_node,
@@ -376,24 +532,32 @@ TypedExpr visit_expr(
                         bin_op(
                             deref(lhs_expr.code),
                             op::plus(),
-                            bin_op(
+                            times_constant(
                                 rhs_expr.code,
-                                op::times(),
-                                int_literal(nl_type_ptr->nl_type->bytes())
+                                element_bytes(
+                                    nl_type_ptr->nl_type,
+                                    program_context
+                                )
                             )
                         ),
                         nl_type_ptr->nl_type};
                 } else {
                     result = TypedExpr {
-                        deref(bin_op(
-                            lhs_expr.code,
-                            op::plus(),
+                        load_typed(
                             bin_op(
-                                rhs_expr.code,
-                                op::times(),
-                                int_literal(nl_type_ptr->nl_type->bytes())
-                            )
-                        )),
+                                lhs_expr.code,
+                                op::plus(),
+                                times_constant(
+                                    rhs_expr.code,
+                                    element_bytes(
+                                        nl_type_ptr->nl_type,
+                                        program_context
+                                    )
+                                )
+                            ),
+                            nl_type_ptr->nl_type,
+                            program_context
+                        ),
                         nl_type_ptr->nl_type};
                 }
             } else {
@@ -441,9 +605,10 @@ TypedExpr visit_expr(
         ASTNode expr = root.children.at(1);
 
         Terminal unary_op = std::get<Terminal>(lhs_op.state);
+        // the address *x stands for is the value of x, whatever x is
         TypedExpr expr_code = visit_expr(
             expr,
-            read_address,
+            read_address && unary_op != Terminal::STAR,
             symbol_table,
             program_context,
             static_data
@@ -458,7 +623,8 @@ TypedExpr visit_expr(
                 }
                 result = TypedExpr {
                     make_block({expr_code.code, op::not_bool()}),
-                    expr_code.nl_type};
+                    expr_code.nl_type,
+                    branch_not(expr_code.as_branch())};
                 break;
             case Terminal::STAR:
                 if (auto expr_type =
@@ -472,8 +638,14 @@ TypedExpr visit_expr(
                             lhs_op.line_no
                         );
                     }
-                    result =
-                        TypedExpr {deref(expr_code.code), expr_type->nl_type};
+                    result = TypedExpr {
+                        read_address ? expr_code.code
+                                     : load_typed(
+                                         expr_code.code,
+                                         expr_type->nl_type,
+                                         program_context
+                                     ),
+                        expr_type->nl_type};
                 } else {
                     throw TypeMismatchError(
                         "Dereference operations require operand to be of type pointer.",
@@ -525,6 +697,14 @@ TypedExpr visit_expr(
                 );
             }
             result_type = std::make_shared<NLTypeBool>();
+        } else if ((mid_op == Terminal::PLUS || mid_op == Terminal::MINUS) && std::dynamic_pointer_cast<NLTypePtr>(lhs_type) && (*rhs_type) == NLTypeI32()) {
+            // pointer arithmetic counts in elements of the pointed to type
+            auto nl_type_ptr = std::dynamic_pointer_cast<NLTypePtr>(lhs_type);
+            rhs_code = times_constant(
+                rhs_code,
+                element_bytes(nl_type_ptr->nl_type, program_context)
+            );
+            result_type = lhs_type;
         } else if (mid_op == Terminal::PLUS || mid_op == Terminal::MINUS || mid_op == Terminal::STAR || mid_op == Terminal::SLASH || mid_op == Terminal::PCT) {
             if ((*lhs_type) != NLTypeI32() || (*rhs_type) != NLTypeI32()) {
                 throw TypeMismatchError(
@@ -549,16 +729,22 @@ TypedExpr visit_expr(
         }
 
         switch (mid_op) {
-            case Terminal::OR:
-                result = TypedExpr {
-                    bin_op(lhs_code, op::or_bool(), rhs_code),
-                    result_type};
+            case Terminal::OR: {
+                Branch branch = branch_or(
+                    typed_lhs_code.as_branch(),
+                    typed_rhs_code.as_branch()
+                );
+                result = TypedExpr {branch_value(branch), result_type, branch};
                 break;
-            case Terminal::AND:
-                result = TypedExpr {
-                    bin_op(lhs_code, op::and_bool(), rhs_code),
-                    result_type};
+            }
+            case Terminal::AND: {
+                Branch branch = branch_and(
+                    typed_lhs_code.as_branch(),
+                    typed_rhs_code.as_branch()
+                );
+                result = TypedExpr {branch_value(branch), result_type, branch};
                 break;
+            }
             case Terminal::PLUS:
                 result = TypedExpr {
                     bin_op(lhs_code, op::plus(), rhs_code),
@@ -570,49 +756,77 @@ TypedExpr visit_expr(
                     result_type};
                 break;
             case Terminal::STAR:
-                result = TypedExpr {
-                    bin_op(lhs_code, op::times(), rhs_code),
-                    result_type};
+                if (typed_rhs_code.constant) {
+                    result = TypedExpr {
+                        times_constant(lhs_code, *typed_rhs_code.constant),
+                        result_type};
+                } else if (typed_lhs_code.constant) {
+                    result = TypedExpr {
+                        times_constant(rhs_code, *typed_lhs_code.constant),
+                        result_type};
+                } else {
+                    result = TypedExpr {
+                        bin_op(lhs_code, op::times(), rhs_code),
+                        result_type};
+                }
                 break;
             case Terminal::SLASH:
-                result = TypedExpr {
-                    bin_op(lhs_code, op::divide(), rhs_code),
-                    result_type};
+                if (typed_rhs_code.constant) {
+                    result = TypedExpr {
+                        divide_constant(lhs_code, *typed_rhs_code.constant),
+                        result_type};
+                } else {
+                    result = TypedExpr {
+                        bin_op(lhs_code, op::divide(), rhs_code),
+                        result_type};
+                }
                 break;
             case Terminal::PCT:
-                result = TypedExpr {
-                    bin_op(lhs_code, op::remainder(), rhs_code),
-                    result_type};
+                if (typed_rhs_code.constant) {
+                    result = TypedExpr {
+                        remainder_constant(lhs_code, *typed_rhs_code.constant),
+                        result_type};
+                } else {
+                    result = TypedExpr {
+                        bin_op(lhs_code, op::remainder(), rhs_code),
+                        result_type};
+                }
                 break;
             case Terminal::EQ:
                 result = TypedExpr {
                     bin_op(lhs_code, op::eq_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Eq, rhs_code)};
                 break;
             case Terminal::NE:
                 result = TypedExpr {
                     bin_op(lhs_code, op::ne_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Ne, rhs_code)};
                 break;
             case Terminal::LT:
                 result = TypedExpr {
                     bin_op(lhs_code, op::lt_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Lt, rhs_code)};
                 break;
             case Terminal::GT:
                 result = TypedExpr {
                     bin_op(lhs_code, op::gt_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Gt, rhs_code)};
                 break;
             case Terminal::LE:
                 result = TypedExpr {
                     bin_op(lhs_code, op::le_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Le, rhs_code)};
                 break;
             case Terminal::GE:
                 result = TypedExpr {
                     bin_op(lhs_code, op::ge_cmp(), rhs_code),
-                    result_type};
+                    result_type,
+                    branch_cmp(lhs_code, Comparison::Ge, rhs_code)};
                 break;
             default:
                 std::cerr
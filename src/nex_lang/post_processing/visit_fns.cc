@@ -10,6 +10,9 @@
 #include <variant>
 
 #include "ast_node.h"
+#include "block.h"
+#include "loop_analysis.h"
+#include "ret_stmt.h"
 #include "state.h"
 #include "visit_params.h"
 #include "visit_stmts.h"
@@ -19,6 +22,21 @@ struct NLType;
 struct ProgramContext;
 struct TypedVariable;
 
+// rarely run code goes after the body, which returns before reaching it
+static std::shared_ptr<Code> append_cold_code(
+    std::shared_ptr<TypedProcedure> proc,
+    std::shared_ptr<Code> body
+) {
+    if (proc->cold_code.empty()) {
+        return body;
+    }
+    return make_block(
+        {body,
+         std::make_shared<RetStmt>(make_block({})),
+         make_block(proc->cold_code)}
+    );
+}
+
 std::vector<std::shared_ptr<TypedProcedure>> visit_fns(
     ASTNode root,
     SymbolTable& symbol_table,
@@ -109,6 +127,10 @@ std::shared_ptr<TypedProcedure> visit_fn(
         }
 
         ASTNode stmtblock = root.children.at(7);
+        result->address_taken = address_taken(stmtblock);
+        if (program_context.frame_objects) {
+            result->frame_objects = frame_objects(stmtblock);
+        }
         auto code = visit_stmtblock(
             stmtblock,
             result,
@@ -117,7 +139,7 @@ std::shared_ptr<TypedProcedure> visit_fn(
             static_data
         );
 
-        result->procedure->code = code;
+        result->procedure->code = append_cold_code(result, code);
     } else if (prod == std::vector<State> {NonTerminal::fn, Terminal::FN, Terminal::ID, Terminal::LPAREN, NonTerminal::optparams, Terminal::RPAREN, NonTerminal::stmtblock}) {
         result = std::make_shared<TypedProcedure>();
 
@@ -152,6 +174,10 @@ std::shared_ptr<TypedProcedure> visit_fn(
         }
 
         ASTNode stmtblock = root.children.at(5);
+        result->address_taken = address_taken(stmtblock);
+        if (program_context.frame_objects) {
+            result->frame_objects = frame_objects(stmtblock);
+        }
         auto code = visit_stmtblock(
             stmtblock,
             result,
@@ -160,7 +186,7 @@ std::shared_ptr<TypedProcedure> visit_fn(
             static_data
         );
 
-        result->procedure->code = code;
+        result->procedure->code = append_cold_code(result, code);
     } else {
         std::cerr << "Invalid production found while processing fn."
                   << std::endl;
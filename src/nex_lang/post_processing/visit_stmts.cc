@@ -1,26 +1,31 @@
 
 #include "visit_stmts.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <cassert>
 #include <iostream>
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "assembly.h"
 #include "ast_node.h"
 #include "block.h"
+#include "branch.h"
 #include "call.h"
 #include "duplicate_symbol_error.h"
-#include "if_stmt.h"
+#include "loop_analysis.h"
 #include "nl_type.h"
 #include "nl_type_bool.h"
 #include "nl_type_ptr.h"
-#include "operators.h"
+#include "profile.h"
 #include "program_context.h"
 #include "pseudo_assembly.h"
 #include "reg.h"
@@ -28,12 +33,52 @@
 #include "scope.h"
 #include "state.h"
 #include "type_mismatch_error.h"
+#include "typed_access.h"
 #include "typed_expr.h"
 #include "typed_variable.h"
 #include "variable.h"
 #include "visit_expr.h"
+#include "visit_type.h"
 #include "visit_vardef.h"
-#include "while_loop.h"
+#include "word.h"
+
+// frame objects are addressed with 16 bit offsets, larger ones stay on the
+// heap
+static const uint32_t FRAME_OBJECT_BYTES = 256;
+
+// the symbol table key of the frame variable holding the object of name
+static std::string frame_object_key(std::string name) {
+    return "object of " + name;
+}
+
+// a pointer to a new object in the frame of curr_proc for let name = new
+// when its object can live there
+static std::optional<TypedExpr> visit_frame_object(
+    std::string name,
+    std::shared_ptr<TypedProcedure> curr_proc,
+    SymbolTable& symbol_table,
+    ProgramContext& program_context
+) {
+    if (!curr_proc->frame_objects.count(name)) {
+        return std::nullopt;
+    }
+    FrameObject& frame_object = curr_proc->frame_objects.at(name);
+    std::shared_ptr<NLType> nl_type =
+        visit_type(frame_object.type, program_context);
+    uint32_t bytes =
+        element_bytes(nl_type, program_context) * frame_object.count;
+    if (bytes > FRAME_OBJECT_BYTES) {
+        return std::nullopt;
+    }
+
+    std::string key = frame_object_key(name);
+    auto object =
+        std::make_shared<Variable>(key, std::max((bytes + 3) / 4, 1u));
+    symbol_table[{key, {}}] = std::make_shared<TypedVariable>(object, nl_type);
+    return TypedExpr {
+        object->to_expr(true),
+        std::make_shared<NLTypePtr>(nl_type)};
+}
 
 std::shared_ptr<Code> visit_stmt(
     ASTNode root,
@@ -59,13 +104,20 @@ std::shared_ptr<Code> visit_stmt(
         auto typed_var = visit_vardef(vardef, symbol_table, program_context);
 
         ASTNode expr_node = root.children.at(3);
-        TypedExpr expr = visit_expr(
-            expr_node,
-            false,
+        std::optional<TypedExpr> frame_object = visit_frame_object(
+            typed_var->variable->name,
+            curr_proc,
             symbol_table,
-            program_context,
-            static_data
+            program_context
         );
+        TypedExpr expr = frame_object ? *frame_object
+                                      : visit_expr(
+                                          expr_node,
+                                          false,
+                                          symbol_table,
+                                          program_context,
+                                          static_data
+                                      );
 
         if ((*typed_var->nl_type) != (*expr.nl_type)) {
             throw TypeMismatchError(
@@ -78,19 +130,28 @@ std::shared_ptr<Code> visit_stmt(
         result = assign(typed_var->variable, expr.code);
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::LET, Terminal::ID, Terminal::ASSIGN, NonTerminal::expr, Terminal::SEMI}) {
         // extract variable declaration and assignment with type inference
-
-        ASTNode expr_node = root.children.at(3);
-        TypedExpr expr = visit_expr(
-            expr_node,
-            false,
-            symbol_table,
-            program_context,
-            static_data
-        );
-
         ASTNode id = root.children.at(1);
         std::string name = id.lexeme;
 
+        ASTNode expr_node = root.children.at(3);
+        std::optional<TypedExpr> frame_object = std::nullopt;
+        if (!symbol_table.count({name, {}})) {
+            frame_object = visit_frame_object(
+                name,
+                curr_proc,
+                symbol_table,
+                program_context
+            );
+        }
+        TypedExpr expr = frame_object ? *frame_object
+                                      : visit_expr(
+                                          expr_node,
+                                          false,
+                                          symbol_table,
+                                          program_context,
+                                          static_data
+                                      );
+
         if (symbol_table.count({name, {}})) {
             throw DuplicateSymbolError(name, id.line_no);
         } else {
@@ -119,7 +180,12 @@ std::shared_ptr<Code> visit_stmt(
                 root.children.at(1).line_no
             );
         }
-        result = assign_to_address(mem_address.code, code.code);
+        result = store_typed(
+            mem_address.code,
+            code.code,
+            mem_address.nl_type,
+            program_context
+        );
     } else if (prod == std::vector<State> {NonTerminal::stmt, NonTerminal::expr, Terminal::SEMI}) {
         // extract run expression
         ASTNode expr = root.children.at(0);
@@ -128,6 +194,8 @@ std::shared_ptr<Code> visit_stmt(
         result = code.code;
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::IF, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock, Terminal::ELSE, NonTerminal::stmtblock}) {
         // extract if else statements
+        std::string name = curr_proc->procedure->name + " if "
+            + std::to_string(curr_proc->if_stmts++);
         ASTNode expr = root.children.at(2);
         TypedExpr comp =
             visit_expr(expr, false, symbol_table, program_context, static_data);
@@ -156,13 +224,23 @@ std::shared_ptr<Code> visit_stmt(
                 root.children.at(0).line_no
             );
         }
-        result = make_if(
-            comp.code,
-            op::ne_cmp(),
-            make_add(Reg::Result, Reg::Zero, Reg::Zero),
-            thens,
-            elses
-        );
+        // with a profile, the side that ran less often goes out of line
+        uint64_t then_count =
+            profile_count(program_context.profile, name + " then");
+        uint64_t else_count =
+            profile_count(program_context.profile, name + " else");
+        if (then_count == else_count) {
+            result = make_branch_if(comp.as_branch(), thens, elses, name);
+        } else {
+            result = make_branch_if(
+                comp.as_branch(),
+                thens,
+                elses,
+                name,
+                then_count > else_count,
+                curr_proc->cold_code
+            );
+        }
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::IF, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock}) {
         // extract if statements
         ASTNode expr = root.children.at(2);
@@ -184,23 +262,73 @@ std::shared_ptr<Code> visit_stmt(
                 root.children.at(0).line_no
             );
         }
-        result = make_if(
-            comp.code,
-            op::ne_cmp(),
-            make_add(Reg::Result, Reg::Zero, Reg::Zero),
-            thens
-        );
+        result = make_branch_if(comp.as_branch(), thens);
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::WHILE, Terminal::LPAREN, NonTerminal::expr, Terminal::RPAREN, NonTerminal::stmtblock}) {
         // extract while loops
         ASTNode expr = root.children.at(2);
-        TypedExpr comp =
-            visit_expr(expr, false, symbol_table, program_context, static_data);
-
         ASTNode stmtblock = root.children.at(4);
+        LoopPlan plan =
+            plan_loop(expr, stmtblock, symbol_table, curr_proc->address_taken);
+
+        // invariant loads and induction pointers are computed in front of
+        // the loop and found by their access key inside of it
+        SymbolTable loop_symbol_table = symbol_table;
+        std::vector<std::shared_ptr<Variable>> loop_vars;
+        std::vector<std::shared_ptr<Code>> preheader;
+        for (auto& load : plan.invariant_loads) {
+            TypedExpr value = visit_expr(
+                load,
+                false,
+                symbol_table,
+                program_context,
+                static_data
+            );
+            auto variable = std::make_shared<Variable>(access_key(load));
+            loop_symbol_table[{variable->name, {}}] =
+                std::make_shared<TypedVariable>(variable, value.nl_type);
+            loop_vars.push_back(variable);
+            preheader.push_back(assign(variable, value.code));
+        }
+        std::vector<std::shared_ptr<Code>> induction_steps;
+        for (auto& access : plan.induction_accesses) {
+            TypedExpr address = visit_expr(
+                access,
+                true,
+                symbol_table,
+                program_context,
+                static_data
+            );
+            auto variable = std::make_shared<Variable>(access_key(access));
+            loop_symbol_table[{variable->name, {}}] =
+                std::make_shared<TypedVariable>(variable, address.nl_type);
+            loop_vars.push_back(variable);
+            preheader.push_back(assign(variable, address.code));
+            induction_steps.push_back(assign(
+                variable,
+                make_block(
+                    {variable->to_expr(),
+                     make_lis(Reg::Scratch),
+                     make_word(
+                         plan.step
+                         * element_bytes(address.nl_type, program_context)
+                     ),
+                     make_add(Reg::Result, Reg::Result, Reg::Scratch)}
+                )
+            ));
+        }
+
+        TypedExpr comp = visit_expr(
+            expr,
+            false,
+            loop_symbol_table,
+            program_context,
+            static_data
+        );
+
         auto stmts = visit_stmtblock(
             stmtblock,
             curr_proc,
-            symbol_table,
+            loop_symbol_table,
             program_context,
             static_data
         );
@@ -211,11 +339,22 @@ std::shared_ptr<Code> visit_stmt(
                 root.children.at(0).line_no
             );
         }
-        return make_while(
-            comp.code,
-            op::ne_cmp(),
-            make_add(Reg::Result, Reg::Zero, Reg::Zero),
-            stmts
+        if (loop_vars.empty()) {
+            return make_branch_while(comp.as_branch(), stmts);
+        }
+
+        // the induction variable is stepped last, so its pointers follow
+        // right after the body
+        TypedExpr entry_comp =
+            visit_expr(expr, false, symbol_table, program_context, static_data);
+        return make_scope(
+            loop_vars,
+            make_branch_while(
+                entry_comp.as_branch(),
+                make_block(preheader),
+                comp.as_branch(),
+                make_block({stmts, make_block(induction_steps)})
+            )
         );
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::RET, NonTerminal::expr, Terminal::SEMI}) {
         // extract return statements
@@ -238,8 +377,11 @@ std::shared_ptr<Code> visit_stmt(
         }
         result = std::make_shared<RetStmt>(expr.code);
     } else if (prod == std::vector<State> {NonTerminal::stmt, Terminal::DELETE, NonTerminal::expr, Terminal::SEMI}) {
-        // extract return statements
+        // extract delete statements, objects in the frame go with it
         ASTNode expr_node = root.children.at(1);
+        if (symbol_table.count({frame_object_key(access_key(expr_node)), {}})) {
+            return make_block({});
+        }
         TypedExpr expr = visit_expr(
             expr_node,
             false,
@@ -9,29 +9,103 @@
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include "assembly.h"
 #include "ast_node.h"
 #include "bin_op.h"
 #include "block.h"
 #include "call.h"
+#include "constant_ops.h"
+#include "define_label.h"
+#include "label.h"
 #include "nl_type.h"
 #include "nl_type_i32.h"
 #include "nl_type_ptr.h"
 #include "operators.h"
 #include "program_context.h"
+#include "procedure.h"
 #include "pseudo_assembly.h"
+#include "reg.h"
 #include "state.h"
 #include "type_mismatch_error.h"
+#include "typed_access.h"
 #include "typed_procedure.h"
+#include "use_label.h"
 #include "visit_expr.h"
 #include "visit_type.h"
+#include "word.h"
+
+// the layout word of objects of nl_type for the collector, tables of
+// element types with a mix of pointers and other words are placed in static
+// data once
+static std::shared_ptr<Code> gc_layout(
+    std::shared_ptr<NLType> nl_type,
+    ProgramContext& program_context,
+    std::vector<std::shared_ptr<Code>>& static_data
+) {
+    uint32_t bytes = element_bytes(nl_type, program_context);
+    std::vector<uint32_t> offsets = pointer_offsets(nl_type, program_context);
+    if (offsets.empty()) {
+        return int_literal(0);
+    }
+    if (offsets.size() * 4 == bytes) {
+        return int_literal(1);
+    }
+
+    std::string key = nl_type->to_string();
+    if (!program_context.gc_layouts.contains(key)) {
+        auto label = std::make_shared<Label>("layout of " + key);
+        program_context.gc_layouts[key] = label;
+        std::vector<std::shared_ptr<Code>> table = {
+            make_define(label),
+            make_word(bytes),
+            make_word(offsets.size())};
+        for (uint32_t offset : offsets) {
+            table.push_back(make_word(offset));
+        }
+        static_data.push_back(make_block(table));
+    }
+    return make_block(
+        {make_lis(Reg::Result),
+         make_use(program_context.gc_layouts.at(key))}
+    );
+}
+
+// size bytes for objects of nl_type from the heap, or from arena through its
+// alloc procedure when not collecting
+static std::shared_ptr<Code> allocate(
+    std::shared_ptr<NLType> nl_type,
+    std::shared_ptr<Code> size,
+    ProgramContext& program_context,
+    std::vector<std::shared_ptr<Code>>& static_data,
+    std::shared_ptr<Procedure> alloc,
+    std::shared_ptr<Code> arena
+) {
+    if (alloc && !program_context.gc) {
+        return make_call(alloc, {arena, size});
+    }
+
+    std::shared_ptr<TypedProcedure> typed_proc =
+        std::dynamic_pointer_cast<TypedProcedure>(
+            program_context.module_table.at("heap").at({"heap_allocate", {}})
+        );
+    assert(typed_proc);
+    std::vector<std::shared_ptr<Code>> args = {size};
+    if (program_context.gc) {
+        args.push_back(gc_layout(nl_type, program_context, static_data));
+    }
+    return make_call(typed_proc->procedure, args);
+}
 
 TypedExpr visit_typeinit(
     ASTNode root,
     bool read_address,
     SymbolTable& symbol_table,
     ProgramContext& program_context,
-    std::vector<std::shared_ptr<Code>>& static_data
+    std::vector<std::shared_ptr<Code>>& static_data,
+    std::shared_ptr<Procedure> alloc,
+    std::shared_ptr<Code> arena
 ) {
     assert(std::get<NonTerminal>(root.state) == NonTerminal::typeinit);
     TypedExpr result = TypedExpr {nullptr, nullptr};
@@ -42,15 +116,17 @@ TypedExpr visit_typeinit(
         std::shared_ptr<NLType> nl_type =
             visit_type(type_node, program_context);
 
-        std::shared_ptr<TypedProcedure> typed_proc =
-            std::dynamic_pointer_cast<TypedProcedure>(
-                program_context.module_table.at("heap").at({"heap_allocate", {}}
-                )
-            );
-        assert(typed_proc);
-
+        // heap blocks are kept word aligned
+        uint32_t bytes = element_bytes(nl_type, program_context);
         result = TypedExpr {
-            make_call(typed_proc->procedure, {int_literal(nl_type->bytes())}),
+            allocate(
+                nl_type,
+                int_literal((bytes + 3) / 4 * 4),
+                program_context,
+                static_data,
+                alloc,
+                arena
+            ),
             std::make_shared<NLTypePtr>(nl_type)};
     } else if (prod == std::vector<State> {NonTerminal::typeinit, NonTerminal::type, Terminal::LBRACKET, NonTerminal::expr, Terminal::RBRACKET}) {
         ASTNode type_node = root.children.at(0);
@@ -65,22 +141,26 @@ TypedExpr visit_typeinit(
             program_context,
             static_data
         );
-        std::shared_ptr<TypedProcedure> typed_proc =
-            std::dynamic_pointer_cast<TypedProcedure>(
-                program_context.module_table.at("heap").at({"heap_allocate", {}}
-                )
-            );
-        assert(typed_proc);
-
         if ((*expr.nl_type) == NLTypeI32 {}) {
+            uint32_t bytes = element_bytes(nl_type, program_context);
+            std::shared_ptr<Code> size = times_constant(expr.code, bytes);
+            if (bytes % 4 != 0) {
+                size = times_constant(
+                    divide_constant(
+                        bin_op(size, op::plus(), int_literal(3)),
+                        4
+                    ),
+                    4
+                );
+            }
             result = TypedExpr {
-                make_call(
-                    typed_proc->procedure,
-                    {make_block({bin_op(
-                        expr.code,
-                        op::times(),
-                        int_literal(nl_type->bytes())
-                    )})}
+                allocate(
+                    nl_type,
+                    size,
+                    program_context,
+                    static_data,
+                    alloc,
+                    arena
                 ),
                 std::make_shared<NLTypePtr>(nl_type)};
         } else {
@@ -11,12 +11,17 @@
 
 struct ASTNode;
 struct Code;
+struct Procedure;
 struct ProgramContext;
 
+// objects are placed in arena by calling alloc with it and their size when
+// alloc is given, otherwise they come from the heap
 TypedExpr visit_typeinit(
     ASTNode root,
     bool read_address,
     SymbolTable& symbol_table,
     ProgramContext& program_context,
-    std::vector<std::shared_ptr<Code>>& static_data
+    std::vector<std::shared_ptr<Code>>& static_data,
+    std::shared_ptr<Procedure> alloc = nullptr,
+    std::shared_ptr<Code> arena = nullptr
 );
@@ -1,12 +1,24 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <memory>
+#include <optional>
 
+#include "branch.h"
 #include "code.h"
 #include "nl_type.h"
 
 struct TypedExpr {
     std::shared_ptr<Code> code;
     std::shared_ptr<NLType> nl_type;
+    // set for conditions that can branch without materializing a bool
+    Branch branch = nullptr;
+    // set for integer literals
+    std::optional<int32_t> constant = std::nullopt;
+
+    Branch as_branch() const {
+        return branch ? branch : branch_bool(code);
+    }
 };
@@ -1,7 +1,13 @@
 #pragma once
+#include <stdint.h>
+
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
+#include "ast_node.h"
 #include "nl_type.h"
 #include "procedure.h"
 #include "typed_id.h"
@@ -9,10 +15,25 @@
 
 struct TypedVariable;
 
+// the object of a let name = new type or new type[count], see frame_objects
+struct FrameObject {
+    ASTNode type;
+    uint32_t count;
+};
+
 struct TypedProcedure: TypedID {
     std::shared_ptr<Procedure> procedure;
     std::shared_ptr<NLType> ret_type;
     std::vector<std::shared_ptr<TypedVariable>> params;
+    // variables that may change through pointers anywhere in the body
+    std::set<std::string> address_taken;
+    // lets whose object can live in the frame instead of on the heap
+    std::map<std::string, FrameObject> frame_objects;
+    // if else statements generated so far, which name their profile labels
+    uint32_t if_stmts = 0;
+    // sides of if else statements the profile says rarely run, laid out
+    // after the body
+    std::vector<std::shared_ptr<Code>> cold_code;
     explicit TypedProcedure(
         std::shared_ptr<Procedure> procedure = nullptr,
         std::shared_ptr<NLType> ret_type = nullptr,
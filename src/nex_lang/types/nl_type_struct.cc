@@ -6,10 +6,12 @@
 
 NLTypeStruct::NLTypeStruct(
     std::string name,
-    std::vector<std::pair<std::string, std::shared_ptr<NLType>>> child_types
+    std::vector<std::pair<std::string, std::shared_ptr<NLType>>> child_types,
+    bool compact
 ) :
     name {name},
-    child_types {child_types} {}
+    child_types {child_types},
+    compact {compact} {}
 
 bool NLTypeStruct::equals(const NLType& other) const {
     if (type() != other.type()) {
@@ -36,11 +38,3 @@ std::type_index NLTypeStruct::type() const {
 std::string NLTypeStruct::to_string() {
     return name;
 }
-
-uint32_t NLTypeStruct::bytes() {
-    uint32_t result = 0;
-    for (auto child_type : child_types) {
-        result += child_type.second->bytes();
-    }
-    return result;
-}
@@ -2,8 +2,6 @@
 
 #pragma once
 
-#include <stdint.h>
-
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -15,14 +13,16 @@
 struct NLTypeStruct: NLType {
     std::string name;
     std::vector<std::pair<std::string, std::shared_ptr<NLType>>> child_types;
+    // declared compact, fields may be reordered to save padding
+    bool compact;
 
     explicit NLTypeStruct(
         std::string name,
-        std::vector<std::pair<std::string, std::shared_ptr<NLType>>> child_types
+        std::vector<std::pair<std::string, std::shared_ptr<NLType>>> child_types,
+        bool compact = false
     );
     bool equals(const NLType& other) const override;
     bool less_than(const NLType& other) const override;
     std::type_index type() const override;
     std::string to_string() override;
-    uint32_t bytes() override;
 };
@@ -135,3 +135,153 @@ std::shared_ptr<Code> make_jalr(Reg s) {
         | BVS<21, 0, 0b000000000000000001001>::val
     );
 }
+
+std::shared_ptr<Code> make_and(Reg d, Reg s, Reg t) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000100100>::val
+    );
+}
+
+std::shared_ptr<Code> make_or(Reg d, Reg s, Reg t) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000100101>::val
+    );
+}
+
+std::shared_ptr<Code> make_xor(Reg d, Reg s, Reg t) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000100110>::val
+    );
+}
+
+std::shared_ptr<Code> make_nor(Reg d, Reg s, Reg t) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000100111>::val
+    );
+}
+
+std::shared_ptr<Code> make_sll(Reg d, Reg t, uint32_t shamt) {
+    return std::make_shared<Word>(
+        BVS<32, 21, 0b00000000000>::val | bvs(21, 16, (uint32_t)t)
+        | bvs(16, 11, (uint32_t)d) | bvs(11, 6, shamt)
+        | BVS<6, 0, 0b000000>::val
+    );
+}
+
+std::shared_ptr<Code> make_srl(Reg d, Reg t, uint32_t shamt) {
+    return std::make_shared<Word>(
+        BVS<32, 21, 0b00000000000>::val | bvs(21, 16, (uint32_t)t)
+        | bvs(16, 11, (uint32_t)d) | bvs(11, 6, shamt)
+        | BVS<6, 0, 0b000010>::val
+    );
+}
+
+std::shared_ptr<Code> make_sra(Reg d, Reg t, uint32_t shamt) {
+    return std::make_shared<Word>(
+        BVS<32, 21, 0b00000000000>::val | bvs(21, 16, (uint32_t)t)
+        | bvs(16, 11, (uint32_t)d) | bvs(11, 6, shamt)
+        | BVS<6, 0, 0b000011>::val
+    );
+}
+
+std::shared_ptr<Code> make_sllv(Reg d, Reg t, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000000100>::val
+    );
+}
+
+std::shared_ptr<Code> make_srlv(Reg d, Reg t, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000000110>::val
+    );
+}
+
+std::shared_ptr<Code> make_srav(Reg d, Reg t, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b000000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 11, (uint32_t)d)
+        | BVS<11, 0, 0b00000000111>::val
+    );
+}
+
+std::shared_ptr<Code> make_addi(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_addiu(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001001>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_slti(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001010>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_andi(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001100>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_ori(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001101>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_xori(Reg t, Reg s, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b001110>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_lui(Reg t, uint32_t i) {
+    return std::make_shared<Word>(
+        BVS<32, 21, 0b00111100000>::val | bvs(21, 16, (uint32_t)t)
+        | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_lb(Reg t, uint32_t i, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b100000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_lbu(Reg t, uint32_t i, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b100100>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
+
+std::shared_ptr<Code> make_sb(Reg t, uint32_t i, Reg s) {
+    return std::make_shared<Word>(
+        BVS<32, 26, 0b101000>::val | bvs(26, 21, (uint32_t)s)
+        | bvs(21, 16, (uint32_t)t) | bvs(16, 0, i)
+    );
+}
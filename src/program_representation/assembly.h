@@ -38,3 +38,26 @@ std::shared_ptr<Code> make_beq(Reg s, Reg t, uint32_t i);
 std::shared_ptr<Code> make_bne(Reg s, Reg t, uint32_t i);
 std::shared_ptr<Code> make_jr(Reg s);
 std::shared_ptr<Code> make_jalr(Reg s);
+
+std::shared_ptr<Code> make_and(Reg d, Reg s, Reg t);
+std::shared_ptr<Code> make_or(Reg d, Reg s, Reg t);
+std::shared_ptr<Code> make_xor(Reg d, Reg s, Reg t);
+std::shared_ptr<Code> make_nor(Reg d, Reg s, Reg t);
+std::shared_ptr<Code> make_sll(Reg d, Reg t, uint32_t shamt);
+std::shared_ptr<Code> make_srl(Reg d, Reg t, uint32_t shamt);
+std::shared_ptr<Code> make_sra(Reg d, Reg t, uint32_t shamt);
+std::shared_ptr<Code> make_sllv(Reg d, Reg t, Reg s);
+std::shared_ptr<Code> make_srlv(Reg d, Reg t, Reg s);
+std::shared_ptr<Code> make_srav(Reg d, Reg t, Reg s);
+
+// immediates are 16 bits, sign extended except for andi, ori and xori
+std::shared_ptr<Code> make_addi(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_addiu(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_slti(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_andi(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_ori(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_xori(Reg t, Reg s, uint32_t i);
+std::shared_ptr<Code> make_lui(Reg t, uint32_t i);
+std::shared_ptr<Code> make_lb(Reg t, uint32_t i, Reg s);
+std::shared_ptr<Code> make_lbu(Reg t, uint32_t i, Reg s);
+std::shared_ptr<Code> make_sb(Reg t, uint32_t i, Reg s);
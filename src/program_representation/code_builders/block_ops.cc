@@ -0,0 +1,140 @@
+
+#include "block_ops.h"
+
+#include <functional>
+#include <vector>
+
+#include "assembly.h"
+#include "beq_label.h"
+#include "bin_op.h"
+#include "block.h"
+#include "bne_label.h"
+#include "constant_ops.h"
+#include "define_label.h"
+#include "if_stmt.h"
+#include "label.h"
+#include "operators.h"
+#include "pseudo_assembly.h"
+#include "reg.h"
+#include "scope.h"
+#include "var_access.h"
+#include "variable.h"
+#include "word.h"
+
+// words moved by each turn of the unrolled loop
+static const uint32_t UNROLL = 8;
+
+using Step = std::function<std::shared_ptr<Code>(uint32_t offset)>;
+
+// repeats steps steps at a time until Scratch reaches end, Scratch and with
+// copying Scratch2 advance by steps units per turn. Only Result is left to
+// step, the loop bound and increment live in CopyChunkScratch and TargetPC
+static std::shared_ptr<Code> step_until(
+    std::shared_ptr<Variable> end,
+    Step step,
+    uint32_t steps,
+    uint32_t width,
+    bool copying
+) {
+    std::shared_ptr<Label> top = std::make_shared<Label>("top of block loop");
+    std::shared_ptr<Label> done = std::make_shared<Label>("end of block loop");
+    std::vector<std::shared_ptr<Code>> code = {
+        make_read(Reg::CopyChunkScratch, end),
+        make_lis(Reg::TargetPC),
+        make_word(steps * width),
+        make_beq(Reg::Scratch, Reg::CopyChunkScratch, done),
+        make_define(top)};
+    for (uint32_t i = 0; i < steps; ++i) {
+        code.push_back(step(i * width));
+    }
+    code.push_back(make_add(Reg::Scratch, Reg::Scratch, Reg::TargetPC));
+    if (copying) {
+        code.push_back(make_add(Reg::Scratch2, Reg::Scratch2, Reg::TargetPC));
+    }
+    code.push_back(make_bne(Reg::Scratch, Reg::CopyChunkScratch, top));
+    code.push_back(make_define(done));
+    return make_block(code);
+}
+
+// the bulk of the bytes is covered UNROLL units per turn and the rest one
+// at a time, with dst in Scratch and the other operand in Scratch2 when
+// copying or in Result otherwise
+static std::shared_ptr<Code> block_op(
+    std::shared_ptr<Code> dst,
+    std::shared_ptr<Code> operand,
+    std::shared_ptr<Code> bytes,
+    uint32_t width,
+    Step step,
+    bool copying
+) {
+    std::shared_ptr<Variable> start = std::make_shared<Variable>("block start");
+    std::shared_ptr<Variable> other =
+        std::make_shared<Variable>("block source or value");
+    std::shared_ptr<Variable> size = std::make_shared<Variable>("block bytes");
+    std::shared_ptr<Variable> bulk_end =
+        std::make_shared<Variable>("end of unrolled block");
+    std::shared_ptr<Variable> end = std::make_shared<Variable>("block end");
+    return make_scope(
+        {start, other, size, bulk_end, end},
+        {assign(start, dst),
+         assign(other, operand),
+         assign(size, bytes),
+         make_if(
+             size->to_expr(),
+             op::gt_cmp(),
+             int_literal(0),
+             make_block(
+                 {assign(
+                      end,
+                      bin_op(start->to_expr(), op::plus(), size->to_expr())
+                  ),
+                  assign(
+                      bulk_end,
+                      bin_op(
+                          end->to_expr(),
+                          op::minus(),
+                          remainder_constant(size->to_expr(), UNROLL * width)
+                      )
+                  ),
+                  make_read(Reg::Scratch, start),
+                  make_read(copying ? Reg::Scratch2 : Reg::Result, other),
+                  step_until(bulk_end, step, UNROLL, width, copying),
+                  step_until(end, step, 1, width, copying)}
+             )
+         )}
+    );
+}
+
+std::shared_ptr<Code> make_copy(
+    std::shared_ptr<Code> dst,
+    std::shared_ptr<Code> src,
+    std::shared_ptr<Code> bytes,
+    uint32_t width
+) {
+    Step step = [width](uint32_t offset) -> std::shared_ptr<Code> {
+        if (width == 1) {
+            return make_block(
+                {make_lbu(Reg::Result, offset, Reg::Scratch2),
+                 make_sb(Reg::Result, offset, Reg::Scratch)}
+            );
+        }
+        return make_block(
+            {make_lw(Reg::Result, offset, Reg::Scratch2),
+             make_sw(Reg::Result, offset, Reg::Scratch)}
+        );
+    };
+    return block_op(dst, src, bytes, width, step, true);
+}
+
+std::shared_ptr<Code> make_fill(
+    std::shared_ptr<Code> dst,
+    std::shared_ptr<Code> value,
+    std::shared_ptr<Code> bytes,
+    uint32_t width
+) {
+    Step step = [width](uint32_t offset) -> std::shared_ptr<Code> {
+        return width == 1 ? make_sb(Reg::Result, offset, Reg::Scratch)
+                          : make_sw(Reg::Result, offset, Reg::Scratch);
+    };
+    return block_op(dst, value, bytes, width, step, false);
+}
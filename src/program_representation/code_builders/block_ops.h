@@ -0,0 +1,25 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "code.h"
+
+// copies bytes from src to dst front to back, so dst may only overlap src
+// from below, nothing is copied unless bytes is positive. Words are moved
+// with lw and sw unless width is 1, when bytes are moved with lbu and sb
+std::shared_ptr<Code> make_copy(
+    std::shared_ptr<Code> dst,
+    std::shared_ptr<Code> src,
+    std::shared_ptr<Code> bytes,
+    uint32_t width
+);
+// stores value into every word, or byte when width is 1, of bytes at dst
+std::shared_ptr<Code> make_fill(
+    std::shared_ptr<Code> dst,
+    std::shared_ptr<Code> value,
+    std::shared_ptr<Code> bytes,
+    uint32_t width
+);
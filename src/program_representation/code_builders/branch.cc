@@ -0,0 +1,211 @@
+
+#include "branch.h"
+
+#include <vector>
+
+#include "assembly.h"
+#include "beq_label.h"
+#include "bin_op.h"
+#include "block.h"
+#include "bne_label.h"
+#include "define_label.h"
+#include "reg.h"
+#include "word.h"
+
+static std::shared_ptr<Code>
+branch_on_result(std::shared_ptr<Label> target, bool jump_if_nonzero) {
+    if (jump_if_nonzero) {
+        return make_bne(Reg::Result, Reg::Zero, target);
+    }
+    return make_beq(Reg::Result, Reg::Zero, target);
+}
+
+static std::shared_ptr<Code>
+branch_on_equal(std::shared_ptr<Label> target, bool jump_if_equal) {
+    if (jump_if_equal) {
+        return make_beq(Reg::Scratch, Reg::Result, target);
+    }
+    return make_bne(Reg::Scratch, Reg::Result, target);
+}
+
+Branch branch_bool(std::shared_ptr<Code> expr) {
+    return [expr](std::shared_ptr<Label> target, bool jump_if) {
+        return make_block({expr, branch_on_result(target, jump_if)});
+    };
+}
+
+Branch branch_cmp(
+    std::shared_ptr<Code> e1,
+    Comparison comparison,
+    std::shared_ptr<Code> e2
+) {
+    return [e1, comparison, e2](std::shared_ptr<Label> target, bool jump_if) {
+        // bin_op leaves e1 in Scratch and e2 in Result
+        std::shared_ptr<Code> op;
+        switch (comparison) {
+            case Comparison::Eq:
+                op = branch_on_equal(target, jump_if);
+                break;
+            case Comparison::Ne:
+                op = branch_on_equal(target, !jump_if);
+                break;
+            case Comparison::Lt:
+                op = make_block(
+                    {make_slt(Reg::Result, Reg::Scratch, Reg::Result),
+                     branch_on_result(target, jump_if)}
+                );
+                break;
+            case Comparison::Gt:
+                op = make_block(
+                    {make_slt(Reg::Result, Reg::Result, Reg::Scratch),
+                     branch_on_result(target, jump_if)}
+                );
+                break;
+            case Comparison::Le:
+                op = make_block(
+                    {make_slt(Reg::Result, Reg::Result, Reg::Scratch),
+                     branch_on_result(target, !jump_if)}
+                );
+                break;
+            case Comparison::Ge:
+                op = make_block(
+                    {make_slt(Reg::Result, Reg::Scratch, Reg::Result),
+                     branch_on_result(target, !jump_if)}
+                );
+                break;
+        }
+        return bin_op(e1, op, e2);
+    };
+}
+
+Branch branch_and(Branch lhs, Branch rhs) {
+    return [lhs, rhs](std::shared_ptr<Label> target, bool jump_if) {
+        if (!jump_if) {
+            return make_block({lhs(target, false), rhs(target, false)});
+        }
+        std::shared_ptr<Label> skip = std::make_shared<Label>("and skip");
+        return make_block(
+            {lhs(skip, false), rhs(target, true), make_define(skip)}
+        );
+    };
+}
+
+Branch branch_or(Branch lhs, Branch rhs) {
+    return [lhs, rhs](std::shared_ptr<Label> target, bool jump_if) {
+        if (jump_if) {
+            return make_block({lhs(target, true), rhs(target, true)});
+        }
+        std::shared_ptr<Label> skip = std::make_shared<Label>("or skip");
+        return make_block(
+            {lhs(skip, true), rhs(target, false), make_define(skip)}
+        );
+    };
+}
+
+Branch branch_not(Branch expr) {
+    return [expr](std::shared_ptr<Label> target, bool jump_if) {
+        return expr(target, !jump_if);
+    };
+}
+
+std::shared_ptr<Code> branch_value(Branch cond) {
+    std::shared_ptr<Label> false_label =
+        std::make_shared<Label>("branch value false");
+    std::shared_ptr<Label> end_label =
+        std::make_shared<Label>("branch value end");
+    return make_block(
+        {cond(false_label, false),
+         make_lis(Reg::Result),
+         make_word(1),
+         make_beq(Reg::Zero, Reg::Zero, end_label),
+         make_define(false_label),
+         make_add(Reg::Result, Reg::Zero, Reg::Zero),
+         make_define(end_label)}
+    );
+}
+
+std::shared_ptr<Code> make_branch_if(Branch cond, std::shared_ptr<Code> thens) {
+    std::shared_ptr<Label> end_label =
+        std::make_shared<Label>("if stmt end label");
+    return make_block({cond(end_label, false), thens, make_define(end_label)});
+}
+
+std::shared_ptr<Code> make_branch_if(
+    Branch cond,
+    std::shared_ptr<Code> thens,
+    std::shared_ptr<Code> elses,
+    std::string name
+) {
+    std::shared_ptr<Label> then_label = std::make_shared<Label>(name + " then");
+    std::shared_ptr<Label> else_label = std::make_shared<Label>(name + " else");
+    std::shared_ptr<Label> end_label = std::make_shared<Label>(name + " end");
+    return make_block(
+        {cond(else_label, false),
+         make_define(then_label),
+         thens,
+         make_beq(Reg::Zero, Reg::Zero, end_label),
+         make_define(else_label),
+         elses,
+         make_define(end_label)}
+    );
+}
+
+std::shared_ptr<Code> make_branch_if(
+    Branch cond,
+    std::shared_ptr<Code> thens,
+    std::shared_ptr<Code> elses,
+    std::string name,
+    bool hot_thens,
+    std::vector<std::shared_ptr<Code>>& cold
+) {
+    std::shared_ptr<Label> then_label = std::make_shared<Label>(name + " then");
+    std::shared_ptr<Label> else_label = std::make_shared<Label>(name + " else");
+    std::shared_ptr<Label> end_label = std::make_shared<Label>(name + " end");
+    std::shared_ptr<Label> cold_label = hot_thens ? else_label : then_label;
+    cold.push_back(make_block(
+        {make_define(cold_label),
+         hot_thens ? elses : thens,
+         make_beq(Reg::Zero, Reg::Zero, end_label)}
+    ));
+    return make_block(
+        {cond(cold_label, !hot_thens),
+         make_define(hot_thens ? then_label : else_label),
+         hot_thens ? thens : elses,
+         make_define(end_label)}
+    );
+}
+
+std::shared_ptr<Code>
+make_branch_while(Branch cond, std::shared_ptr<Code> body) {
+    std::shared_ptr<Label> top_of_loop =
+        std::make_shared<Label>("top of while loop");
+    std::shared_ptr<Label> loop_test =
+        std::make_shared<Label>("while loop test");
+    return make_block(
+        {make_beq(Reg::Zero, Reg::Zero, loop_test),
+         make_define(top_of_loop),
+         body,
+         make_define(loop_test),
+         cond(top_of_loop, true)}
+    );
+}
+
+std::shared_ptr<Code> make_branch_while(
+    Branch entry_cond,
+    std::shared_ptr<Code> preheader,
+    Branch cond,
+    std::shared_ptr<Code> body
+) {
+    std::shared_ptr<Label> top_of_loop =
+        std::make_shared<Label>("top of while loop");
+    std::shared_ptr<Label> end_of_loop =
+        std::make_shared<Label>("end of while loop");
+    return make_block(
+        {entry_cond(end_of_loop, false),
+         preheader,
+         make_define(top_of_loop),
+         body,
+         cond(top_of_loop, true),
+         make_define(end_of_loop)}
+    );
+}
@@ -0,0 +1,63 @@
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "code.h"
+#include "label.h"
+
+enum class Comparison { Eq, Ne, Lt, Gt, Le, Ge };
+
+// a condition in branch context: produces code that branches to target when
+// the condition evaluates to jump_if and falls through otherwise
+using Branch = std::function<
+    std::shared_ptr<Code>(std::shared_ptr<Label> target, bool jump_if)>;
+
+// any boolean expression, tested after evaluating it into Result
+Branch branch_bool(std::shared_ptr<Code> expr);
+Branch branch_cmp(
+    std::shared_ptr<Code> e1,
+    Comparison comparison,
+    std::shared_ptr<Code> e2
+);
+// short circuiting, rhs is only evaluated when lhs does not decide
+Branch branch_and(Branch lhs, Branch rhs);
+Branch branch_or(Branch lhs, Branch rhs);
+Branch branch_not(Branch expr);
+
+// materializes the condition as 0 or 1 in Result
+std::shared_ptr<Code> branch_value(Branch cond);
+
+std::shared_ptr<Code> make_branch_if(Branch cond, std::shared_ptr<Code> thens);
+// the labels starting each side are named after name, so that a profile
+// can tell how often each side runs
+std::shared_ptr<Code> make_branch_if(
+    Branch cond,
+    std::shared_ptr<Code> thens,
+    std::shared_ptr<Code> elses,
+    std::string name
+);
+// moves the side that runs less often out of line into cold, from where it
+// jumps back, so the common side falls through without a jump
+std::shared_ptr<Code> make_branch_if(
+    Branch cond,
+    std::shared_ptr<Code> thens,
+    std::shared_ptr<Code> elses,
+    std::string name,
+    bool hot_thens,
+    std::vector<std::shared_ptr<Code>>& cold
+);
+// tests the condition at the bottom of the loop, one branch per iteration
+std::shared_ptr<Code>
+make_branch_while(Branch cond, std::shared_ptr<Code> body);
+// guards the loop with its own test so that preheader only runs when the
+// loop is entered
+std::shared_ptr<Code> make_branch_while(
+    Branch entry_cond,
+    std::shared_ptr<Code> preheader,
+    Branch cond,
+    std::shared_ptr<Code> body
+);
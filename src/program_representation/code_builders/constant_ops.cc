@@ -0,0 +1,84 @@
+
+#include "constant_ops.h"
+
+#include <vector>
+
+#include "assembly.h"
+#include "block.h"
+#include "operators.h"
+#include "pseudo_assembly.h"
+#include "reg.h"
+
+// a multiply is only replaced by adds when it takes no more instructions
+// than copying the operand, loading the constant and mult with mflo
+static const size_t max_add_chain = 4;
+
+// the general form, which instruction selection may still reduce further
+static std::shared_ptr<Code> with_constant(
+    std::shared_ptr<Code> expr,
+    int32_t c,
+    std::shared_ptr<Code> op
+) {
+    return make_block(
+        {expr,
+         make_add(Reg::Scratch, Reg::Result, Reg::Zero),
+         int_literal(c),
+         op}
+    );
+}
+
+std::shared_ptr<Code> times_constant(std::shared_ptr<Code> expr, int32_t c) {
+    if (c == 0) {
+        return make_block({expr, make_add(Reg::Result, Reg::Zero, Reg::Zero)});
+    }
+    if (c == INT32_MIN) {
+        return with_constant(expr, c, op::times());
+    }
+
+    // shift and add from the most significant bit down, keeping the
+    // operand in Scratch when there are bits to add back in
+    uint32_t m = c < 0 ? -c : c;
+    bool power_of_two = (m & (m - 1)) == 0;
+    uint32_t top = 31;
+    while (((m >> top) & 1) == 0) {
+        top -= 1;
+    }
+
+    std::vector<std::shared_ptr<Code>> code = {expr};
+    if (!power_of_two) {
+        code.push_back(make_add(Reg::Scratch, Reg::Result, Reg::Zero));
+    }
+    for (uint32_t bit = top; bit-- > 0;) {
+        code.push_back(make_add(Reg::Result, Reg::Result, Reg::Result));
+        if ((m >> bit) & 1) {
+            code.push_back(make_add(Reg::Result, Reg::Result, Reg::Scratch));
+        }
+    }
+    if (c < 0) {
+        code.push_back(make_sub(Reg::Result, Reg::Zero, Reg::Result));
+    }
+
+    if (code.size() - 1 > max_add_chain) {
+        return with_constant(expr, c, op::times());
+    }
+    return make_block(code);
+}
+
+std::shared_ptr<Code> divide_constant(std::shared_ptr<Code> expr, int32_t c) {
+    if (c == 1) {
+        return expr;
+    }
+    if (c == -1) {
+        return make_block({expr, make_sub(Reg::Result, Reg::Zero, Reg::Result)}
+        );
+    }
+    return with_constant(expr, c, op::divide());
+}
+
+std::shared_ptr<Code>
+remainder_constant(std::shared_ptr<Code> expr, int32_t c) {
+    if (c == 1 || c == -1) {
+        return make_block({expr, make_add(Reg::Result, Reg::Zero, Reg::Zero)});
+    }
+    return with_constant(expr, c, op::remainder());
+}
@@ -0,0 +1,15 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "code.h"
+
+// arithmetic with a constant operand, expr is evaluated into Result and the
+// operation applied in place without spilling it to a variable first
+std::shared_ptr<Code> times_constant(std::shared_ptr<Code> expr, int32_t c);
+std::shared_ptr<Code> divide_constant(std::shared_ptr<Code> expr, int32_t c);
+std::shared_ptr<Code>
+remainder_constant(std::shared_ptr<Code> expr, int32_t c);
@@ -3,14 +3,17 @@
 
 Call::Call(
     std::shared_ptr<Procedure> procedure,
-    std::vector<std::shared_ptr<Code>> arguments
+    std::vector<std::shared_ptr<Code>> arguments,
+    bool tail_call
 ) :
     procedure {procedure},
-    arguments {arguments} {}
+    arguments {arguments},
+    tail_call {tail_call} {}
 
 std::shared_ptr<Code> make_call(
     std::shared_ptr<Procedure> procedure,
-    std::vector<std::shared_ptr<Code>> arguments
+    std::vector<std::shared_ptr<Code>> arguments,
+    bool tail_call
 ) {
-    return std::make_shared<Call>(procedure, arguments);
+    return std::make_shared<Call>(procedure, arguments, tail_call);
 }
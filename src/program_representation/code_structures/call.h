@@ -11,13 +11,17 @@
 struct Call: CodeVisit<Call> {
     std::shared_ptr<Procedure> procedure;
     std::vector<std::shared_ptr<Code>> arguments;
+    // replaces the caller's frame and never returns to it
+    bool tail_call;
     explicit Call(
         std::shared_ptr<Procedure> procedure,
-        std::vector<std::shared_ptr<Code>> arguments
+        std::vector<std::shared_ptr<Code>> arguments,
+        bool tail_call = false
     );
 };
 
 std::shared_ptr<Code> make_call(
     std::shared_ptr<Procedure> procedure,
-    std::vector<std::shared_ptr<Code>> arguments
+    std::vector<std::shared_ptr<Code>> arguments,
+    bool tail_call = false
 );
@@ -1,7 +1,10 @@
 
 #include "procedure.h"
 
+#include <algorithm>
+
 #include "label.h"
+#include "reg.h"
 #include "variable.h"
 
 Procedure::Procedure(
@@ -10,9 +13,21 @@ Procedure::Procedure(
 ) :
     name {name},
     parameters {parameters} {
-    param_ptr = std::make_shared<Variable>("param ptr for " + name);
     dynamic_link = std::make_shared<Variable>("dynamic link for " + name);
     saved_pc = std::make_shared<Variable>("saved pc for " + name);
     start_label = std::make_shared<Label>("procedure " + name);
     end_label = std::make_shared<Label>("procedure " + name + " end");
+    tail_call_label =
+        std::make_shared<Label>("procedure " + name + " tail call");
+    body_label = std::make_shared<Label>("procedure " + name + " body");
+}
+
+std::vector<std::shared_ptr<Variable>> Procedure::register_parameters() {
+    size_t count = std::min(parameters.size(), arg_regs.size());
+    return {parameters.begin(), parameters.begin() + count};
+}
+
+std::vector<std::shared_ptr<Variable>> Procedure::stack_parameters() {
+    size_t count = std::min(parameters.size(), arg_regs.size());
+    return {parameters.begin() + count, parameters.end()};
 }
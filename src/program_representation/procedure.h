@@ -16,14 +16,22 @@ struct Variable;
 struct Procedure {
     std::string name;
     std::vector<std::shared_ptr<Variable>> parameters;
-    std::shared_ptr<Variable> param_ptr;
     std::shared_ptr<Variable> dynamic_link;
     std::shared_ptr<Variable> saved_pc;
     std::shared_ptr<Label> start_label;
     std::shared_ptr<Label> end_label;
+    // exit that pops the frame and jumps to TargetPC instead of returning
+    std::shared_ptr<Label> tail_call_label;
+    // starts the body and every inlined copy of it, so that a profile
+    // counts each run of the procedure
+    std::shared_ptr<Label> body_label;
     std::shared_ptr<Code> code;
     Procedure(
         std::string name,
         std::vector<std::shared_ptr<Variable>> parameters
     );
+
+    // parameters passed in argument registers, the rest go on the stack
+    std::vector<std::shared_ptr<Variable>> register_parameters();
+    std::vector<std::shared_ptr<Variable>> stack_parameters();
 };
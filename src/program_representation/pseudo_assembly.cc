@@ -48,3 +48,24 @@ std::shared_ptr<Code> assign_to_address(
 std::shared_ptr<Code> deref(std::shared_ptr<Code> expr, uint32_t offset) {
     return make_block({expr, make_lw(Reg::Result, offset, Reg::Result)});
 }
+
+std::shared_ptr<Code> assign_to_byte_address(
+    std::shared_ptr<Code> addr,
+    std::shared_ptr<Code> expr,
+    uint32_t offset
+) {
+    std::shared_ptr<Variable> var =
+        std::make_shared<Variable>("assign to byte addr");
+    return make_scope(
+        {var},
+        {assign(var, addr),
+         expr,
+         make_read(Reg::Scratch, var),
+         make_sb(Reg::Result, offset, Reg::Scratch)}
+    );
+}
+
+std::shared_ptr<Code>
+deref_byte(std::shared_ptr<Code> expr, uint32_t offset) {
+    return make_block({expr, make_lbu(Reg::Result, offset, Reg::Result)});
+}
@@ -21,3 +21,11 @@ std::shared_ptr<Code> assign_to_address(
     uint32_t offset = 0
 );
 std::shared_ptr<Code> deref(std::shared_ptr<Code> expr, uint32_t offset = 0);
+// single byte versions of the above, zero extending on load
+std::shared_ptr<Code> assign_to_byte_address(
+    std::shared_ptr<Code> addr,
+    std::shared_ptr<Code> expr,
+    uint32_t offset = 0
+);
+std::shared_ptr<Code>
+deref_byte(std::shared_ptr<Code> expr, uint32_t offset = 0);
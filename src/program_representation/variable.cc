@@ -4,7 +4,9 @@
 #include "reg.h"
 #include "var_access.h"
 
-Variable::Variable(std::string name) : name {name} {}
+Variable::Variable(std::string name, uint32_t words) :
+    name {name},
+    words {words} {}
 
 std::shared_ptr<Code> Variable::to_expr(bool read_address) {
     if (read_address) {
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
@@ -8,6 +10,9 @@
 
 struct Variable: std::enable_shared_from_this<Variable> {
     std::string name;
-    explicit Variable(std::string name);
+    // words taken in a frame, objects placed there rather than on the heap
+    // take more than one and are only used through their address
+    uint32_t words;
+    explicit Variable(std::string name, uint32_t words = 1);
     std::shared_ptr<Code> to_expr(bool read_address = false);
 };
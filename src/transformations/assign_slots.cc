@@ -0,0 +1,147 @@
+
+#include "assign_slots.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <set>
+
+#include "control_flow.h"
+#include "flatten.h"
+#include "var_access.h"
+
+std::map<std::shared_ptr<Variable>, uint32_t> assign_slots(
+    std::shared_ptr<Code> code,
+    std::vector<std::shared_ptr<Variable>> variables
+) {
+    std::map<std::shared_ptr<Variable>, uint32_t> result;
+    std::map<std::shared_ptr<Variable>, size_t> index;
+    for (size_t i = 0; i < variables.size(); ++i) {
+        index[variables.at(i)] = i;
+    }
+
+    Flatten flatten;
+    code->accept(flatten);
+    std::vector<std::shared_ptr<Code>> instrs = flatten.get();
+
+    // lifetimes cannot be followed through branches with hardcoded offsets
+    // or pointers, so those variables are never shared
+    auto maybe_successors = successors(instrs);
+    std::vector<bool> pinned(variables.size(), !maybe_successors);
+    for (size_t i = 0; i < variables.size(); ++i) {
+        if (variables.at(i)->words > 1) {
+            pinned.at(i) = true;
+        }
+    }
+    for (auto& instr : instrs) {
+        auto var_access = std::dynamic_pointer_cast<VarAccess>(instr);
+        if (var_access && var_access->var_access_type == VarAccessType::Address
+            && index.contains(var_access->variable)) {
+            pinned.at(index.at(var_access->variable)) = true;
+        }
+    }
+
+    std::vector<std::set<size_t>> interferes(variables.size());
+    if (maybe_successors) {
+        auto& successors = *maybe_successors;
+
+        // backward dataflow over live variables, sets only grow so this
+        // terminates
+        std::vector<std::set<size_t>> live_in(instrs.size());
+        std::vector<std::set<size_t>> live_out(instrs.size());
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = instrs.size(); i-- > 0;) {
+                for (size_t succ : successors.at(i)) {
+                    live_out.at(i).insert(
+                        live_in.at(succ).begin(),
+                        live_in.at(succ).end()
+                    );
+                }
+                std::set<size_t> live = live_out.at(i);
+                auto var_access =
+                    std::dynamic_pointer_cast<VarAccess>(instrs.at(i));
+                if (var_access && index.contains(var_access->variable)) {
+                    size_t var = index.at(var_access->variable);
+                    if (var_access->var_access_type == VarAccessType::Write) {
+                        live.erase(var);
+                    } else {
+                        live.insert(var);
+                    }
+                }
+                if (live.size() != live_in.at(i).size()) {
+                    live_in.at(i) = live;
+                    changed = true;
+                }
+            }
+        }
+
+        // a write clobbers the slot of everything else live past it
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            auto var_access =
+                std::dynamic_pointer_cast<VarAccess>(instrs.at(i));
+            if (!var_access || !index.contains(var_access->variable)
+                || var_access->var_access_type != VarAccessType::Write) {
+                continue;
+            }
+            size_t var = index.at(var_access->variable);
+            for (size_t other : live_out.at(i)) {
+                if (other != var) {
+                    interferes.at(var).insert(other);
+                    interferes.at(other).insert(var);
+                }
+            }
+        }
+        // variables live on entry are all written before code starts
+        if (!instrs.empty()) {
+            for (size_t var : live_in.at(0)) {
+                for (size_t other : live_in.at(0)) {
+                    if (other != var) {
+                        interferes.at(var).insert(other);
+                    }
+                }
+            }
+        }
+    }
+
+    // greedy coloring in declaration order, pinned variables after the
+    // shared slots
+    uint32_t shared_slots = 0;
+    std::vector<uint32_t> slot(variables.size());
+    for (size_t var = 0; var < variables.size(); ++var) {
+        if (pinned.at(var)) {
+            continue;
+        }
+        std::set<uint32_t> taken;
+        for (size_t other : interferes.at(var)) {
+            if (other < var && !pinned.at(other)) {
+                taken.insert(slot.at(other));
+            }
+        }
+        uint32_t free_slot = 0;
+        while (taken.contains(free_slot)) {
+            ++free_slot;
+        }
+        slot.at(var) = free_slot;
+        shared_slots = std::max(shared_slots, free_slot + 1);
+    }
+    uint32_t next_slot = shared_slots;
+    for (size_t var = 0; var < variables.size(); ++var) {
+        if (pinned.at(var)) {
+            slot.at(var) = next_slot;
+            next_slot += variables.at(var)->words;
+        }
+        result[variables.at(var)] = slot.at(var);
+    }
+    return result;
+}
+
+uint32_t slot_count(const std::map<std::shared_ptr<Variable>, uint32_t>& slots
+) {
+    uint32_t result = 0;
+    for (auto& [variable, slot] : slots) {
+        result = std::max(result, slot + variable->words);
+    }
+    return result;
+}
@@ -0,0 +1,26 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "code.h"
+#include "variable.h"
+
+// gives each of variables a slot such that variables sharing a slot are
+// never live at the same time, variables whose address is taken get a slot
+// of their own and variables of several words a run of them; code must
+// have had its scopes, if and return statements eliminated, variables live
+// where code starts must be written before it (zeroed or assigned) and are
+// kept apart
+std::map<std::shared_ptr<Variable>, uint32_t> assign_slots(
+    std::shared_ptr<Code> code,
+    std::vector<std::shared_ptr<Variable>> variables
+);
+
+// number of slots used by an assignment
+uint32_t slot_count(const std::map<std::shared_ptr<Variable>, uint32_t>& slots
+);
@@ -0,0 +1,51 @@
+
+#include "control_flow.h"
+
+#include <stdint.h>
+
+#include <map>
+
+#include "beq_label.h"
+#include "bne_label.h"
+#include "define_label.h"
+#include "label.h"
+#include "reg.h"
+#include "word.h"
+
+std::optional<std::vector<std::vector<size_t>>>
+successors(const std::vector<std::shared_ptr<Code>>& instrs) {
+    std::map<std::shared_ptr<Label>, size_t> label_index;
+    for (size_t i = 0; i < instrs.size(); ++i) {
+        auto instr = instrs.at(i);
+        if (auto define_label = std::dynamic_pointer_cast<DefineLabel>(instr)) {
+            label_index[define_label->label] = i;
+        } else if (auto word = std::dynamic_pointer_cast<Word>(instr)) {
+            uint32_t opcode = word->bits >> 26;
+            if (opcode == 0b000100 || opcode == 0b000101) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> result(instrs.size());
+    for (size_t i = 0; i < instrs.size(); ++i) {
+        auto instr = instrs.at(i);
+        std::shared_ptr<Label> target;
+        bool falls_through = true;
+        if (auto beq_label = std::dynamic_pointer_cast<BeqLabel>(instr)) {
+            target = beq_label->label;
+            falls_through =
+                beq_label->s != Reg::Zero || beq_label->t != Reg::Zero;
+        } else if (auto bne_label = std::dynamic_pointer_cast<BneLabel>(instr)
+        ) {
+            target = bne_label->label;
+        }
+        if (target && label_index.contains(target)) {
+            result.at(i).push_back(label_index.at(target));
+        }
+        if (falls_through && i + 1 < instrs.size()) {
+            result.at(i).push_back(i + 1);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,16 @@
+
+#pragma once
+
+#include <stddef.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "code.h"
+
+// indices of the instructions each instruction of flattened code may run
+// next, labels defined outside of code (the procedure end) leave it;
+// nullopt when branches with hardcoded offsets make this unknowable
+std::optional<std::vector<std::vector<size_t>>>
+successors(const std::vector<std::shared_ptr<Code>>& instrs);
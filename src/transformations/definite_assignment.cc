@@ -0,0 +1,96 @@
+
+#include "definite_assignment.h"
+
+#include "control_flow.h"
+#include "flatten.h"
+#include "var_access.h"
+
+std::set<std::shared_ptr<Variable>> maybe_unassigned(
+    std::shared_ptr<Code> code,
+    std::vector<std::shared_ptr<Variable>> assigned
+) {
+    Flatten flatten;
+    code->accept(flatten);
+    std::vector<std::shared_ptr<Code>> instrs = flatten.get();
+
+    std::set<std::shared_ptr<Variable>> result;
+    for (auto& instr : instrs) {
+        if (auto var_access = std::dynamic_pointer_cast<VarAccess>(instr)) {
+            // accesses through a taken address are not visible here
+            if (var_access->var_access_type != VarAccessType::Write) {
+                result.insert(var_access->variable);
+            }
+        }
+    }
+
+    // branches with hardcoded offsets cannot be followed, so any variable
+    // that is read at all may be read unassigned
+    auto maybe_successors = successors(instrs);
+    if (!maybe_successors) {
+        return result;
+    }
+    auto& successors = *maybe_successors;
+
+    // forward dataflow over definitely assigned variables, sets only shrink
+    // from the first time an instruction is reached so this terminates
+    std::vector<std::set<std::shared_ptr<Variable>>> assigned_before(
+        instrs.size()
+    );
+    std::vector<bool> reached(instrs.size(), false);
+    if (!instrs.empty()) {
+        assigned_before.at(0).insert(assigned.begin(), assigned.end());
+        reached.at(0) = true;
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            if (!reached.at(i)) {
+                continue;
+            }
+            std::set<std::shared_ptr<Variable>> assigned_after =
+                assigned_before.at(i);
+            auto var_access =
+                std::dynamic_pointer_cast<VarAccess>(instrs.at(i));
+            if (var_access
+                && var_access->var_access_type == VarAccessType::Write) {
+                assigned_after.insert(var_access->variable);
+            }
+
+            for (size_t succ : successors.at(i)) {
+                if (!reached.at(succ)) {
+                    reached.at(succ) = true;
+                    assigned_before.at(succ) = assigned_after;
+                    changed = true;
+                    continue;
+                }
+                std::set<std::shared_ptr<Variable>> meet;
+                for (auto& variable : assigned_before.at(succ)) {
+                    if (assigned_after.contains(variable)) {
+                        meet.insert(variable);
+                    }
+                }
+                if (meet.size() != assigned_before.at(succ).size()) {
+                    assigned_before.at(succ) = meet;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    result.clear();
+    for (size_t i = 0; i < instrs.size(); ++i) {
+        auto var_access = std::dynamic_pointer_cast<VarAccess>(instrs.at(i));
+        if (!var_access) {
+            continue;
+        }
+        if (var_access->var_access_type == VarAccessType::Address
+            || (var_access->var_access_type == VarAccessType::Read
+                && reached.at(i)
+                && !assigned_before.at(i).contains(var_access->variable))) {
+            result.insert(var_access->variable);
+        }
+    }
+    return result;
+}
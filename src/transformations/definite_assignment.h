@@ -0,0 +1,18 @@
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "code.h"
+#include "variable.h"
+
+// variables of code that may be read before they are written on some path
+// from its start, where assigned are written before code runs; only these
+// need to be zero initialized, code must have had its scopes, if and return
+// statements eliminated
+std::set<std::shared_ptr<Variable>> maybe_unassigned(
+    std::shared_ptr<Code> code,
+    std::vector<std::shared_ptr<Variable>> assigned
+);
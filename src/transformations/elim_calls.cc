@@ -1,32 +1,35 @@
 
 #include "elim_calls.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <string>
 #include <vector>
 
 #include "assembly.h"
+#include "beq_label.h"
 #include "block.h"
 #include "pseudo_assembly.h"
 #include "reg.h"
 #include "scope.h"
-#include "stack.h"
 #include "use_label.h"
 #include "var_access.h"
 #include "variable.h"
 
-class Chunk;
-
-ElimCalls::ElimCalls(
-    std::shared_ptr<Procedure> current_procedure,
-    std::map<std::shared_ptr<Procedure>, std::shared_ptr<Chunk>> param_chunks
-) :
-    current_procedure {current_procedure},
-    param_chunks {param_chunks} {}
+ElimCalls::ElimCalls(std::shared_ptr<Procedure> current_procedure) :
+    current_procedure {current_procedure} {}
 
 std::shared_ptr<Code> ElimCalls::visit(std::shared_ptr<Call> call) {
     std::shared_ptr<Procedure> caller = current_procedure;
     std::shared_ptr<Procedure> callee = call->procedure;
     std::vector<std::shared_ptr<Code>> arguments = call->arguments;
+    size_t stack_args = callee->stack_parameters().size();
+
+    // arguments are evaluated into temporaries first since calls within
+    // later arguments clobber the argument registers and the stack, only the
+    // last register argument can be moved into place directly
+    bool direct_last = stack_args == 0 && !arguments.empty();
 
     std::vector<std::shared_ptr<Variable>> tmp_vars;
     for (auto var : callee->parameters) {
@@ -34,8 +37,9 @@ std::shared_ptr<Code> ElimCalls::visit(std::shared_ptr<Call> call) {
             "tmp for " + current_procedure->name + "." + var->name
         ));
     }
-
-    std::shared_ptr<Chunk> param_chunk = param_chunks.at(callee);
+    if (direct_last) {
+        tmp_vars.pop_back();
+    }
 
     std::vector<std::shared_ptr<Code>> assign_to_tmps;
 
@@ -46,27 +50,48 @@ std::shared_ptr<Code> ElimCalls::visit(std::shared_ptr<Call> call) {
         arg++;
         tmp1++;
     }
+    if (direct_last) {
+        assign_to_tmps.push_back(make_block(
+            {arguments.back()->accept(*this),
+             make_add(arg_regs.at(tmp_vars.size()), Reg::Result, Reg::Zero)}
+        ));
+    }
 
-    std::vector<std::shared_ptr<Code>> tmps_to_chunk;
+    // stack arguments go right below the stack pointer in order, where the
+    // callee allocates the end of its frame over them
+    std::vector<std::shared_ptr<Code>> tmps_to_stack;
 
-    auto tmp2 = tmp_vars.begin();
-    auto param = param_chunk->variables.begin();
-    while (tmp2 != tmp_vars.end() && param != param_chunk->variables.end()) {
-        tmps_to_chunk.push_back(make_block(
-            {make_read(Reg::Scratch2, *tmp2),
-             param_chunk->store(Reg::Result, *param, Reg::Scratch2)}
+    for (size_t i = 0; i < stack_args; ++i) {
+        int32_t offset = -4 * static_cast<int32_t>(stack_args - i);
+        tmps_to_stack.push_back(make_block(
+            {make_read(Reg::Scratch2, tmp_vars.at(arg_regs.size() + i)),
+             make_sw(Reg::Scratch2, (uint16_t)offset, Reg::StackPtr)}
         ));
-        tmp2++;
-        param++;
     }
 
+    std::vector<std::shared_ptr<Code>> tmps_to_regs;
+
+    auto tmp3 = tmp_vars.begin();
+    auto reg = arg_regs.begin();
+    while (tmp3 != tmp_vars.end() && reg != arg_regs.end()) {
+        tmps_to_regs.push_back(make_read(*reg, *tmp3));
+        tmp3++;
+        reg++;
+    }
+
+    // a tail call leaves through the caller's exit, which pops its frame and
+    // jumps to TargetPC with the caller's return address still in Link
+    std::shared_ptr<Code> jump = call->tail_call
+        ? make_beq(Reg::Zero, Reg::Zero, caller->tail_call_label)
+        : make_jalr(Reg::TargetPC);
+
     return make_scope(
         tmp_vars,
         {make_block(assign_to_tmps),
-         stack::allocate(param_chunk),
-         make_block(tmps_to_chunk),
+         make_block(tmps_to_stack),
+         make_block(tmps_to_regs),
          make_lis(Reg::TargetPC),
          make_use(callee->start_label),
-         make_jalr(Reg::TargetPC)}
+         jump}
     );
 }
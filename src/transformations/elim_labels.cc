@@ -12,18 +12,18 @@
 #include "beq_label.h"
 #include "bne_label.h"
 #include "define_label.h"
+#include "label.h"
+#include "reg.h"
 #include "use_label.h"
 #include "word.h"
 
-struct Label;
-
 template<uint32_t N>
 uint32_t signed_sub(uint32_t a, uint32_t b) {
     return (uint32_t)((int32_t)a - (int32_t)b) & ((1 << N) - 1);
 }
 
-std::vector<std::shared_ptr<Code>>
-elim_labels(std::vector<std::shared_ptr<Code>> program) {
+static std::map<std::shared_ptr<Label>, uint32_t>
+label_addresses(const std::vector<std::shared_ptr<Code>>& program) {
     std::map<std::shared_ptr<Label>, uint32_t> symbol_table;
 
     uint32_t address = 0;
@@ -41,6 +41,111 @@ elim_labels(std::vector<std::shared_ptr<Code>> program) {
         }
     }
 
+    return symbol_table;
+}
+
+// whether a branch at location can reach target with its 16 bit offset
+static bool in_branch_range(uint32_t target, uint32_t location) {
+    int32_t offset = (int32_t)(target / 4) - (int32_t)(location / 4 + 1);
+    return offset >= INT16_MIN && offset <= INT16_MAX;
+}
+
+// replaces a branch to label with the inverted branch around a long jump
+static std::vector<std::shared_ptr<Code>>
+long_branch(Reg s, Reg t, std::shared_ptr<Label> label, bool equal) {
+    auto skip = std::make_shared<Label>("long branch skip");
+    std::shared_ptr<Code> inverted;
+    if (equal) {
+        inverted = make_bne(s, t, skip);
+    } else {
+        inverted = make_beq(s, t, skip);
+    }
+    // Scratch3 is never live across a branch
+    return {
+        inverted,
+        make_lis(Reg::Scratch3),
+        make_use(label),
+        make_jr(Reg::Scratch3),
+        make_define(skip)};
+}
+
+// rewrites branches that cannot reach their label until all of them can,
+// each rewrite only grows the program so this reaches a fixed point
+static std::vector<std::shared_ptr<Code>>
+relax_branches(std::vector<std::shared_ptr<Code>> program) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        auto symbol_table = label_addresses(program);
+
+        std::vector<std::shared_ptr<Code>> result;
+        uint32_t location = 0;
+        for (auto& code : program) {
+            std::vector<std::shared_ptr<Code>> replacement;
+            if (std::shared_ptr<BeqLabel> beq_label =
+                    std::dynamic_pointer_cast<BeqLabel>(code)) {
+                if (symbol_table.count(beq_label->label)
+                    && !in_branch_range(
+                        symbol_table.at(beq_label->label),
+                        location
+                    )) {
+                    replacement = long_branch(
+                        beq_label->s,
+                        beq_label->t,
+                        beq_label->label,
+                        true
+                    );
+                }
+            } else if (std::shared_ptr<BneLabel> bne_label =
+                           std::dynamic_pointer_cast<BneLabel>(code)) {
+                if (symbol_table.count(bne_label->label)
+                    && !in_branch_range(
+                        symbol_table.at(bne_label->label),
+                        location
+                    )) {
+                    replacement = long_branch(
+                        bne_label->s,
+                        bne_label->t,
+                        bne_label->label,
+                        false
+                    );
+                }
+            }
+
+            if (!std::dynamic_pointer_cast<DefineLabel>(code)) {
+                location += 4;
+            }
+            if (replacement.empty()) {
+                result.push_back(code);
+            } else {
+                result.insert(
+                    result.end(),
+                    replacement.begin(),
+                    replacement.end()
+                );
+                changed = true;
+            }
+        }
+        program = result;
+    }
+
+    return program;
+}
+
+std::vector<std::shared_ptr<Code>>
+elim_labels(std::vector<std::shared_ptr<Code>> program) {
+    std::map<std::shared_ptr<Label>, uint32_t> addresses;
+    return elim_labels(program, addresses);
+}
+
+std::vector<std::shared_ptr<Code>> elim_labels(
+    std::vector<std::shared_ptr<Code>> program,
+    std::map<std::shared_ptr<Label>, uint32_t>& addresses
+) {
+    program = relax_branches(program);
+    auto symbol_table = label_addresses(program);
+    addresses = symbol_table;
+
     std::vector<std::shared_ptr<Code>> result;
     uint32_t location = 0;
     for (auto& code : program) {
@@ -52,7 +157,8 @@ elim_labels(std::vector<std::shared_ptr<Code>> program) {
         if (std::shared_ptr<Word> word =
                 std::dynamic_pointer_cast<Word>(code)) {
             result.push_back(word);
-        } else if (std::shared_ptr<UseLabel> use_label = std::dynamic_pointer_cast<UseLabel>(code)) {
+        } else if (std::shared_ptr<UseLabel> use_label =
+                       std::dynamic_pointer_cast<UseLabel>(code)) {
             if (symbol_table.find(use_label->label) != symbol_table.end()) {
                 result.push_back(make_word(symbol_table.at(use_label->label)));
             } else {
@@ -63,7 +169,8 @@ elim_labels(std::vector<std::shared_ptr<Code>> program) {
                     << std::endl;
                 exit(1);
             }
-        } else if (std::shared_ptr<BeqLabel> beq_label = std::dynamic_pointer_cast<BeqLabel>(code)) {
+        } else if (std::shared_ptr<BeqLabel> beq_label =
+                       std::dynamic_pointer_cast<BeqLabel>(code)) {
             if (symbol_table.count(beq_label->label)) {
                 result.push_back(make_beq(
                     beq_label->s,
@@ -81,7 +188,8 @@ elim_labels(std::vector<std::shared_ptr<Code>> program) {
                     << std::endl;
                 exit(1);
             }
-        } else if (std::shared_ptr<BneLabel> bne_label = std::dynamic_pointer_cast<BneLabel>(code)) {
+        } else if (std::shared_ptr<BneLabel> bne_label =
+                       std::dynamic_pointer_cast<BneLabel>(code)) {
             if (symbol_table.count(bne_label->label)) {
                 result.push_back(make_bne(
                     bne_label->s,
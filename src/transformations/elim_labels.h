@@ -1,10 +1,19 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <map>
 #include <memory>
 #include <vector>
 
 #include "code.h"
+#include "label.h"
 
 std::vector<std::shared_ptr<Code>>
 elim_labels(std::vector<std::shared_ptr<Code>> program);
+// also gives the address each label ended up at
+std::vector<std::shared_ptr<Code>> elim_labels(
+    std::vector<std::shared_ptr<Code>> program,
+    std::map<std::shared_ptr<Label>, uint32_t>& addresses
+);
@@ -0,0 +1,94 @@
+
+#include "elim_tail_calls.h"
+
+#include <vector>
+
+#include "beq_label.h"
+#include "block.h"
+#include "call.h"
+#include "pseudo_assembly.h"
+#include "reg.h"
+#include "scope.h"
+#include "var_access.h"
+#include "variable.h"
+
+namespace {
+// whether the address of any variable is taken, as frame objects and & do
+class TakesAddress: public Visitor<void> {
+  public:
+    bool result = false;
+
+    void visit(std::shared_ptr<VarAccess> var_access) override {
+        if (var_access->var_access_type == VarAccessType::Address) {
+            result = true;
+        }
+    }
+};
+}  // namespace
+
+ElimTailCalls::ElimTailCalls(std::shared_ptr<Procedure> proc) :
+    proc {proc} {
+    restart_label =
+        std::make_shared<Label>("procedure " + proc->name + " restart");
+
+    TakesAddress takes_address;
+    proc->code->accept(takes_address);
+    points_into_frame = takes_address.result;
+}
+
+std::shared_ptr<Code> ElimTailCalls::visit(std::shared_ptr<RetStmt> ret_stmt
+) {
+    auto call = std::dynamic_pointer_cast<Call>(ret_stmt->code);
+    if (!call) {
+        return Visitor<std::shared_ptr<Code>>::visit(ret_stmt);
+    }
+    // an argument may point into the frame, which must outlive the call
+    if (points_into_frame) {
+        return ret_stmt;
+    }
+
+    std::shared_ptr<Procedure> callee = call->procedure;
+    if (callee != proc) {
+        // the frame is gone before the callee runs, so there is nowhere to
+        // keep a chunk of stack arguments
+        if (callee->stack_parameters().empty()) {
+            replaces_frame = true;
+            return make_call(callee, call->arguments, true);
+        }
+        return ret_stmt;
+    }
+
+    // every argument is evaluated before any parameter is overwritten, the
+    // last one directly into its parameter
+    std::vector<std::shared_ptr<Variable>> tmp_vars;
+    std::vector<std::shared_ptr<Code>> code;
+    for (size_t i = 0; i + 1 < call->arguments.size(); ++i) {
+        auto tmp = std::make_shared<Variable>(
+            "tmp for " + proc->name + "." + proc->parameters.at(i)->name
+        );
+        tmp_vars.push_back(tmp);
+        code.push_back(assign(tmp, call->arguments.at(i)));
+    }
+    if (!call->arguments.empty()) {
+        code.push_back(
+            assign(proc->parameters.back(), call->arguments.back())
+        );
+    }
+    for (size_t i = 0; i < tmp_vars.size(); ++i) {
+        code.push_back(
+            assign(proc->parameters.at(i), tmp_vars.at(i)->to_expr())
+        );
+    }
+    code.push_back(make_beq(Reg::Zero, Reg::Zero, restart_label));
+
+    restarts = true;
+    return make_scope(tmp_vars, code);
+}
+
+std::shared_ptr<Label> ElimTailCalls::get() {
+    return restarts ? restart_label : nullptr;
+}
+
+bool ElimTailCalls::tail_calls() {
+    return replaces_frame;
+}
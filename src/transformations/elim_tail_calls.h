@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include <memory>
+
+#include "code.h"
+#include "label.h"
+#include "procedure.h"
+#include "ret_stmt.h"
+#include "visitor.h"
+
+// turns returns of calls into tail calls, self calls become a jump back to
+// restart_label, which must be defined at the start of the procedure body,
+// and calls to procedures without stack parameters replace the frame.
+// Procedures that take the address of a variable keep their calls
+class ElimTailCalls: public Visitor<std::shared_ptr<Code>> {
+    std::shared_ptr<Procedure> proc;
+    std::shared_ptr<Label> restart_label;
+    bool restarts = false;
+    bool replaces_frame = false;
+    bool points_into_frame = false;
+
+  public:
+    explicit ElimTailCalls(std::shared_ptr<Procedure> proc);
+    std::shared_ptr<Code> visit(std::shared_ptr<RetStmt>) override;
+
+    // restart label if any self tail calls were found, otherwise null
+    std::shared_ptr<Label> get();
+    // whether any tail calls to other procedures were found
+    bool tail_calls();
+};
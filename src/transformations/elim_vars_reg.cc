@@ -0,0 +1,38 @@
+
+#include "elim_vars_reg.h"
+
+#include <stdlib.h>
+
+#include <iostream>
+
+#include "assembly.h"
+
+ElimVarsReg::ElimVarsReg(std::map<std::shared_ptr<Variable>, Reg> registers) :
+    registers {registers} {}
+
+std::shared_ptr<Code> ElimVarsReg::visit(std::shared_ptr<VarAccess> var_access
+) {
+    Reg var_reg = registers.at(var_access->variable);
+    if (var_access->var_access_type == VarAccessType::Read) {
+        return make_add(var_access->reg, var_reg, Reg::Zero);
+    } else if (var_access->var_access_type == VarAccessType::Write) {
+        return make_add(var_reg, var_access->reg, Reg::Zero);
+    } else {
+        std::cerr << "Cannot take address of register variable." << std::endl;
+        exit(1);
+    }
+}
+
+void NeedsFrame::visit(std::shared_ptr<VarAccess> var_access) {
+    if (var_access->var_access_type == VarAccessType::Address) {
+        result = true;
+    }
+}
+
+void NeedsFrame::visit(std::shared_ptr<Call>) {
+    result = true;
+}
+
+bool NeedsFrame::get() {
+    return result;
+}
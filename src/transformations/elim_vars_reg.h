@@ -0,0 +1,33 @@
+
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "block.h"
+#include "call.h"
+#include "code.h"
+#include "reg.h"
+#include "var_access.h"
+#include "variable.h"
+#include "visitor.h"
+
+// replaces accesses of variables kept in registers with register moves
+class ElimVarsReg: public Visitor<std::shared_ptr<Code>> {
+    std::map<std::shared_ptr<Variable>, Reg> registers;
+
+  public:
+    explicit ElimVarsReg(std::map<std::shared_ptr<Variable>, Reg> registers);
+    std::shared_ptr<Code> visit(std::shared_ptr<VarAccess>) override;
+};
+
+// finds whether code makes calls or takes the address of a variable, either
+// of which requires variables to live in a frame
+class NeedsFrame: public Visitor<void> {
+    bool result = false;
+
+  public:
+    void visit(std::shared_ptr<VarAccess>) override;
+    void visit(std::shared_ptr<Call>) override;
+    bool get();
+};
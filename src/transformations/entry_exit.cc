@@ -9,30 +9,54 @@
 #include "reg.h"
 #include "stack.h"
 
-std::shared_ptr<Code>
-add_entry_exit(std::shared_ptr<Procedure> proc, std::shared_ptr<Chunk> frame) {
-    std::shared_ptr<Code> proc_start = make_block(
-        {make_add(Reg::SavedParamPtr, Reg::Result, Reg::Zero),
-         stack::allocate(frame),
-         frame->store(Reg::Result, proc->dynamic_link, Reg::FramePtr),
-         make_add(Reg::FramePtr, Reg::Result, Reg::Zero),
-         frame->store(Reg::FramePtr, proc->saved_pc, Reg::Link),
-         frame->store(Reg::FramePtr, proc->param_ptr, Reg::SavedParamPtr)}
-    );
+std::shared_ptr<Code> add_entry_exit(
+    std::shared_ptr<Procedure> proc,
+    std::shared_ptr<Chunk> frame,
+    bool tail_calls
+) {
+    // stack arguments were stored by the caller right below its stack
+    // pointer, where the end of the frame is allocated over them
+    std::vector<std::shared_ptr<Code>> proc_start = {
+        stack::allocate(frame),
+        frame->store(Reg::Result, proc->dynamic_link, Reg::FramePtr),
+        make_add(Reg::FramePtr, Reg::Result, Reg::Zero),
+        frame->store(Reg::FramePtr, proc->saved_pc, Reg::Link)};
 
-    std::shared_ptr<Code> proc_end = make_block(
-        {frame->load(Reg::FramePtr, Reg::Link, proc->saved_pc),
-         frame->load(Reg::FramePtr, Reg::FramePtr, proc->dynamic_link),
-         stack::pop(),
-         stack::pop(),
-         make_jr(Reg::Link)}
-    );
+    // spill register arguments into the frame
+    auto reg = arg_regs.begin();
+    for (auto param : proc->register_parameters()) {
+        proc_start.push_back(frame->store(Reg::FramePtr, param, *reg));
+        reg++;
+    }
+
+    std::vector<std::shared_ptr<Code>> pop_frame = {
+        frame->load(Reg::FramePtr, Reg::Link, proc->saved_pc),
+        frame->load(Reg::FramePtr, Reg::FramePtr, proc->dynamic_link),
+        stack::pop(frame)};
 
+    std::vector<std::shared_ptr<Code>> result = {
+        make_define(proc->start_label),
+        make_block(proc_start),
+        proc->code,
+        make_define(proc->end_label),
+        make_block(pop_frame),
+        make_jr(Reg::Link)};
+    if (tail_calls) {
+        result.insert(
+            result.end(),
+            {make_define(proc->tail_call_label),
+             make_block(pop_frame),
+             make_jr(Reg::TargetPC)}
+        );
+    }
+    return make_block(result);
+}
+
+std::shared_ptr<Code> add_leaf_entry_exit(std::shared_ptr<Procedure> proc) {
     return make_block(
         {make_define(proc->start_label),
-         proc_start,
          proc->code,
          make_define(proc->end_label),
-         proc_end}
+         make_jr(Reg::Link)}
     );
 }
@@ -8,7 +8,13 @@
 #include "procedure.h"
 #include "variable.h"
 
+// tail_calls adds a second exit at the procedure's tail call label
 std::shared_ptr<Code> add_entry_exit(
     std::shared_ptr<Procedure> procedure,
-    std::shared_ptr<Chunk> frame
+    std::shared_ptr<Chunk> frame,
+    bool tail_calls = false
+);
+
+// entry and exit for procedures keeping all their variables in registers
+std::shared_ptr<Code> add_leaf_entry_exit(std::shared_ptr<Procedure> procedure
 );
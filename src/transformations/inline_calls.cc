@@ -0,0 +1,346 @@
+
+#include "inline_calls.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#include "beq_label.h"
+#include "bne_label.h"
+#include "if_stmt.h"
+#include "pseudo_assembly.h"
+
+namespace {
+class IRSize: public Visitor<void> {
+  public:
+    uint32_t size = 0;
+
+    void visit(std::shared_ptr<Code>) override {
+        size += 1;
+    }
+
+    void visit(std::shared_ptr<DefineLabel>) override {}
+
+    void visit(std::shared_ptr<VarAccess> var_access) override {
+        size += var_access->var_access_type == VarAccessType::Address ? 3 : 1;
+    }
+
+    void visit(std::shared_ptr<IfStmt> if_stmt) override {
+        // bin_op temporary plus the branches around thens and elses
+        size += 4;
+        Visitor<void>::visit(if_stmt);
+    }
+
+    void visit(std::shared_ptr<RetStmt> ret_stmt) override {
+        size += 1;
+        Visitor<void>::visit(ret_stmt);
+    }
+
+    void visit(std::shared_ptr<Call> call) override {
+        size += call_overhead(call->procedure);
+        Visitor<void>::visit(call);
+    }
+};
+
+class BranchTargets: public Visitor<void> {
+  public:
+    std::set<std::shared_ptr<Label>> labels;
+
+    void visit(std::shared_ptr<BeqLabel> beq_label) override {
+        labels.insert(beq_label->label);
+    }
+
+    void visit(std::shared_ptr<BneLabel> bne_label) override {
+        labels.insert(bne_label->label);
+    }
+};
+
+class DefinedLabels: public Visitor<void> {
+  public:
+    std::vector<std::shared_ptr<Label>> labels;
+
+    void visit(std::shared_ptr<DefineLabel> define_label) override {
+        labels.push_back(define_label->label);
+    }
+};
+
+class CollectCalls: public Visitor<void> {
+  public:
+    std::set<std::shared_ptr<Procedure>> callees;
+
+    void visit(std::shared_ptr<Call> call) override {
+        callees.insert(call->procedure);
+        Visitor<void>::visit(call);
+    }
+};
+
+// call sites nested deeper than this are all assumed to be equally hot
+const uint32_t max_loop_depth = 3;
+
+// procedures run at least 1 / hot_fraction as often as the hottest one are
+// inlined as if called from the deepest loop
+const uint64_t hot_fraction = 8;
+}  // namespace
+
+uint32_t ir_size(std::shared_ptr<Code> code) {
+    IRSize ir_size;
+    code->accept(ir_size);
+    return ir_size.size;
+}
+
+uint32_t call_overhead(std::shared_ptr<Procedure> procedure) {
+    // every argument costs a temporary and a move into its argument register
+    // or its word below the stack pointer
+    return 28 + 3 * procedure->parameters.size();
+}
+
+RenameBody::RenameBody(
+    std::map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> variables,
+    std::shared_ptr<Code> body,
+    std::shared_ptr<Label> end_label
+) :
+    variables {variables},
+    end_label {end_label} {
+    // only labels defined within the body are private to it, anything else
+    // (string literals, heap start) is shared with the rest of the program
+    DefinedLabels defined_labels;
+    body->accept(defined_labels);
+    for (auto label : defined_labels.labels) {
+        labels[label] = std::make_shared<Label>(label->name);
+    }
+}
+
+std::shared_ptr<Label> RenameBody::rename(std::shared_ptr<Label> label) {
+    if (labels.contains(label)) {
+        return labels.at(label);
+    }
+    return label;
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<BeqLabel> beq_label) {
+    return make_beq(beq_label->s, beq_label->t, rename(beq_label->label));
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<BneLabel> bne_label) {
+    return make_bne(bne_label->s, bne_label->t, rename(bne_label->label));
+}
+
+std::shared_ptr<Code>
+RenameBody::visit(std::shared_ptr<DefineLabel> define_label) {
+    return make_define(rename(define_label->label));
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<UseLabel> use_label) {
+    return make_use(rename(use_label->label));
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<VarAccess> var_access) {
+    std::shared_ptr<Variable> variable = var_access->variable;
+    if (variables.contains(variable)) {
+        variable = variables.at(variable);
+    }
+    return std::make_shared<VarAccess>(
+        var_access->reg,
+        variable,
+        var_access->var_access_type
+    );
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<Scope> scope) {
+    std::vector<std::shared_ptr<Variable>> renamed;
+    for (auto variable : scope->variables) {
+        auto fresh =
+            std::make_shared<Variable>(variable->name, variable->words);
+        variables[variable] = fresh;
+        renamed.push_back(fresh);
+    }
+    return make_scope(renamed, scope->code->accept(*this));
+}
+
+std::shared_ptr<Code> RenameBody::visit(std::shared_ptr<RetStmt> ret_stmt) {
+    return make_block(
+        {ret_stmt->code->accept(*this),
+         make_beq(Reg::Zero, Reg::Zero, end_label)}
+    );
+}
+
+InlineCalls::InlineCalls(
+    uint32_t threshold,
+    std::set<std::shared_ptr<Procedure>> recursive,
+    const Profile& profile,
+    uint64_t hottest
+) :
+    threshold {threshold},
+    recursive {recursive},
+    profile {profile},
+    hottest {hottest} {}
+
+std::shared_ptr<Code> InlineCalls::visit(std::shared_ptr<Block> block) {
+    // a label followed later in the same block by a branch back to it
+    // encloses a loop, calls between the two run once per iteration
+    std::vector<std::set<std::shared_ptr<Label>>> targets;
+    for (auto& code : block->code) {
+        BranchTargets branch_targets;
+        code->accept(branch_targets);
+        targets.push_back(branch_targets.labels);
+    }
+
+    std::vector<uint32_t> depth(block->code.size(), 0);
+    for (size_t i = 0; i < block->code.size(); ++i) {
+        auto define_label =
+            std::dynamic_pointer_cast<DefineLabel>(block->code.at(i));
+        if (!define_label) {
+            continue;
+        }
+        for (size_t j = block->code.size() - 1; j > i; --j) {
+            if (targets.at(j).contains(define_label->label)) {
+                for (size_t k = i; k <= j; ++k) {
+                    depth.at(k) += 1;
+                }
+                break;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<Code>> result;
+    for (size_t i = 0; i < block->code.size(); ++i) {
+        loop_depth += depth.at(i);
+        result.push_back(block->code.at(i)->accept(*this));
+        loop_depth -= depth.at(i);
+    }
+    return make_block(result);
+}
+
+std::shared_ptr<Code> InlineCalls::visit(std::shared_ptr<Call> call) {
+    std::vector<std::shared_ptr<Code>> arguments;
+    for (auto arg : call->arguments) {
+        arguments.push_back(arg->accept(*this));
+    }
+
+    std::shared_ptr<Procedure> callee = call->procedure;
+    uint32_t weight = 1 + std::min(loop_depth, max_loop_depth);
+    // a profile knows better than the loop nesting
+    if (!profile.empty()) {
+        uint64_t count = profile_count(profile, callee->body_label->name);
+        if (count == 0) {
+            weight = 0;
+        } else if (count * hot_fraction >= hottest) {
+            weight = 1 + max_loop_depth;
+        }
+    }
+    if (recursive.contains(callee) || !callee->code
+        || ir_size(callee->code) > threshold * weight) {
+        return make_call(callee, arguments);
+    }
+
+    std::shared_ptr<Label> end_label =
+        std::make_shared<Label>("inlined " + callee->name + " end");
+    std::map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> params;
+    std::vector<std::shared_ptr<Variable>> fresh_params;
+    std::vector<std::shared_ptr<Code>> code;
+
+    auto param = callee->parameters.begin();
+    auto arg = arguments.begin();
+    while (param != callee->parameters.end() && arg != arguments.end()) {
+        auto fresh = std::make_shared<Variable>((*param)->name);
+        params[*param] = fresh;
+        fresh_params.push_back(fresh);
+        code.push_back(assign(fresh, *arg));
+        param++;
+        arg++;
+    }
+
+    RenameBody rename_body {params, callee->code, end_label};
+    code.push_back(callee->code->accept(rename_body));
+    code.push_back(make_define(end_label));
+
+    return make_scope(fresh_params, code);
+}
+
+void inline_calls(
+    std::vector<std::shared_ptr<Procedure>>& procedures,
+    uint32_t threshold,
+    const Profile& profile
+) {
+    if (threshold == 0) {
+        return;
+    }
+
+    uint64_t hottest = 0;
+    for (auto proc : procedures) {
+        hottest = std::max(
+            hottest,
+            profile_count(profile, proc->body_label->name)
+        );
+    }
+
+    std::map<std::shared_ptr<Procedure>, std::set<std::shared_ptr<Procedure>>>
+        call_graph;
+    for (auto proc : procedures) {
+        CollectCalls collect_calls;
+        if (proc->code) {
+            proc->code->accept(collect_calls);
+        }
+        call_graph[proc] = collect_calls.callees;
+    }
+
+    // Tarjan's algorithm emits components callees first
+    std::map<std::shared_ptr<Procedure>, uint32_t> index;
+    std::map<std::shared_ptr<Procedure>, uint32_t> low_link;
+    std::vector<std::shared_ptr<Procedure>> stack;
+    std::set<std::shared_ptr<Procedure>> on_stack;
+    std::vector<std::vector<std::shared_ptr<Procedure>>> components;
+
+    std::function<void(std::shared_ptr<Procedure>)> connect =
+        [&](std::shared_ptr<Procedure> proc) {
+            uint32_t next_index = index.size();
+            index[proc] = next_index;
+            low_link[proc] = next_index;
+            stack.push_back(proc);
+            on_stack.insert(proc);
+
+            for (auto callee : call_graph[proc]) {
+                if (!index.contains(callee)) {
+                    connect(callee);
+                    low_link[proc] = std::min(low_link[proc], low_link[callee]);
+                } else if (on_stack.contains(callee)) {
+                    low_link[proc] = std::min(low_link[proc], index[callee]);
+                }
+            }
+
+            if (low_link[proc] == index[proc]) {
+                std::vector<std::shared_ptr<Procedure>> component;
+                std::shared_ptr<Procedure> member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack.erase(member);
+                    component.push_back(member);
+                } while (member != proc);
+                components.push_back(component);
+            }
+        };
+
+    for (auto proc : procedures) {
+        if (!index.contains(proc)) {
+            connect(proc);
+        }
+    }
+
+    for (auto& component : components) {
+        std::set<std::shared_ptr<Procedure>> recursive(
+            component.begin(),
+            component.end()
+        );
+        for (auto proc : component) {
+            if (proc->code) {
+                InlineCalls inline_calls {
+                    threshold,
+                    recursive,
+                    profile,
+                    hottest};
+                proc->code = proc->code->accept(inline_calls);
+            }
+        }
+    }
+}
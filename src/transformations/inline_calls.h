@@ -0,0 +1,84 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "block.h"
+#include "call.h"
+#include "code.h"
+#include "define_label.h"
+#include "label.h"
+#include "procedure.h"
+#include "profile.h"
+#include "ret_stmt.h"
+#include "scope.h"
+#include "use_label.h"
+#include "var_access.h"
+#include "variable.h"
+#include "visitor.h"
+
+// estimated number of instructions the code compiles down to
+uint32_t ir_size(std::shared_ptr<Code> code);
+
+// estimated number of instructions spent on the call sequence, arguments
+// and entry/exit code of a call to procedure
+uint32_t call_overhead(std::shared_ptr<Procedure> procedure);
+
+// copies a procedure body with fresh variables and labels, turning return
+// statements into branches to end_label
+class RenameBody: public Visitor<std::shared_ptr<Code>> {
+    std::map<std::shared_ptr<Variable>, std::shared_ptr<Variable>> variables;
+    std::map<std::shared_ptr<Label>, std::shared_ptr<Label>> labels;
+    std::shared_ptr<Label> end_label;
+
+    std::shared_ptr<Label> rename(std::shared_ptr<Label> label);
+
+  public:
+    RenameBody(
+        std::map<std::shared_ptr<Variable>, std::shared_ptr<Variable>>
+            variables,
+        std::shared_ptr<Code> body,
+        std::shared_ptr<Label> end_label
+    );
+    std::shared_ptr<Code> visit(std::shared_ptr<BeqLabel>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<BneLabel>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<DefineLabel>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<UseLabel>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<VarAccess>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<Scope>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<RetStmt>) override;
+};
+
+class InlineCalls: public Visitor<std::shared_ptr<Code>> {
+    uint32_t threshold;
+    std::set<std::shared_ptr<Procedure>> recursive;
+    const Profile& profile;
+    // largest count of any procedure body in the profile
+    uint64_t hottest;
+    uint32_t loop_depth = 0;
+
+  public:
+    InlineCalls(
+        uint32_t threshold,
+        std::set<std::shared_ptr<Procedure>> recursive,
+        const Profile& profile,
+        uint64_t hottest
+    );
+    std::shared_ptr<Code> visit(std::shared_ptr<Block>) override;
+    std::shared_ptr<Code> visit(std::shared_ptr<Call>) override;
+};
+
+// inlines calls bottom up over the call graph, calls between procedures of
+// the same strongly connected component (recursion) are left alone; with a
+// profile, procedures that never ran are not inlined and the hottest ones
+// may be larger
+void inline_calls(
+    std::vector<std::shared_ptr<Procedure>>& procedures,
+    uint32_t threshold,
+    const Profile& profile = {}
+);
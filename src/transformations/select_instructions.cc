@@ -0,0 +1,425 @@
+
+#include "select_instructions.h"
+
+#include <stdint.h>
+
+#include <optional>
+
+#include "assembly.h"
+#include "reg.h"
+#include "word.h"
+
+namespace {
+struct Instr {
+    uint32_t op;
+    uint32_t s;
+    uint32_t t;
+    uint32_t d;
+    uint32_t shamt;
+    uint32_t funct;
+};
+
+Instr decode(std::shared_ptr<Word> word) {
+    uint32_t bits = word->bits;
+    return Instr {
+        bits >> 26,
+        (bits >> 21) & 0b11111,
+        (bits >> 16) & 0b11111,
+        (bits >> 11) & 0b11111,
+        (bits >> 6) & 0b11111,
+        bits & 0b111111};
+}
+
+std::shared_ptr<Word> as_word(std::shared_ptr<Code> code) {
+    return std::dynamic_pointer_cast<Word>(code);
+}
+
+bool is_lis(std::shared_ptr<Code> code) {
+    auto word = as_word(code);
+    if (!word) {
+        return false;
+    }
+    Instr instr = decode(word);
+    return instr.op == 0 && instr.s == 0 && instr.t == 0 && instr.shamt == 0
+        && instr.funct == 0b010100;
+}
+
+// registers an instruction reads and writes, $0 standing in for none;
+// control is set for anything that may branch or is not understood
+struct Effects {
+    uint32_t reads1 = 0;
+    uint32_t reads2 = 0;
+    uint32_t writes = 0;
+    bool control = false;
+};
+
+Effects effects(Instr instr) {
+    if (instr.op == 0) {
+        switch (instr.funct) {
+            case 0x20:  // add
+            case 0x21:  // addu
+            case 0x22:  // sub
+            case 0x23:  // subu
+            case 0x24:  // and
+            case 0x25:  // or
+            case 0x26:  // xor
+            case 0x27:  // nor
+            case 0x2a:  // slt
+            case 0x2b:  // sltu
+            case 0x04:  // sllv
+            case 0x06:  // srlv
+            case 0x07:  // srav
+                return Effects {instr.s, instr.t, instr.d};
+            case 0x00:  // sll
+            case 0x02:  // srl
+            case 0x03:  // sra
+                return Effects {instr.t, 0, instr.d};
+            case 0x18:  // mult
+            case 0x19:  // multu
+            case 0x1a:  // div
+            case 0x1b:  // divu
+                return Effects {instr.s, instr.t, 0};
+            case 0x10:  // mfhi
+            case 0x12:  // mflo
+            case 0x14:  // lis
+                return Effects {0, 0, instr.d};
+            default:
+                return Effects {instr.s, 0, 0, true};
+        }
+    }
+    switch (instr.op) {
+        case 0x08:  // addi
+        case 0x09:  // addiu
+        case 0x0a:  // slti
+        case 0x0b:  // sltiu
+        case 0x0c:  // andi
+        case 0x0d:  // ori
+        case 0x0e:  // xori
+        case 0x20:  // lb
+        case 0x23:  // lw
+        case 0x24:  // lbu
+            return Effects {instr.s, 0, instr.t};
+        case 0x0f:  // lui
+            return Effects {0, 0, instr.t};
+        case 0x28:  // sb
+        case 0x2b:  // sw
+            return Effects {instr.s, instr.t, 0};
+        default:
+            return Effects {instr.s, instr.t, 0, true};
+    }
+}
+
+// Scratch3 only ever carries a constant from its lis to the add of
+// Chunk::load_address or stack::pop, so it is never live across control flow
+bool dead_at_boundary(uint32_t reg) {
+    return reg == (uint32_t)Reg::Scratch3;
+}
+
+// whether reg is overwritten before it is read again from index on
+bool dead_from(
+    const std::vector<std::shared_ptr<Code>>& program,
+    size_t index,
+    uint32_t reg
+) {
+    for (size_t i = index; i < program.size(); ++i) {
+        auto word = as_word(program.at(i));
+        if (!word) {
+            return dead_at_boundary(reg);
+        }
+        Effects effect = effects(decode(word));
+        if (effect.reads1 == reg || effect.reads2 == reg) {
+            return false;
+        }
+        if (effect.control) {
+            return dead_at_boundary(reg);
+        }
+        if (effect.writes == reg) {
+            return true;
+        }
+        if (is_lis(word)) {
+            i += 1;
+        }
+    }
+    return dead_at_boundary(reg);
+}
+
+bool fits_signed16(int32_t value) {
+    return value >= INT16_MIN && value <= INT16_MAX;
+}
+
+struct Fused {
+    std::vector<std::shared_ptr<Code>> code;
+    uint32_t writes;
+    size_t consumed;
+};
+
+uint32_t shift_amount(uint32_t power_of_two) {
+    uint32_t shift = 0;
+    while ((1u << shift) != power_of_two) {
+        shift += 1;
+    }
+    return shift;
+}
+
+// signed division by a constant d >= 2 as a multiply by a magic number m,
+// keeping the high word and shifting it right by shift, see Hacker's
+// Delight chapter 10
+struct Magic {
+    int32_t m;
+    uint32_t shift;
+};
+
+Magic magic(int32_t d) {
+    const uint32_t two31 = 0x80000000;
+    uint32_t ad = d;
+    uint32_t anc = two31 - 1 - two31 % ad;
+    uint32_t p = 31;
+    uint32_t q1 = two31 / anc;
+    uint32_t r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad;
+    uint32_t r2 = two31 - q2 * ad;
+    uint32_t delta;
+    do {
+        p += 1;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1 += 1;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            q2 += 1;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    return Magic {(int32_t)(q2 + 1), p - 32};
+}
+
+std::vector<std::shared_ptr<Code>> load_constant(Reg reg, uint32_t bits) {
+    if (fits_signed16((int32_t)bits)) {
+        return {make_addi(reg, Reg::Zero, bits & UINT16_MAX)};
+    }
+    if ((bits & UINT16_MAX) == 0) {
+        return {make_lui(reg, bits >> 16)};
+    }
+    return {make_lui(reg, bits >> 16), make_ori(reg, reg, bits & UINT16_MAX)};
+}
+
+// x / c or x % c for a constant c > 1, rounding toward zero like div; reg
+// held the constant and is free to use, as is Scratch3
+std::vector<std::shared_ptr<Code>>
+divide(Reg d, Reg x, Reg reg, int32_t c, bool unsign, bool remainder) {
+    Reg tmp = Reg::Scratch3;
+    bool power_of_two = (c & (c - 1)) == 0;
+    if (unsign && power_of_two) {
+        uint32_t k = shift_amount(c);
+        if (!remainder) {
+            return {make_srl(d, x, k)};
+        }
+        if ((uint32_t)c - 1 <= UINT16_MAX) {
+            return {make_andi(d, x, c - 1)};
+        }
+        return {make_sll(d, x, 32 - k), make_srl(d, d, 32 - k)};
+    }
+
+    std::vector<std::shared_ptr<Code>> code;
+    if (power_of_two) {
+        // bias negative dividends by c - 1 so the shift rounds toward zero
+        uint32_t k = shift_amount(c);
+        if (k > 1) {
+            code.push_back(make_sra(tmp, x, 31));
+            code.push_back(make_srl(tmp, tmp, 32 - k));
+        } else {
+            code.push_back(make_srl(tmp, x, 31));
+        }
+        code.push_back(make_add(tmp, tmp, x));
+        if (!remainder) {
+            code.push_back(make_sra(d, tmp, k));
+            return code;
+        }
+        code.push_back(make_srl(tmp, tmp, k));
+        code.push_back(make_sll(tmp, tmp, k));
+        code.push_back(make_sub(d, x, tmp));
+        return code;
+    }
+
+    Magic mg = magic(c);
+    code = load_constant(reg, mg.m);
+    code.push_back(make_mult(x, reg));
+    code.push_back(make_mfhi(reg));
+    if (mg.m < 0) {
+        code.push_back(make_add(reg, reg, x));
+    }
+    if (mg.shift > 0) {
+        code.push_back(make_sra(reg, reg, mg.shift));
+    }
+    // add one for negative dividends to round toward zero
+    code.push_back(make_srl(tmp, x, 31));
+    if (!remainder) {
+        code.push_back(make_add(d, reg, tmp));
+        return code;
+    }
+    code.push_back(make_add(reg, reg, tmp));
+    auto load = load_constant(tmp, c);
+    code.insert(code.end(), load.begin(), load.end());
+    code.push_back(make_mult(reg, tmp));
+    code.push_back(make_mflo(reg));
+    code.push_back(make_sub(d, x, reg));
+    return code;
+}
+
+bool is_move_from(std::shared_ptr<Code> code) {
+    auto word = as_word(code);
+    return word && decode(word).op == 0
+        && (decode(word).funct == 0x10 || decode(word).funct == 0x12);
+}
+
+// rewrites the instruction at index, which consumes constant from reg, to
+// use the constant directly instead
+std::optional<Fused> fuse(
+    const std::vector<std::shared_ptr<Code>>& program,
+    size_t index,
+    uint32_t reg,
+    int32_t constant
+) {
+    auto word = as_word(program.at(index));
+    if (!word || decode(word).op != 0) {
+        return std::nullopt;
+    }
+    Instr instr = decode(word);
+    Reg d = (Reg)instr.d;
+    Reg s = (Reg)instr.s;
+    Reg t = (Reg)instr.t;
+    uint16_t imm = (uint16_t)constant;
+    // the one register operand that does not hold the constant
+    bool only_t = instr.t == reg && instr.s != reg;
+    bool only_s = instr.s == reg && instr.t != reg;
+
+    bool fits = fits_signed16(constant);
+
+    if (instr.funct == 0x20 && (only_t || only_s) && fits) {
+        return Fused {{make_addi(d, only_t ? s : t, imm)}, instr.d, 1};
+    }
+    if (instr.funct == 0x22 && only_t && fits && fits_signed16(-constant)) {
+        return Fused {{make_addi(d, s, (uint16_t)-constant)}, instr.d, 1};
+    }
+    if (instr.funct == 0x2a && only_t && fits) {
+        return Fused {{make_slti(d, s, imm)}, instr.d, 1};
+    }
+
+    // multiplication by a power of two read back with mflo, hi is left
+    // undefined which nothing reading the product relies on
+    bool power_of_two = constant > 0 && (constant & (constant - 1)) == 0;
+    if (instr.funct == 0x18 && power_of_two && (only_t || only_s)
+        && index + 1 < program.size()) {
+        auto next = as_word(program.at(index + 1));
+        if (next && decode(next).op == 0 && decode(next).funct == 0x12) {
+            Reg mflo_d = (Reg)decode(next).d;
+            return Fused {
+                {make_sll(mflo_d, only_t ? s : t, shift_amount(constant))},
+                decode(next).d,
+                2};
+        }
+    }
+
+    // division by a constant, read back with either mflo or mfhi but not
+    // both, which the code generator never does
+    bool divides = instr.funct == 0x1a || instr.funct == 0x1b;
+    bool moved_once = index + 1 < program.size()
+        && is_move_from(program.at(index + 1))
+        && (index + 2 >= program.size()
+            || !is_move_from(program.at(index + 2)));
+    if (divides && only_t && constant > 1 && moved_once
+        && s != Reg::Scratch3 && t != Reg::Scratch3) {
+        Instr next = decode(as_word(program.at(index + 1)));
+        bool unsign = instr.funct == 0x1b;
+        bool remainder = next.funct == 0x10;
+        if (unsign && (constant & (constant - 1)) != 0) {
+            return std::nullopt;
+        }
+        return Fused {
+            divide((Reg)next.d, s, (Reg)reg, constant, unsign, remainder),
+            next.d,
+            2};
+    }
+    return std::nullopt;
+}
+
+// whether code can be moved past the load of a constant into reg
+bool independent(std::shared_ptr<Code> code, uint32_t reg) {
+    auto word = as_word(code);
+    if (!word || is_lis(word)) {
+        return false;
+    }
+    Effects effect = effects(decode(word));
+    return !effect.control && effect.reads1 != reg && effect.reads2 != reg
+        && effect.writes != reg;
+}
+}  // namespace
+
+std::vector<std::shared_ptr<Code>>
+select_instructions(std::vector<std::shared_ptr<Code>> program) {
+    std::vector<std::shared_ptr<Code>> result;
+    size_t i = 0;
+    while (i < program.size()) {
+        if (!is_lis(program.at(i))) {
+            result.push_back(program.at(i));
+            i += 1;
+            continue;
+        }
+
+        Reg reg = (Reg)decode(as_word(program.at(i))).d;
+        std::shared_ptr<Word> data =
+            i + 1 < program.size() ? as_word(program.at(i + 1)) : nullptr;
+        if (!data) {
+            // label addresses are only known once labels are eliminated
+            result.push_back(program.at(i));
+            i += 1;
+            continue;
+        }
+        int32_t constant = (int32_t)data->bits;
+        i += 2;
+
+        // fold the constant into the instruction consuming it, either right
+        // after the load or past one independent instruction
+        std::optional<Fused> fused;
+        size_t skip = 0;
+        for (; skip <= 1 && i + skip < program.size(); ++skip) {
+            if (skip == 1 && !independent(program.at(i), (uint32_t)reg)) {
+                break;
+            }
+            fused = fuse(program, i + skip, (uint32_t)reg, constant);
+            size_t after = i + skip + (fused ? fused->consumed : 0);
+            if (fused && fused->writes != (uint32_t)reg
+                && !dead_from(program, after, (uint32_t)reg)) {
+                fused = std::nullopt;
+            }
+            if (fused) {
+                break;
+            }
+        }
+
+        if (!fused) {
+            if (fits_signed16(constant)) {
+                result.push_back(make_addi(reg, Reg::Zero, (uint16_t)constant));
+            } else if (data->bits <= UINT16_MAX) {
+                result.push_back(make_ori(reg, Reg::Zero, data->bits));
+            } else if ((data->bits & UINT16_MAX) == 0) {
+                result.push_back(make_lui(reg, data->bits >> 16));
+            } else {
+                result.push_back(make_lis(reg));
+                result.push_back(data);
+            }
+            continue;
+        }
+        if (skip == 1) {
+            result.push_back(program.at(i));
+        }
+        result.insert(result.end(), fused->code.begin(), fused->code.end());
+        i += skip + fused->consumed;
+    }
+    return result;
+}
@@ -0,0 +1,13 @@
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "code.h"
+
+// rewrites constant loads and the instructions consuming them into
+// immediate forms, expects flattened code with labels still in place and
+// no static data mixed in
+std::vector<std::shared_ptr<Code>>
+select_instructions(std::vector<std::shared_ptr<Code>> program);
@@ -164,5 +164,9 @@ Visitor<std::shared_ptr<Code>>::visit(std::shared_ptr<Call> code) {
     for (auto arg : code->arguments) {
         arguments.push_back(arg->accept(*this));
     }
-    return std::make_shared<Call>(code->procedure, arguments);
+    return std::make_shared<Call>(
+        code->procedure,
+        arguments,
+        code->tail_call
+    );
 }
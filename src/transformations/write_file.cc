@@ -3,11 +3,15 @@
 
 #include <stdint.h>
 
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <string>
 #include <typeinfo>
 
 #include "word.h"
+#include "x86_64.h"
 
 struct Code;
 
@@ -37,3 +41,41 @@ void write_file(
     }
     out.close();
 }
+
+void write_elf(
+    std::string file_name,
+    const std::vector<std::shared_ptr<Code>>& program,
+    const std::vector<std::shared_ptr<Code>>& data
+) {
+    std::ofstream out {file_name, std::ios::binary};
+    if (!out) {
+        throw "Error opening file for writing.";
+    }
+    std::vector<uint8_t> elf = lower_x86_64(program, data);
+    out.write(reinterpret_cast<char*>(elf.data()), elf.size());
+    out.close();
+    std::filesystem::permissions(
+        file_name,
+        std::filesystem::perms::owner_exec | std::filesystem::perms::group_exec
+            | std::filesystem::perms::others_exec,
+        std::filesystem::perm_options::add
+    );
+}
+
+void write_label_map(
+    std::string file_name,
+    const std::map<std::shared_ptr<Label>, uint32_t>& addresses
+) {
+    std::ofstream out {file_name};
+    if (!out) {
+        throw "Error opening file for writing.";
+    }
+    std::multimap<uint32_t, std::string> by_address;
+    for (auto& [label, address] : addresses) {
+        by_address.insert({address, label->name});
+    }
+    for (auto& [address, name] : by_address) {
+        out << address << " " << name << std::endl;
+    }
+    out.close();
+}
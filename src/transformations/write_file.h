@@ -1,11 +1,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "code.h"
+#include "label.h"
 
 struct Code;
 
@@ -13,3 +17,17 @@ void write_file(
     std::string file_name,
     std::vector<std::shared_ptr<Code>>& program
 );
+
+// writes program and its static data lowered to an x86-64 Linux executable
+void write_elf(
+    std::string file_name,
+    const std::vector<std::shared_ptr<Code>>& program,
+    const std::vector<std::shared_ptr<Code>>& data
+);
+
+// writes a line of "<address> <label name>" for every label, which the
+// emulator uses to count how often each label is reached
+void write_label_map(
+    std::string file_name,
+    const std::map<std::shared_ptr<Label>, uint32_t>& addresses
+);
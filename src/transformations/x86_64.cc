@@ -0,0 +1,969 @@
+
+#include "x86_64.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <typeinfo>
+#include <utility>
+
+#include "beq_label.h"
+#include "bne_label.h"
+#include "define_label.h"
+#include "label.h"
+#include "use_label.h"
+#include "word.h"
+
+namespace {
+
+// returning here ends the program, it is in the link register at the start
+const uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
+// storing a word or byte here prints its low byte
+const uint32_t PRINT_ADDRESS = 0xffff000c;
+// memory of the program, the same size the emulator gives it
+const uint32_t MEMORY_SIZE = 1 << 24;
+// address space reserved for memory so that any 32 bit address faults
+// rather than reaching other mappings
+const uint64_t RESERVED_SIZE = (1ull << 32) + 4096;
+
+// the executable is loaded at BASE, headers first and code right after.
+// Code addresses are kept in 32 bit registers and on the stack, above
+// MEMORY_SIZE none of them looks like a pointer into memory to the gc
+const uint64_t BASE = 0x10000000;
+const uint32_t HEADERS_SIZE = 64 + 2 * 56;
+const uint64_t CODE_ADDRESS = BASE + HEADERS_SIZE;
+const uint32_t PAGE_SIZE = 4096;
+// static data is copied here at the start, no object is at address 0
+const uint32_t DATA_ADDRESS = PAGE_SIZE;
+
+// layout of the zeroed state rbx points to, registers not kept in host
+// registers, hi, lo and the output buffer
+const uint32_t HI = 32 * 4;
+const uint32_t LO = HI + 4;
+const uint32_t OUTPUT_LENGTH = LO + 4;
+const uint32_t OUTPUT = OUTPUT_LENGTH + 4;
+const uint32_t OUTPUT_SIZE = 4096;
+const uint32_t STATE_SIZE = OUTPUT + OUTPUT_SIZE;
+
+enum class Op {
+    Add,
+    Sub,
+    Mult,
+    Multu,
+    Div,
+    Divu,
+    Mfhi,
+    Mflo,
+    Lis,
+    Slt,
+    Sltu,
+    Jr,
+    Jalr,
+    And,
+    Or,
+    Xor,
+    Nor,
+    Sll,
+    Srl,
+    Sra,
+    Sllv,
+    Srlv,
+    Srav,
+    Beq,
+    Bne,
+    Lw,
+    Sw,
+    Lb,
+    Lbu,
+    Sb,
+    Addi,
+    Slti,
+    Andi,
+    Ori,
+    Xori,
+    Lui,
+    Invalid,
+};
+
+struct Instr {
+    Op op;
+    uint8_t s;
+    uint8_t t;
+    uint8_t d;
+    // extended immediate or shift amount
+    uint32_t imm;
+};
+
+Instr decode(uint32_t word) {
+    uint8_t s = (word >> 21) & 31;
+    uint8_t t = (word >> 16) & 31;
+    uint8_t d = (word >> 11) & 31;
+    uint32_t shift = (word >> 6) & 31;
+    uint32_t signed_imm = (uint32_t)(int32_t)(int16_t)(word & 0xffff);
+    uint32_t unsigned_imm = word & 0xffff;
+
+    if (word >> 26 == 0) {
+        switch (word & 63) {
+            case 0x20:
+                return {Op::Add, s, t, d, 0};
+            case 0x22:
+                return {Op::Sub, s, t, d, 0};
+            case 0x18:
+                return {Op::Mult, s, t, 0, 0};
+            case 0x19:
+                return {Op::Multu, s, t, 0, 0};
+            case 0x1a:
+                return {Op::Div, s, t, 0, 0};
+            case 0x1b:
+                return {Op::Divu, s, t, 0, 0};
+            case 0x10:
+                return {Op::Mfhi, 0, 0, d, 0};
+            case 0x12:
+                return {Op::Mflo, 0, 0, d, 0};
+            case 0x14:
+                return {Op::Lis, 0, 0, d, 0};
+            case 0x2a:
+                return {Op::Slt, s, t, d, 0};
+            case 0x2b:
+                return {Op::Sltu, s, t, d, 0};
+            case 0x08:
+                return {Op::Jr, s, 0, 0, 0};
+            case 0x09:
+                return {Op::Jalr, s, 0, 0, 0};
+            case 0x24:
+                return {Op::And, s, t, d, 0};
+            case 0x25:
+                return {Op::Or, s, t, d, 0};
+            case 0x26:
+                return {Op::Xor, s, t, d, 0};
+            case 0x27:
+                return {Op::Nor, s, t, d, 0};
+            case 0x00:
+                return {Op::Sll, 0, t, d, shift};
+            case 0x02:
+                return {Op::Srl, 0, t, d, shift};
+            case 0x03:
+                return {Op::Sra, 0, t, d, shift};
+            case 0x04:
+                return {Op::Sllv, s, t, d, 0};
+            case 0x06:
+                return {Op::Srlv, s, t, d, 0};
+            case 0x07:
+                return {Op::Srav, s, t, d, 0};
+        }
+        return {Op::Invalid, 0, 0, 0, 0};
+    }
+
+    switch (word >> 26) {
+        case 0x04:
+            return {Op::Beq, s, t, 0, signed_imm};
+        case 0x05:
+            return {Op::Bne, s, t, 0, signed_imm};
+        case 0x23:
+            return {Op::Lw, s, t, 0, signed_imm};
+        case 0x2b:
+            return {Op::Sw, s, t, 0, signed_imm};
+        case 0x20:
+            return {Op::Lb, s, t, 0, signed_imm};
+        case 0x24:
+            return {Op::Lbu, s, t, 0, signed_imm};
+        case 0x28:
+            return {Op::Sb, s, t, 0, signed_imm};
+        case 0x08:
+        case 0x09:
+            return {Op::Addi, s, t, 0, signed_imm};
+        case 0x0a:
+            return {Op::Slti, s, t, 0, signed_imm};
+        case 0x0c:
+            return {Op::Andi, s, t, 0, unsigned_imm};
+        case 0x0d:
+            return {Op::Ori, s, t, 0, unsigned_imm};
+        case 0x0e:
+            return {Op::Xori, s, t, 0, unsigned_imm};
+        case 0x0f:
+            return {Op::Lui, 0, t, 0, unsigned_imm << 16};
+    }
+    return {Op::Invalid, 0, 0, 0, 0};
+}
+
+enum Host : uint8_t {
+    Eax = 0,
+    Ecx = 1,
+    Edx = 2,
+    Rbp = 5,
+    Rsi = 6,
+    Rdi = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11,
+    R12 = 12,
+    R13 = 13,
+    R14 = 14,
+    R15 = 15,
+};
+
+enum Condition : uint8_t {
+    Below = 0x2,
+    AboveOrEqual = 0x3,
+    Equal = 0x4,
+    NotEqual = 0x5,
+    Above = 0x7,
+    LessOrEqual = 0xe,
+};
+
+// the busiest registers of compiled programs live in host registers, the
+// rest in the state. rbx holds the state and r12 the memory, eax, ecx and
+// edx are scratch
+struct Mapping {
+    uint8_t reg;
+    Host host;
+};
+const Mapping MAPPINGS[] = {
+    {3, Rbp},
+    {4, Rsi},
+    {6, R13},
+    {8, R9},
+    {10, R11},
+    {11, R8},
+    {15, R10},
+    {29, R14},
+    {30, R15},
+    {31, Rdi},
+};
+
+// host register of reg, -1 for registers in the state
+int host_of(uint8_t reg) {
+    for (auto& mapping : MAPPINGS) {
+        if (mapping.reg == reg) {
+            return mapping.host;
+        }
+    }
+    return -1;
+}
+
+class Lowering {
+    const std::vector<std::shared_ptr<Code>>& program;
+    const std::vector<std::shared_ptr<Code>>& data;
+    std::vector<uint8_t> code;
+    // offset in code of each label of the program, and address in memory
+    // of each label of the data
+    std::map<std::shared_ptr<Label>, uint32_t> code_labels;
+    std::map<std::shared_ptr<Label>, uint32_t> data_labels;
+    // offset in code of each word of the program, for branches that have
+    // their offset already
+    std::vector<uint32_t> offsets;
+    // rel32 fields jumping to a label or to a word of the program
+    std::vector<std::pair<uint32_t, std::shared_ptr<Label>>> branches;
+    std::vector<std::pair<uint32_t, uint32_t>> word_branches;
+    // imm32 fields taking the address of a label
+    std::vector<std::pair<uint32_t, std::shared_ptr<Label>>> label_fields;
+    // je to an out of line print and where it resumes
+    std::vector<std::pair<uint32_t, uint32_t>> prints;
+
+    uint32_t start = 0;
+    uint32_t flush = 0;
+    uint32_t print = 0;
+    uint32_t exit = 0;
+    uint32_t trap = 0;
+    uint32_t parse = 0;
+    // fields of the start that take addresses known at the end
+    uint32_t state_field = 0;
+    uint32_t image_field = 0;
+    uint32_t image_size_field = 0;
+    uint32_t program_site = 0;
+
+    void emit(uint8_t byte) {
+        code.push_back(byte);
+    }
+
+    void emit(std::initializer_list<uint8_t> bytes) {
+        code.insert(code.end(), bytes);
+    }
+
+    void emit32(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            emit(value >> i * 8);
+        }
+    }
+
+    uint32_t here() {
+        return code.size();
+    }
+
+    void patch(uint32_t site, uint32_t target) {
+        uint32_t offset = target - (site + 4);
+        memcpy(&code[site], &offset, 4);
+    }
+
+    void rex(bool wide, uint8_t reg, int rm) {
+        uint8_t prefix =
+            0x40 | wide << 3 | (reg >= 8) << 2 | (rm >= 8 ? 1 : 0);
+        if (prefix != 0x40) {
+            emit(prefix);
+        }
+    }
+
+    // opcode with a [rbx + offset] operand
+    void state_op(uint8_t opcode, uint8_t reg, uint32_t offset) {
+        rex(false, reg, 0);
+        emit(opcode);
+        if (offset < 128) {
+            emit(0x43 | (reg & 7) << 3);
+            emit(offset);
+        } else {
+            emit(0x83 | (reg & 7) << 3);
+            emit32(offset);
+        }
+    }
+
+    // opcode with the MIPS register mips as its r/m operand
+    void reg_op(uint8_t opcode, uint8_t reg, uint8_t mips) {
+        int host = host_of(mips);
+        if (host < 0) {
+            state_op(opcode, reg, mips * 4);
+            return;
+        }
+        rex(false, reg, host);
+        emit(opcode);
+        emit(0xc0 | (reg & 7) << 3 | (host & 7));
+    }
+
+    void load(uint8_t host, uint8_t reg) {
+        if (reg == 0) {
+            // xor host, host
+            rex(false, host, host);
+            emit({0x31, (uint8_t)(0xc0 | (host & 7) << 3 | (host & 7))});
+            return;
+        }
+        reg_op(0x8b, host, reg);
+    }
+
+    // writes to $0 are dropped
+    void store(uint8_t reg, Host host) {
+        if (reg != 0) {
+            reg_op(0x89, host, reg);
+        }
+    }
+
+    void store_imm(uint8_t reg, uint32_t value) {
+        if (reg == 0) {
+            return;
+        }
+        int host = host_of(reg);
+        if (host < 0) {
+            state_op(0xc7, 0, reg * 4);
+        } else {
+            rex(false, 0, host);
+            emit(0xb8 | (host & 7));
+        }
+        emit32(value);
+    }
+
+    // jcc or jmp with a rel32 to fill in, returns the rel32 field
+    uint32_t jump(Condition condition) {
+        emit({0x0f, (uint8_t)(0x80 | condition)});
+        emit32(0);
+        return here() - 4;
+    }
+
+    uint32_t jump() {
+        emit(0xe9);
+        emit32(0);
+        return here() - 4;
+    }
+
+    void call(uint32_t target) {
+        emit(0xe8);
+        emit32(0);
+        patch(here() - 4, target);
+    }
+
+    // the address of the code at offset, as it is kept in registers
+    void absolute(uint32_t field, uint32_t offset) {
+        uint32_t address = CODE_ADDRESS + offset;
+        memcpy(&code[field], &address, 4);
+    }
+
+    void set_flag_result(uint8_t setcc, uint8_t reg) {
+        emit({0x0f, setcc, 0xc0, 0x0f, 0xb6, 0xc0});
+        store(reg, Eax);
+    }
+
+    // eax = reg + imm, the address of a load or store
+    void address(const Instr& instr) {
+        load(Eax, instr.s);
+        if (instr.imm != 0) {
+            emit(0x05);
+            emit32(instr.imm);
+        }
+    }
+
+    // the native address of a label of the program or the address in
+    // memory of one of the data
+    uint32_t label_address(std::shared_ptr<Label> label);
+    // beq or bne of s and t, returns the rel32 field of the jump when the
+    // branch can be taken, otherwise 0
+    uint32_t branch(bool equal, uint8_t s, uint8_t t);
+
+    void emit_runtime();
+    void emit_start();
+    // emits the instruction at index of the program, returns how many of
+    // its entries it took
+    size_t lower(size_t index, uint32_t position);
+    // emits one instruction that needs no label
+    void translate(const Instr& instr, uint32_t position);
+    std::vector<uint32_t> image();
+
+  public:
+    Lowering(
+        const std::vector<std::shared_ptr<Code>>& program,
+        const std::vector<std::shared_ptr<Code>>& data
+    ) :
+        program {program},
+        data {data} {}
+
+    std::vector<uint8_t> elf();
+};
+
+uint32_t Lowering::label_address(std::shared_ptr<Label> label) {
+    if (code_labels.contains(label)) {
+        return CODE_ADDRESS + code_labels.at(label);
+    }
+    if (data_labels.contains(label)) {
+        return data_labels.at(label);
+    }
+    std::cerr << "Undefined label error while lowering!" << std::endl;
+    std::cerr << (label ? label->name : "Invalid label!") << std::endl;
+    ::exit(1);
+}
+
+uint32_t Lowering::branch(bool equal, uint8_t s, uint8_t t) {
+    if (s == t) {
+        return equal ? jump() : 0;
+    }
+    load(Eax, s);
+    reg_op(0x3b, Eax, t);
+    return jump(equal ? Equal : NotEqual);
+}
+
+void Lowering::emit_runtime() {
+    trap = here();
+    // ud2
+    emit({0x0f, 0x0b});
+
+    // eax = the decimal integer rsi points to, clobbers ecx, edx and rsi
+    parse = here();
+    emit({0x31, 0xc0, 0x31, 0xd2});
+    // cmp byte [rsi], '-'
+    emit({0x80, 0x3e, '-'});
+    uint32_t positive = jump(NotEqual);
+    // inc edx, inc rsi
+    emit({0xff, 0xc2, 0x48, 0xff, 0xc6});
+    patch(positive, here());
+    uint32_t digit = here();
+    // ecx = byte [rsi] - '0'
+    emit({0x0f, 0xb6, 0x0e, 0x83, 0xe9, '0'});
+    emit({0x83, 0xf9, 0x09});
+    uint32_t end = jump(Above);
+    // eax = eax * 10 + ecx, inc rsi
+    emit({0x6b, 0xc0, 0x0a, 0x01, 0xc8, 0x48, 0xff, 0xc6});
+    patch(jump(), digit);
+    patch(end, here());
+    emit({0x85, 0xd2});
+    uint32_t done = jump(Equal);
+    // neg eax
+    emit({0xf7, 0xd8});
+    patch(done, here());
+    emit(0xc3);
+
+    // writes the output buffer to stdout, clobbers eax, ecx and edx
+    flush = here();
+    // push rsi, rdi, r11, which write clobbers
+    emit({0x56, 0x57, 0x41, 0x53});
+    // lea rsi, [rbx + OUTPUT]
+    emit({0x48, 0x8d, 0xb3});
+    emit32(OUTPUT);
+    state_op(0x8b, Edx, OUTPUT_LENGTH);
+    uint32_t loop = here();
+    emit({0x85, 0xd2});
+    uint32_t written = jump(LessOrEqual);
+    // write(1, rsi, edx)
+    emit(0xb8);
+    emit32(1);
+    emit(0xbf);
+    emit32(1);
+    emit({0x0f, 0x05});
+    emit({0x48, 0x85, 0xc0});
+    uint32_t failed = jump(LessOrEqual);
+    // add rsi, rax, sub edx, eax
+    emit({0x48, 0x01, 0xc6, 0x29, 0xc2});
+    patch(jump(), loop);
+    patch(written, here());
+    patch(failed, here());
+    state_op(0xc7, 0, OUTPUT_LENGTH);
+    emit32(0);
+    emit({0x41, 0x5b, 0x5f, 0x5e, 0xc3});
+
+    // appends cl to the output buffer, clobbers eax, ecx and edx
+    print = here();
+    state_op(0x8b, Edx, OUTPUT_LENGTH);
+    // mov [rbx + rdx + OUTPUT], cl
+    emit({0x88, 0x8c, 0x13});
+    emit32(OUTPUT);
+    emit({0xff, 0xc2});
+    state_op(0x89, Edx, OUTPUT_LENGTH);
+    emit({0x81, 0xfa});
+    emit32(OUTPUT_SIZE);
+    uint32_t room = jump(Below);
+    call(flush);
+    patch(room, here());
+    emit(0xc3);
+
+    // exit_group($3) once the output is written
+    exit = here();
+    call(flush);
+    load(Rdi, 3);
+    emit(0xb8);
+    emit32(231);
+    emit({0x0f, 0x05});
+}
+
+void Lowering::emit_start() {
+    start = here();
+    // mov ebx, state
+    emit(0xbb);
+    state_field = here();
+    emit32(0);
+
+    // the inputs are argv[1] and argv[2] when given, argc is in r15
+    emit({0x4c, 0x8b, 0x3c, 0x24});
+    for (uint8_t i = 1; i <= 2; ++i) {
+        emit({0x31, 0xc0});
+        // cmp r15, i + 1
+        emit({0x49, 0x83, 0xff, (uint8_t)(i + 1)});
+        uint32_t missing = jump(Below);
+        // mov rsi, [rsp + 8 * (i + 1)]
+        emit({0x48, 0x8b, 0x74, 0x24, (uint8_t)(8 * (i + 1))});
+        call(parse);
+        patch(missing, here());
+        state_op(0x89, Eax, i * 4);
+    }
+
+    // reserve the address space of memory, then map its start
+    // mmap(0, RESERVED_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS |
+    // MAP_NORESERVE, -1, 0)
+    emit({0x31, 0xff, 0x48, 0xbe});
+    for (int i = 0; i < 8; ++i) {
+        emit(RESERVED_SIZE >> i * 8);
+    }
+    emit({0x31, 0xd2, 0x41, 0xba});
+    emit32(0x4022);
+    emit({0x49, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x45, 0x31, 0xc9});
+    emit(0xb8);
+    emit32(9);
+    emit({0x0f, 0x05});
+    // cmp rax, -4096
+    emit({0x48, 0x3d, 0x00, 0xf0, 0xff, 0xff});
+    patch(jump(Above), trap);
+    emit({0x49, 0x89, 0xc4});
+    // mmap(r12, MEMORY_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE |
+    // MAP_ANONYMOUS | MAP_FIXED, -1, 0)
+    emit({0x4c, 0x89, 0xe7, 0xbe});
+    emit32(MEMORY_SIZE);
+    emit(0xba);
+    emit32(3);
+    emit({0x41, 0xba});
+    emit32(0x32);
+    emit(0xb8);
+    emit32(9);
+    emit({0x0f, 0x05});
+    emit({0x48, 0x3d, 0x00, 0xf0, 0xff, 0xff});
+    patch(jump(Above), trap);
+
+    // copy the static data to DATA_ADDRESS, lea rdi, [r12 + DATA_ADDRESS]
+    // then rep movsb
+    emit({0x49, 0x8d, 0xbc, 0x24});
+    emit32(DATA_ADDRESS);
+    emit(0xbe);
+    image_field = here();
+    emit32(0);
+    emit(0xb9);
+    image_size_field = here();
+    emit32(0);
+    emit({0xf3, 0xa4});
+
+    for (auto& mapping : MAPPINGS) {
+        load(mapping.host, 0);
+    }
+    store_imm(30, MEMORY_SIZE);
+    store_imm(31, TERMINATION_PC);
+    program_site = jump();
+}
+
+void Lowering::translate(const Instr& instr, uint32_t position) {
+    uint8_t s = instr.s;
+    uint8_t t = instr.t;
+    uint8_t d = instr.d;
+    uint32_t imm = instr.imm;
+
+    switch (instr.op) {
+        case Op::Add:
+        case Op::Sub:
+        case Op::And:
+        case Op::Or:
+        case Op::Xor:
+        case Op::Nor: {
+            uint8_t opcode = instr.op == Op::Add ? 0x03
+                : instr.op == Op::Sub            ? 0x2b
+                : instr.op == Op::And            ? 0x23
+                : instr.op == Op::Xor            ? 0x33
+                                                 : 0x0b;
+            load(Eax, s);
+            reg_op(opcode, Eax, t);
+            if (instr.op == Op::Nor) {
+                emit({0xf7, 0xd0});
+            }
+            store(d, Eax);
+            return;
+        }
+        case Op::Mult:
+        case Op::Multu:
+            load(Eax, s);
+            reg_op(0xf7, instr.op == Op::Mult ? 5 : 4, t);
+            state_op(0x89, Eax, LO);
+            state_op(0x89, Edx, HI);
+            return;
+        case Op::Div:
+        case Op::Divu:
+            // dividing by zero raises SIGFPE
+            load(Ecx, t);
+            load(Eax, s);
+            if (instr.op == Op::Div) {
+                // idiv faults on INT32_MIN / -1, any x / -1 is -x rem 0
+                emit({0x83, 0xf9, 0xff});
+                uint32_t divide = jump(NotEqual);
+                emit({0xf7, 0xd8, 0x31, 0xd2});
+                uint32_t done = jump();
+                patch(divide, here());
+                emit({0x99, 0xf7, 0xf9});
+                patch(done, here());
+            } else {
+                emit({0x31, 0xd2, 0xf7, 0xf1});
+            }
+            state_op(0x89, Eax, LO);
+            state_op(0x89, Edx, HI);
+            return;
+        case Op::Mfhi:
+        case Op::Mflo:
+            state_op(0x8b, Eax, instr.op == Op::Mfhi ? HI : LO);
+            store(d, Eax);
+            return;
+        case Op::Lis:
+            // with no word after it at the end of the program
+            patch(jump(), trap);
+            return;
+        case Op::Slt:
+        case Op::Sltu:
+            load(Eax, s);
+            reg_op(0x3b, Eax, t);
+            set_flag_result(instr.op == Op::Slt ? 0x9c : 0x92, d);
+            return;
+        case Op::Jr:
+        case Op::Jalr: {
+            // registers hold the native address of a label, from lis or an
+            // earlier jalr
+            load(Eax, s);
+            uint32_t link = 0;
+            if (instr.op == Op::Jalr) {
+                store_imm(31, 0);
+                link = here() - 4;
+            }
+            emit(0x3d);
+            emit32(TERMINATION_PC);
+            patch(jump(Equal), exit);
+            // jmp rax
+            emit({0xff, 0xe0});
+            if (instr.op == Op::Jalr) {
+                absolute(link, here());
+            }
+            return;
+        }
+        case Op::Sll:
+        case Op::Srl:
+        case Op::Sra: {
+            uint8_t kind = instr.op == Op::Sll ? 0xe0
+                : instr.op == Op::Srl          ? 0xe8
+                                               : 0xf8;
+            load(Eax, t);
+            emit({0xc1, kind, (uint8_t)imm});
+            store(d, Eax);
+            return;
+        }
+        case Op::Sllv:
+        case Op::Srlv:
+        case Op::Srav: {
+            uint8_t kind = instr.op == Op::Sllv ? 0xe0
+                : instr.op == Op::Srlv          ? 0xe8
+                                                : 0xf8;
+            load(Ecx, s);
+            load(Eax, t);
+            emit({0xd3, kind});
+            store(d, Eax);
+            return;
+        }
+        case Op::Beq:
+        case Op::Bne: {
+            uint32_t site = branch(instr.op == Op::Beq, s, t);
+            if (site) {
+                word_branches.push_back({site, position + 1 + imm});
+            }
+            return;
+        }
+        case Op::Lw:
+            address(instr);
+            // mov eax, [r12 + rax]
+            emit({0x41, 0x8b, 0x04, 0x04});
+            store(t, Eax);
+            return;
+        case Op::Lb:
+        case Op::Lbu:
+            address(instr);
+            // movsx or movzx eax, byte [r12 + rax]
+            emit({0x41, 0x0f});
+            emit(instr.op == Op::Lb ? 0xbe : 0xb6);
+            emit({0x04, 0x04});
+            store(t, Eax);
+            return;
+        case Op::Sw:
+        case Op::Sb: {
+            address(instr);
+            load(Ecx, t);
+            emit(0x3d);
+            emit32(PRINT_ADDRESS);
+            uint32_t site = jump(Equal);
+            // mov [r12 + rax], ecx or cl
+            emit({0x41, (uint8_t)(instr.op == Op::Sb ? 0x88 : 0x89)});
+            emit({0x0c, 0x04});
+            prints.push_back({site, here()});
+            return;
+        }
+        case Op::Addi:
+        case Op::Andi:
+        case Op::Ori:
+        case Op::Xori: {
+            uint8_t opcode = instr.op == Op::Addi ? 0x05
+                : instr.op == Op::Andi            ? 0x25
+                : instr.op == Op::Ori             ? 0x0d
+                                                  : 0x35;
+            load(Eax, s);
+            emit(opcode);
+            emit32(imm);
+            store(t, Eax);
+            return;
+        }
+        case Op::Slti:
+            load(Eax, s);
+            emit(0x3d);
+            emit32(imm);
+            set_flag_result(0x9c, t);
+            return;
+        case Op::Lui:
+            store_imm(t, imm);
+            return;
+        case Op::Invalid:
+            patch(jump(), trap);
+            return;
+    }
+}
+
+size_t Lowering::lower(size_t index, uint32_t position) {
+    auto& entry = program[index];
+    if (auto beq_label = std::dynamic_pointer_cast<BeqLabel>(entry)) {
+        uint32_t site =
+            branch(true, (uint8_t)beq_label->s, (uint8_t)beq_label->t);
+        if (site) {
+            branches.push_back({site, beq_label->label});
+        }
+        return 1;
+    }
+    if (auto bne_label = std::dynamic_pointer_cast<BneLabel>(entry)) {
+        uint32_t site =
+            branch(false, (uint8_t)bne_label->s, (uint8_t)bne_label->t);
+        if (site) {
+            branches.push_back({site, bne_label->label});
+        }
+        return 1;
+    }
+
+    auto word = std::dynamic_pointer_cast<Word>(entry);
+    if (!word) {
+        auto& c = *entry.get();
+        std::cerr << "Invalid code structure while lowering: "
+                  << typeid(c).name() << std::endl;
+        patch(jump(), trap);
+        return 1;
+    }
+    Instr instr = decode(word->bits);
+    if (instr.op != Op::Lis || index + 1 >= program.size()) {
+        translate(instr, position);
+        return 1;
+    }
+
+    // the word after lis is a constant or the address of a label
+    auto& value = program[index + 1];
+    if (auto use_label = std::dynamic_pointer_cast<UseLabel>(value)) {
+        store_imm(instr.d, 0);
+        if (instr.d != 0) {
+            label_fields.push_back({here() - 4, use_label->label});
+        }
+    } else if (auto constant = std::dynamic_pointer_cast<Word>(value)) {
+        store_imm(instr.d, constant->bits);
+    } else {
+        translate(instr, position);
+        return 1;
+    }
+    offsets.push_back(here());
+    return 2;
+}
+
+std::vector<uint32_t> Lowering::image() {
+    std::vector<uint32_t> words;
+    for (auto& entry : data) {
+        if (auto word = std::dynamic_pointer_cast<Word>(entry)) {
+            words.push_back(word->bits);
+        } else if (auto use_label =
+                       std::dynamic_pointer_cast<UseLabel>(entry)) {
+            words.push_back(label_address(use_label->label));
+        } else if (!std::dynamic_pointer_cast<DefineLabel>(entry)) {
+            auto& c = *entry.get();
+            std::cerr << "Invalid code structure while lowering: "
+                      << typeid(c).name() << std::endl;
+        }
+    }
+    return words;
+}
+
+void append(std::vector<uint8_t>& bytes, uint64_t value, int size) {
+    for (int i = 0; i < size; ++i) {
+        bytes.push_back(value >> i * 8);
+    }
+}
+
+std::vector<uint8_t> Lowering::elf() {
+    emit_runtime();
+    emit_start();
+
+    uint32_t address = DATA_ADDRESS;
+    for (auto& entry : data) {
+        if (auto define_label = std::dynamic_pointer_cast<DefineLabel>(entry)) {
+            data_labels[define_label->label] = address;
+        } else {
+            address += 4;
+        }
+    }
+
+    patch(program_site, here());
+    size_t index = 0;
+    uint32_t position = 0;
+    while (index < program.size()) {
+        if (auto define_label =
+                std::dynamic_pointer_cast<DefineLabel>(program[index])) {
+            code_labels[define_label->label] = here();
+            ++index;
+            continue;
+        }
+        offsets.push_back(here());
+        size_t taken = lower(index, position);
+        index += taken;
+        position += taken;
+    }
+    // running off the end
+    patch(jump(), trap);
+
+    for (auto& [site, resume] : prints) {
+        patch(site, here());
+        call(print);
+        patch(jump(), resume);
+    }
+    for (auto& [site, label] : branches) {
+        patch(site, label_address(label) - CODE_ADDRESS);
+    }
+    for (auto& [site, target] : word_branches) {
+        patch(site, target < offsets.size() ? offsets[target] : trap);
+    }
+    for (auto& [field, label] : label_fields) {
+        uint32_t address = label_address(label);
+        memcpy(&code[field], &address, 4);
+    }
+
+    // the data is copied to memory at the start, its labels are resolved
+    // like those of the program
+    while (here() % 4 != 0) {
+        emit(0xcc);
+    }
+    uint32_t image_address = CODE_ADDRESS + here();
+    std::vector<uint32_t> words = image();
+    for (uint32_t word : words) {
+        emit32(word);
+    }
+    uint32_t image_size = words.size() * 4;
+    uint64_t end = CODE_ADDRESS + here();
+    uint64_t state = (end + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    memcpy(&code[state_field], &state, 4);
+    memcpy(&code[image_field], &image_address, 4);
+    memcpy(&code[image_size_field], &image_size, 4);
+
+    std::vector<uint8_t> file;
+    // ELF header of a 64 bit little endian x86-64 executable
+    file.insert(file.end(), {0x7f, 'E', 'L', 'F', 2, 1, 1, 0});
+    append(file, 0, 8);
+    append(file, 2, 2);
+    append(file, 62, 2);
+    append(file, 1, 4);
+    append(file, CODE_ADDRESS + start, 8);
+    append(file, 64, 8);
+    append(file, 0, 8);
+    append(file, 0, 4);
+    append(file, 64, 2);
+    append(file, 56, 2);
+    append(file, 2, 2);
+    append(file, 64, 2);
+    append(file, 0, 4);
+
+    // headers, code and data image, readable and executable
+    append(file, 1, 4);
+    append(file, 5, 4);
+    append(file, 0, 8);
+    append(file, BASE, 8);
+    append(file, BASE, 8);
+    append(file, HEADERS_SIZE + code.size(), 8);
+    append(file, HEADERS_SIZE + code.size(), 8);
+    append(file, PAGE_SIZE, 8);
+
+    // zeroed state, readable and writable
+    append(file, 1, 4);
+    append(file, 6, 4);
+    append(file, 0, 8);
+    append(file, state, 8);
+    append(file, state, 8);
+    append(file, 0, 8);
+    append(file, STATE_SIZE, 8);
+    append(file, PAGE_SIZE, 8);
+
+    file.insert(file.end(), code.begin(), code.end());
+    return file;
+}
+
+}  // namespace
+
+std::vector<uint8_t> lower_x86_64(
+    const std::vector<std::shared_ptr<Code>>& program,
+    const std::vector<std::shared_ptr<Code>>& data
+) {
+    return Lowering {program, data}.elf();
+}
@@ -0,0 +1,26 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "code.h"
+
+// lowers a program and its static data, with their labels still in place as
+// compile_labelled leaves them, to a static x86-64 Linux executable
+//
+// memory is a mmap'd region the size of the emulator's, the data is copied
+// in near its bottom and the stack starts at the top. Each instruction
+// becomes a few native instructions, branches jump straight to the code of
+// their label and lis of a label in the program loads its native address,
+// so jumps through registers need no lookup. Stores to the print address
+// go through a buffered write to stdout, returning to the termination
+// address exits with $3 as the status. The first two command line arguments
+// are the inputs, invalid instructions, jumps and accesses end the process
+// with a signal
+std::vector<uint8_t> lower_x86_64(
+    const std::vector<std::shared_ptr<Code>>& program,
+    const std::vector<std::shared_ptr<Code>>& data
+);
@@ -0,0 +1,34 @@
+
+#include "profile.h"
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+Profile read_profile(std::string path) {
+    std::ifstream file {path};
+    if (!file) {
+        std::cerr << "Invalid profile path: " << path << std::endl;
+        exit(1);
+    }
+
+    Profile profile;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields {line};
+        uint64_t count;
+        std::string name;
+        if (!(fields >> count) || !std::getline(fields >> std::ws, name)) {
+            continue;
+        }
+        profile[name] += count;
+    }
+    return profile;
+}
+
+uint64_t profile_count(const Profile& profile, std::string name) {
+    auto entry = profile.find(name);
+    return entry == profile.end() ? 0 : entry->second;
+}
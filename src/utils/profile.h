@@ -0,0 +1,18 @@
+
+#pragma once
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+// how often each label was reached in runs of the emulator, keyed by label
+// name, labels sharing a name (inlined copies, overloads) are counted
+// together
+using Profile = std::map<std::string, uint64_t>;
+
+// reads lines of "<count> <label name>", counts of repeated names add up
+Profile read_profile(std::string path);
+
+// count of the label named name, 0 for labels the profile never reached
+uint64_t profile_count(const Profile& profile, std::string name);
@@ -40,6 +40,54 @@ std::string to_string(Reg reg) {
         case Reg::Scratch3:
             result = "Scratch3";
             break;
+        case Reg::Arg1:
+            result = "Arg1";
+            break;
+        case Reg::Arg2:
+            result = "Arg2";
+            break;
+        case Reg::Arg3:
+            result = "Arg3";
+            break;
+        case Reg::Arg4:
+            result = "Arg4";
+            break;
+        case Reg::Local1:
+            result = "Local1";
+            break;
+        case Reg::Local2:
+            result = "Local2";
+            break;
+        case Reg::Local3:
+            result = "Local3";
+            break;
+        case Reg::Local4:
+            result = "Local4";
+            break;
+        case Reg::Local5:
+            result = "Local5";
+            break;
+        case Reg::Local6:
+            result = "Local6";
+            break;
+        case Reg::Local7:
+            result = "Local7";
+            break;
+        case Reg::Local8:
+            result = "Local8";
+            break;
+        case Reg::Local9:
+            result = "Local9";
+            break;
+        case Reg::Local10:
+            result = "Local10";
+            break;
+        case Reg::Local11:
+            result = "Local11";
+            break;
+        case Reg::Local12:
+            result = "Local12";
+            break;
         case Reg::FromSpaceEnd:
             result = "FromSpaceEnd";
             break;
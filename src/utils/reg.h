@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -19,6 +20,22 @@ enum class Reg {
     TargetPC = 8,
     ScratchPtrForGC = 9,
     Scratch3 = 10,
+    Arg1 = 11,
+    Arg2 = 12,
+    Arg3 = 13,
+    Arg4 = 14,
+    Local1 = 15,
+    Local2 = 16,
+    Local3 = 17,
+    Local4 = 18,
+    Local5 = 19,
+    Local6 = 20,
+    Local7 = 21,
+    Local8 = 22,
+    Local9 = 23,
+    Local10 = 24,
+    Local11 = 25,
+    Local12 = 26,
     FromSpaceEnd = 27,
     HeapPtr = 28,
     FramePtr = 29,
@@ -28,3 +45,22 @@ enum class Reg {
 
 std::string to_string(Reg);
 std::ostream& operator<<(std::ostream&, const Reg);
+
+// registers carrying the first arguments of a call
+const std::array<Reg, 4> arg_regs =
+    {Reg::Arg1, Reg::Arg2, Reg::Arg3, Reg::Arg4};
+
+// registers holding the variables of procedures without a frame
+const std::array<Reg, 12> local_regs = {
+    Reg::Local1,
+    Reg::Local2,
+    Reg::Local3,
+    Reg::Local4,
+    Reg::Local5,
+    Reg::Local6,
+    Reg::Local7,
+    Reg::Local8,
+    Reg::Local9,
+    Reg::Local10,
+    Reg::Local11,
+    Reg::Local12};
@@ -39,6 +39,8 @@ std::string state::to_string(Terminal terminal) {
             return "AS";
         case Terminal::NEW:
             return "NEW";
+        case Terminal::IN:
+            return "IN";
         case Terminal::DELETE:
             return "DELETE";
         case Terminal::I32:
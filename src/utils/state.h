@@ -22,9 +22,11 @@ enum class Terminal {
     COLON,
     AS,
     NEW,
+    IN,
     DELETE,
     TYPE,
     STRUCT,
+    COMPACT,
     I32,
     BOOL,
     CHAR,
@@ -0,0 +1,73 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "type_mismatch_error.h"
+#include "utils.h"
+
+TEST_CASE("arena objects are freed by a reset", "[arena]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_arena.nl",
+    };
+    auto program = compile(input_file_paths);
+
+    REQUIRE(emulate(program, 3, 7) == "84\ntrue\n64\n0\n");
+    REQUIRE(emulate(program, 1, 0) == "0\ntrue\n64\n0\n");
+    // rounds that do not fit grow the arena until one chunk holds them
+    REQUIRE(emulate(program, 10, 100) == "54000\ntrue\n256\n0\n");
+    REQUIRE(emulate(program, 100, 50) == "370000\ntrue\n2048\n0\n");
+
+    CompileOptions options;
+    options.select_instructions = false;
+    auto unselected = compile(input_file_paths, options);
+    REQUIRE(emulate(unselected, 10, 100) == "54000\ntrue\n256\n0\n");
+}
+
+TEST_CASE("arena objects are collected with the heap", "[arena]") {
+    CompileOptions options;
+    options.gc = true;
+    auto program = compile({examples_dir + "/test_arena.nl"}, options);
+
+    // the arena is never used so its first chunk is all it has
+    REQUIRE(emulate(program, 100, 50) == "370000\nfalse\n64\n0\n");
+}
+
+TEST_CASE("arena arrays are printed like heap arrays", "[arena]") {
+    std::string input =
+        "mod main;"
+        "import print;"
+        "import arena;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let arena = Arena(16);"
+        "    let point = new i32[2] in arena;"
+        "    let arr = new i32[x] in arena;"
+        "    let i = 0;"
+        "    while (i < x) {"
+        "        arr[i] = y - i;"
+        "        i = i + 1;"
+        "    }"
+        "    print(arr);"
+        "    println(\"\");"
+        "    arena.destruct();"
+        "    return 0;"
+        "}";
+
+    std::string file_name = test_file(".nl");
+    std::ofstream file {file_name};
+    file << input;
+    file.close();
+    auto program = compile({file_name});
+
+    // the second array only fits in a chunk the arena grows
+    REQUIRE(emulate(program, 4, 9) == "9 8 7 6 \n0\n");
+    REQUIRE(emulate(program, 1, 5) == "5 \n0\n");
+}
+
+TEST_CASE("objects are only placed in arenas", "[arena]") {
+    std::string input =
+        "mod a; fn main(x: i32, y: i32) -> i32 { let z = new i32 in x; }";
+    REQUIRE_THROWS_AS(compile_test(input), TypeMismatchError);
+}
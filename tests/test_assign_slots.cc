@@ -0,0 +1,113 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+#include "assign_slots.h"
+#include "beq_label.h"
+#include "bne_label.h"
+#include "block.h"
+#include "define_label.h"
+#include "label.h"
+#include "reg.h"
+#include "var_access.h"
+#include "variable.h"
+
+TEST_CASE("disjoint lifetimes share a slot", "[assign_slots]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto else_label = std::make_shared<Label>("else");
+    auto end_label = std::make_shared<Label>("end");
+
+    // x and y are declared in sibling scopes
+    auto code = make_block(
+        {make_beq(Reg::Result, Reg::Zero, else_label),
+         make_write(x, Reg::Result),
+         make_read(Reg::Result, x),
+         make_beq(Reg::Zero, Reg::Zero, end_label),
+         make_define(else_label),
+         make_write(y, Reg::Result),
+         make_read(Reg::Result, y),
+         make_define(end_label)}
+    );
+
+    auto slots = assign_slots(code, {x, y});
+    REQUIRE(slots.at(x) == 0);
+    REQUIRE(slots.at(y) == 0);
+    REQUIRE(slot_count(slots) == 1);
+}
+
+TEST_CASE("overlapping lifetimes get their own slots", "[assign_slots]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto z = std::make_shared<Variable>("z");
+
+    // x is still live when y is written, z starts after both are dead
+    auto code = make_block(
+        {make_write(x, Reg::Result),
+         make_write(y, Reg::Result),
+         make_read(Reg::Result, x),
+         make_read(Reg::Result, y),
+         make_write(z, Reg::Result),
+         make_read(Reg::Result, z)}
+    );
+
+    auto slots = assign_slots(code, {x, y, z});
+    REQUIRE(slots.at(x) != slots.at(y));
+    REQUIRE(slot_count(slots) == 2);
+}
+
+TEST_CASE("variables live around a loop interfere", "[assign_slots]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto top = std::make_shared<Label>("top");
+
+    // x is read on the next iteration after y's last read
+    auto code = make_block(
+        {make_write(x, Reg::Result),
+         make_define(top),
+         make_read(Reg::Result, x),
+         make_write(y, Reg::Result),
+         make_read(Reg::Result, y),
+         make_bne(Reg::Result, Reg::Zero, top)}
+    );
+
+    auto slots = assign_slots(code, {x, y});
+    REQUIRE(slots.at(x) != slots.at(y));
+}
+
+TEST_CASE("address taken variables are never shared", "[assign_slots]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+
+    auto code = make_block(
+        {make_write(x, Reg::Result),
+         make_read_address(Reg::Result, x),
+         make_write(y, Reg::Result),
+         make_read(Reg::Result, y)}
+    );
+
+    auto slots = assign_slots(code, {x, y});
+    REQUIRE(slots.at(x) != slots.at(y));
+    REQUIRE(slot_count(slots) == 2);
+}
+
+TEST_CASE("objects take a run of slots of their own", "[assign_slots]") {
+    auto x = std::make_shared<Variable>("x");
+    auto object = std::make_shared<Variable>("object", 3);
+    auto y = std::make_shared<Variable>("y");
+
+    auto code = make_block(
+        {make_write(x, Reg::Result),
+         make_read(Reg::Result, x),
+         make_read_address(Reg::Result, object),
+         make_write(y, Reg::Result),
+         make_read(Reg::Result, y)}
+    );
+
+    auto slots = assign_slots(code, {x, object, y});
+    REQUIRE(slots.at(x) == 0);
+    REQUIRE(slots.at(y) == 0);
+    REQUIRE(slots.at(object) == 1);
+    REQUIRE(slot_count(slots) == 4);
+}
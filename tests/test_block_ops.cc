@@ -0,0 +1,58 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "type_mismatch_error.h"
+#include "utils.h"
+
+TEST_CASE("copy and fill cover whole and partial turns", "[block_ops]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_block_ops.nl",
+    };
+    auto program = compile(input_file_paths);
+
+    REQUIRE(
+        emulate(program, 0, 5)
+        == "45\n-2\n17\n1\n-azzzzzzzz\nby\ntrue\n0\n"
+    );
+    REQUIRE(
+        emulate(program, 10, -2)
+        == "-38\n-2\n37\n1\n-azzzzzzzzzzzzzzzzzz\nlo\ntrue\n0\n"
+    );
+    std::string forty = "49\n-2\n97\n1\n-a" + std::string(48, 'z')
+        + "\npk\ntrue\n0\n";
+    REQUIRE(emulate(program, 40, 1) == forty);
+
+    // with a word per char, chars and the struct of two chars are moved a
+    // word at a time
+    CompileOptions options;
+    options.select_instructions = false;
+    auto unselected = compile(input_file_paths, options);
+    REQUIRE(
+        emulate(unselected, 10, -2)
+        == "-38\n-2\n37\n1\n-azzzzzzzzzzzzzzzzzz\nlo\ntrue\n0\n"
+    );
+    REQUIRE(emulate(unselected, 40, 1) == forty);
+}
+
+TEST_CASE("copy and fill check their operands", "[block_ops]") {
+    std::string mixed =
+        "mod a; fn main(x: i32, y: i32) -> i32 { let c = 'c'; "
+        "copy(&x, &c, 1); return 0; }";
+    REQUIRE_THROWS_AS(compile_test(mixed), TypeMismatchError);
+
+    std::string value =
+        "mod a; fn main(x: i32, y: i32) -> i32 { fill(&x, 'c', 1); "
+        "return 0; }";
+    REQUIRE_THROWS_AS(compile_test(value), TypeMismatchError);
+}
+
+TEST_CASE("functions named copy take precedence", "[block_ops]") {
+    std::string input =
+        "mod a; fn copy(a: *i32, b: *i32, n: i32) -> i32 { return n + 1; } "
+        "fn main(x: i32, y: i32) -> i32 { return copy(&x, &y, x); }";
+    auto program = compile_test(input);
+    REQUIRE(emulate(program, 4, 0) == "5\n");
+}
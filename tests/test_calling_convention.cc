@@ -0,0 +1,68 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "utils.h"
+
+TEST_CASE("register and stack arguments", "[calls]") {
+    std::string input =
+        "mod main;"
+        "fn weigh(a: i32, b: i32, c: i32, d: i32, e: i32, f: i32) -> i32 {"
+        "    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f;"
+        "}"
+        "fn leaf(a: i32, b: i32) -> i32 {"
+        "    let c: i32 = a * b;"
+        "    let d: i32 = c - a;"
+        "    return d + b;"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return weigh(leaf(x, y), x, y, leaf(y, x), 1, weigh(1, 0, 0, 0, "
+        "0, y));"
+        "}";
+
+    auto program = compile_test(input);
+
+    // leaf(x, y) = x * y - x + y, weigh(1, 0, 0, 0, 0, y) = 1 + 6 * y
+    REQUIRE(stoi(emulate(program, 2, 3)) == 159);
+    REQUIRE(stoi(emulate(program, -1, 4)) == 130);
+}
+
+TEST_CASE("recursive call with register arguments", "[calls]") {
+    std::string input =
+        "mod main;"
+        "fn sum(n: i32, acc: i32) -> i32 {"
+        "    if (n == 0) {"
+        "        return acc;"
+        "    }"
+        "    return sum(n - 1, acc + n);"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return sum(x, y);"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 10, 0)) == 55);
+    REQUIRE(stoi(emulate(program, 4, 100)) == 110);
+}
+
+TEST_CASE("recursive call with stack arguments", "[calls]") {
+    std::string input =
+        "mod main;"
+        "fn walk(n: i32, b: i32, c: i32, d: i32, e: i32, f: i32) -> i32 {"
+        "    let x: i32 = e * 10 + f;"
+        "    if (n > 0) {"
+        "        x = x + walk(n - 1, b, c, d, e + 1, f + 2);"
+        "    }"
+        "    return x + n + b + c + d;"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return walk(x, y, 3, 4, 5, 6);"
+        "}";
+
+    auto program = compile_test(input);
+
+    // every frame reads its own stack arguments after the nested call
+    REQUIRE(stoi(emulate(program, 3, 5)) == 350);
+    REQUIRE(stoi(emulate(program, 0, 0)) == 63);
+}
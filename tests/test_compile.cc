@@ -3,9 +3,6 @@
 #include <string>
 
 #include "utils.h"
-#include "write_file.h"
-
-static std::string file_name = "test_compile.bin";
 
 TEST_CASE("compile simple program", "[programs]") {
     std::string input =
@@ -24,10 +21,9 @@ TEST_CASE("compile simple program", "[programs]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 1, 10)) == 1);
-    REQUIRE(stoi(emulate(file_name, 2, 6)) == 64);
-    REQUIRE(stoi(emulate(file_name, 3, 4)) == 81);
-    REQUIRE(stoi(emulate(file_name, 2, 10)) == 1024);
+    REQUIRE(stoi(emulate(program, 1, 10)) == 1);
+    REQUIRE(stoi(emulate(program, 2, 6)) == 64);
+    REQUIRE(stoi(emulate(program, 3, 4)) == 81);
+    REQUIRE(stoi(emulate(program, 2, 10)) == 1024);
 }
@@ -0,0 +1,69 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "utils.h"
+
+TEST_CASE("comparisons in branch context", "[conditions]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let result: i32 = 0;"
+        "    if (x == y) { result = result + 1; }"
+        "    if (x != y) { result = result + 2; }"
+        "    if (x < y) { result = result + 4; }"
+        "    if (x > y) { result = result + 8; }"
+        "    if (x <= y) { result = result + 16; }"
+        "    if (x >= y) { result = result + 32; }"
+        "    if (!(x < y)) { result = result + 64; }"
+        "    return result;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 3, 3)) == 1 + 16 + 32 + 64);
+    REQUIRE(stoi(emulate(program, 2, 3)) == 2 + 4 + 16);
+    REQUIRE(stoi(emulate(program, 3, -2)) == 2 + 8 + 32 + 64);
+}
+
+TEST_CASE("short circuit boolean operators", "[conditions]") {
+    std::string input =
+        "mod main;"
+        "fn bump(counter: *i32) -> bool {"
+        "    *counter = *counter + 1;"
+        "    return true;"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let calls: i32 = 0;"
+        "    let hits: i32 = 0;"
+        "    if (x == 1 || bump(&calls)) { hits = hits + 1; }"
+        "    if (x == 1 && bump(&calls)) { hits = hits + 1; }"
+        "    let both: bool = y > 0 && bump(&calls);"
+        "    if (both) { hits = hits + 1; }"
+        "    return 10 * calls + hits;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 1, 0)) == 10 + 2);
+    REQUIRE(stoi(emulate(program, 0, 0)) == 10 + 1);
+    REQUIRE(stoi(emulate(program, 0, 5)) == 20 + 2);
+}
+
+TEST_CASE("while loop with compound condition", "[conditions]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let i: i32 = 0;"
+        "    while (i < x && i * i < y) {"
+        "        i = i + 1;"
+        "    }"
+        "    return i;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 0, 100)) == 0);
+    REQUIRE(stoi(emulate(program, 20, 50)) == 8);
+    REQUIRE(stoi(emulate(program, 5, 1000)) == 5);
+}
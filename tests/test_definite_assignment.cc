@@ -0,0 +1,84 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "beq_label.h"
+#include "bne_label.h"
+#include "block.h"
+#include "define_label.h"
+#include "definite_assignment.h"
+#include "label.h"
+#include "reg.h"
+#include "var_access.h"
+#include "variable.h"
+
+TEST_CASE("straight line definite assignment", "[definite_assignment]") {
+    auto param = std::make_shared<Variable>("param");
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+
+    auto code = make_block(
+        {make_read(Reg::Result, param),
+         make_write(x, Reg::Result),
+         make_read(Reg::Result, x),
+         make_read(Reg::Result, y)}
+    );
+
+    auto unassigned = maybe_unassigned(code, {param});
+    REQUIRE(unassigned == std::set<std::shared_ptr<Variable>> {y});
+}
+
+TEST_CASE("definite assignment over branches", "[definite_assignment]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto else_label = std::make_shared<Label>("else");
+    auto end_label = std::make_shared<Label>("end");
+
+    // x is written on both paths, y only on one
+    auto code = make_block(
+        {make_beq(Reg::Result, Reg::Zero, else_label),
+         make_write(x, Reg::Result),
+         make_write(y, Reg::Result),
+         make_beq(Reg::Zero, Reg::Zero, end_label),
+         make_define(else_label),
+         make_write(x, Reg::Result),
+         make_define(end_label),
+         make_read(Reg::Result, x),
+         make_read(Reg::Result, y)}
+    );
+
+    auto unassigned = maybe_unassigned(code, {});
+    REQUIRE(unassigned == std::set<std::shared_ptr<Variable>> {y});
+}
+
+TEST_CASE("definite assignment around loops", "[definite_assignment]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto top = std::make_shared<Label>("top");
+
+    // y is read at the top of the loop before its first write
+    auto code = make_block(
+        {make_write(x, Reg::Result),
+         make_define(top),
+         make_read(Reg::Result, x),
+         make_read(Reg::Result, y),
+         make_write(y, Reg::Result),
+         make_bne(Reg::Result, Reg::Zero, top)}
+    );
+
+    auto unassigned = maybe_unassigned(code, {});
+    REQUIRE(unassigned == std::set<std::shared_ptr<Variable>> {y});
+}
+
+TEST_CASE("address taken variables are unassigned", "[definite_assignment]") {
+    auto x = std::make_shared<Variable>("x");
+
+    auto code = make_block(
+        {make_write(x, Reg::Result), make_read_address(Reg::Result, x)}
+    );
+
+    auto unassigned = maybe_unassigned(code, {});
+    REQUIRE(unassigned == std::set<std::shared_ptr<Variable>> {x});
+}
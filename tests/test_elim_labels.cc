@@ -4,10 +4,12 @@
 #include <bitset>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_vector.hpp>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "assembly.h"
 #include "beq_label.h"
 #include "bne_label.h"
 #include "catch2/matchers/catch_matchers.hpp"
@@ -261,3 +263,58 @@ TEST_CASE("bne & beq adjacent", "[labels]") {
             5})
     );
 }
+
+TEST_CASE("branches out of range become long jumps", "[labels]") {
+    auto near = std::make_shared<Label>("near");
+    auto far = std::make_shared<Label>("far");
+
+    Reg r1 = Reg::Scratch;
+    Reg r2 = Reg::Result;
+    // near is in range until the branch to far grows into a long jump
+    std::vector<std::shared_ptr<Code>> program1 = {
+        make_beq(r1, r2, near),  // address 0
+        make_bne(r1, r2, far),  // 4
+    };
+    program1.insert(program1.end(), 32765, make_word(0));
+    program1.push_back(make_define(near));
+    program1.insert(program1.end(), 40000, make_word(0));
+    program1.push_back(make_define(far));
+    program1.push_back(make_beq(r1, r2, near));
+
+    auto program2 = word_to_uint(elim_labels(program1));
+
+    uint32_t near_address = (8 + 32765) * 4;
+    uint32_t far_address = (8 + 32765 + 40000) * 4;
+    auto expected = word_to_uint({
+        make_bne(r1, r2, 3),
+        make_lis(Reg::Scratch3),
+        make_word(near_address),
+        make_jr(Reg::Scratch3),
+        make_beq(r1, r2, 3),
+        make_lis(Reg::Scratch3),
+        make_word(far_address),
+        make_jr(Reg::Scratch3),
+    });
+    REQUIRE(program2.size() == 8 + 32765 + 40000 + 4);
+    REQUIRE_THAT(
+        std::vector<uint32_t>(program2.begin(), std::next(program2.begin(), 8)),
+        Catch::Matchers::Equals(expected)
+    );
+    // backwards branches are relaxed the same way
+    REQUIRE(program2.at(8 + 32765 + 40000 + 2) == near_address);
+}
+
+TEST_CASE("branches in range are kept", "[labels]") {
+    auto label = std::make_shared<Label>("label1");
+
+    Reg r1 = Reg::Scratch;
+    Reg r2 = Reg::Result;
+    std::vector<std::shared_ptr<Code>> program1 = {make_beq(r1, r2, label)};
+    program1.insert(program1.end(), 32767, make_word(0));
+    program1.push_back(make_define(label));
+
+    auto program2 = word_to_uint(elim_labels(program1));
+
+    REQUIRE(program2.size() == 32768);
+    REQUIRE(program2.at(0) == word_to_uint({make_beq(r1, r2, 32767)}).at(0));
+}
@@ -0,0 +1,185 @@
+
+#include <stdint.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "assembly.h"
+#include "emulator.h"
+#include "reg.h"
+#include "utils.h"
+#include "word.h"
+#include "write_file.h"
+
+struct Code;
+
+// runs program in the interpreter and translated, which must agree
+static EmulatorResult run_both(
+    std::vector<std::shared_ptr<Code>> program,
+    int32_t input1,
+    int32_t input2
+) {
+    auto interpreted = run(word_to_uint(program), input1, input2);
+    auto translated = run_jit(word_to_uint(program), input1, input2, true);
+    REQUIRE(translated.output == interpreted.output);
+    REQUIRE(translated.result == interpreted.result);
+    REQUIRE(translated.steps == interpreted.steps);
+    return interpreted;
+}
+
+TEST_CASE("inputs and result", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_sub(Reg::Result, Reg::Input1, Reg::Input2),
+        make_jr(Reg::Link),
+    };
+
+    auto result = run_both(program, 3, 10);
+    REQUIRE(result.result == -7);
+    REQUIRE(result.output.empty());
+    REQUIRE(result.steps == 2);
+}
+
+TEST_CASE("printing through the print address", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Scratch),
+        make_word(PRINT_ADDRESS),
+        make_addi(Reg::Scratch2, Reg::Zero, 'o'),
+        make_lis(Reg::Result),
+        make_word('h'),
+        make_sw(Reg::Result, 0, Reg::Scratch),
+        make_sb(Reg::Scratch2, 0, Reg::Scratch),
+        make_jr(Reg::Link),
+    };
+
+    auto result = run_both(program, 0, 0);
+    REQUIRE(result.output == "ho");
+    REQUIRE(result.result == 'h');
+}
+
+TEST_CASE("bytes are little endian within a word", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Scratch),
+        make_word(0x11223380),
+        make_sw(Reg::Scratch, (uint16_t)-4, Reg::StackPtr),
+        make_lb(Reg::Scratch2, (uint16_t)-4, Reg::StackPtr),
+        make_lbu(Reg::Result, (uint16_t)-3, Reg::StackPtr),
+        make_add(Reg::Result, Reg::Result, Reg::Scratch2),
+        make_sb(Reg::Zero, (uint16_t)-1, Reg::StackPtr),
+        make_lw(Reg::Scratch, (uint16_t)-4, Reg::StackPtr),
+        make_lis(Reg::Scratch2),
+        make_word(0x00223380),
+        make_beq(Reg::Scratch, Reg::Scratch2, 1),
+        make_add(Reg::Result, Reg::Zero, Reg::Zero),
+        make_jr(Reg::Link),
+    };
+
+    // 0x33 + (signed char)0x80
+    auto result = run_both(program, 0, 0);
+    REQUIRE(result.result == 0x33 - 0x80);
+}
+
+TEST_CASE("writes to $0 are discarded", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_addi(Reg::Zero, Reg::Input1, 5),
+        make_add(Reg::Result, Reg::Zero, Reg::Zero),
+        make_jr(Reg::Link),
+    };
+
+    REQUIRE(run_both(program, 9, 0).result == 0);
+}
+
+TEST_CASE("calls and instruction counts", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        // sums 1 to input1 by calling the word at address 32
+        make_add(Reg::Scratch2, Reg::Link, Reg::Zero),
+        make_add(Reg::Result, Reg::Zero, Reg::Zero),
+        make_addi(Reg::TargetPC, Reg::Zero, 32),
+        make_beq(Reg::Input1, Reg::Zero, 3),
+        make_jalr(Reg::TargetPC),
+        make_addi(Reg::Input1, Reg::Input1, (uint16_t)-1),
+        make_beq(Reg::Zero, Reg::Zero, (uint16_t)-4),
+        make_jr(Reg::Scratch2),
+        make_add(Reg::Result, Reg::Result, Reg::Input1),
+        make_jr(Reg::Link),
+    };
+
+    auto result = run(word_to_uint(program), 4, 0, true);
+    REQUIRE(result.result == 10);
+    REQUIRE(result.counts.size() == program.size());
+    REQUIRE(result.counts[0] == 1);
+    REQUIRE(result.counts[3] == 5);
+    REQUIRE(result.counts[8] == 4);
+    REQUIRE(result.steps == 3 + 5 + 4 * 5 + 1);
+}
+
+TEST_CASE("invalid programs throw", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> unaligned = {
+        make_lw(Reg::Result, 2, Reg::Zero),
+        make_jr(Reg::Link),
+    };
+    REQUIRE_THROWS_AS(run(word_to_uint(unaligned), 0, 0), EmulatorError);
+    REQUIRE_THROWS_AS(run_jit(word_to_uint(unaligned), 0, 0), EmulatorError);
+
+    std::vector<std::shared_ptr<Code>> invalid = {
+        make_word(0xffffffff),
+    };
+    REQUIRE_THROWS_AS(run(word_to_uint(invalid), 0, 0), EmulatorError);
+    REQUIRE_THROWS_AS(run_jit(word_to_uint(invalid), 0, 0), EmulatorError);
+
+    std::vector<std::shared_ptr<Code>> past_end = {
+        make_add(Reg::Result, Reg::Zero, Reg::Zero),
+    };
+    REQUIRE_THROWS_AS(run(word_to_uint(past_end), 0, 0), EmulatorError);
+    REQUIRE_THROWS_AS(run_jit(word_to_uint(past_end), 0, 0), EmulatorError);
+}
+
+TEST_CASE("binaries round trip through files", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_add(Reg::Result, Reg::Input1, Reg::Input2),
+        make_jr(Reg::Link),
+    };
+
+    std::string file_name = test_file(".bin");
+    write_file(file_name, program);
+    REQUIRE(read_program(file_name) == word_to_uint(program));
+    REQUIRE(run_jit(read_program(file_name), 2, 3).result == 5);
+}
+
+TEST_CASE("stores into running code", "[emulator]") {
+    auto patch = make_addi(Reg::Result, Reg::Result, 10);
+    std::vector<std::shared_ptr<Code>> program = {
+        make_addi(Reg::Result, Reg::Zero, 0),
+        make_lis(Reg::Scratch),
+        patch,
+        make_addi(Reg::Scratch2, Reg::Zero, 2),
+        // the word at 16, replaced by the patch after its first run
+        make_addi(Reg::Result, Reg::Result, 1),
+        make_sw(Reg::Scratch, 16, Reg::Zero),
+        make_addi(Reg::Scratch2, Reg::Scratch2, (uint16_t)-1),
+        make_bne(Reg::Scratch2, Reg::Zero, (uint16_t)-4),
+        make_jr(Reg::Link),
+    };
+
+    REQUIRE(run_both(program, 0, 0).result == 11);
+}
+
+TEST_CASE("translated division and shifts", "[emulator]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_div(Reg::Input1, Reg::Input2),
+        make_mflo(Reg::Result),
+        make_mfhi(Reg::Scratch),
+        make_sll(Reg::Result, Reg::Result, 4),
+        make_add(Reg::Result, Reg::Result, Reg::Scratch),
+        make_addi(Reg::Scratch, Reg::Zero, 1),
+        make_srav(Reg::Result, Reg::Result, Reg::Scratch),
+        make_slt(Reg::Scratch, Reg::Input1, Reg::Zero),
+        make_sub(Reg::Result, Reg::Result, Reg::Scratch),
+        make_jr(Reg::Link),
+    };
+
+    REQUIRE(run_both(program, 47, 5).result == (9 * 16 + 2) >> 1);
+    REQUIRE(run_both(program, -47, 5).result == ((-9 * 16 - 2) >> 1) - 1);
+    REQUIRE_THROWS_AS(run_jit(word_to_uint(program), 1, 0), EmulatorError);
+}
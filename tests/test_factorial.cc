@@ -13,12 +13,8 @@
 #include "block.h"
 #include "call.h"
 #include "chunk.h"
-#include "elim_calls.h"
-#include "elim_if_stmts.h"
+#include "compile_procedure.h"
 #include "elim_labels.h"
-#include "elim_scopes.h"
-#include "elim_vars_proc.h"
-#include "entry_exit.h"
 #include "flatten.h"
 #include "if_stmt.h"
 #include "operators.h"
@@ -29,12 +25,10 @@
 #include "utils.h"
 #include "variable.h"
 #include "word.h"
-#include "write_file.h"
 
 struct Code;
 
 static uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
-static std::string file_name("test_factorial.bin");
 
 // representation of test program
 uint32_t sample_factorial(uint32_t n) {
@@ -93,11 +87,6 @@ TEST_CASE("factorial program", "[programs]") {
     main_proc->code =
         make_block({make_call(factorial_proc, {input1->to_expr()})});
 
-    std::map<std::shared_ptr<Procedure>, std::shared_ptr<Chunk>> param_chunks;
-    for (auto proc : {main_proc, factorial_proc}) {
-        param_chunks[proc] = std::make_shared<Chunk>(proc->parameters);
-    }
-
     std::vector<std::shared_ptr<Procedure>> procedures = {
         main_proc,
         factorial_proc};
@@ -115,34 +104,7 @@ TEST_CASE("factorial program", "[programs]") {
     procedures.insert(procedures.begin(), start_proc);
 
     for (auto proc : procedures) {
-        ElimCalls elim_calls {proc, param_chunks};
-        proc->code = proc->code->accept(elim_calls);
-
-        ElimIfStmts elim_if_stmts;
-        proc->code = proc->code->accept(elim_if_stmts);
-
-        ElimScopes elim_scopes;
-        proc->code = proc->code->accept(elim_scopes);
-        auto local_vars = elim_scopes.get();
-
-        std::vector<std::shared_ptr<Variable>> all_local_vars = {
-            proc->param_ptr,
-            proc->dynamic_link,
-            proc->saved_pc};
-        all_local_vars
-            .insert(all_local_vars.end(), local_vars.begin(), local_vars.end());
-        std::shared_ptr<Chunk> local_vars_chunk =
-            std::make_shared<Chunk>(all_local_vars);
-
-        proc->code = add_entry_exit(proc, local_vars_chunk);
-
-        auto param_chunk = std::make_shared<Chunk>(proc->parameters);
-        ElimVarsProc elim_vars_proc(
-            local_vars_chunk,
-            param_chunk,
-            proc->param_ptr
-        );
-        proc->code = proc->code->accept(elim_vars_proc);
+        compile_procedure(proc);
     }
 
     std::vector<std::shared_ptr<Code>> all_code;
@@ -158,9 +120,7 @@ TEST_CASE("factorial program", "[programs]") {
 
     auto program3 = elim_labels(program2);
 
-    write_file(file_name, program3);
-
     for (auto input : {0, 1, 2, 3, 5, 6, 7, 8, 9}) {
-        REQUIRE(stoi(emulate(file_name, input, 0)) == sample_main(input, 0));
+        REQUIRE(stoi(emulate(program3, input, 0)) == sample_main(input, 0));
     }
 }
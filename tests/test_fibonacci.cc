@@ -26,12 +26,10 @@
 #include "variable.h"
 #include "while_loop.h"
 #include "word.h"
-#include "write_file.h"
 
 struct Code;
 
 static uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
-static std::string file_name("test_fibonacci.bin");
 
 // representation of test program
 int32_t sample_fibonacci(int32_t n) {
@@ -143,9 +141,7 @@ TEST_CASE("fibonacci program", "[programs]") {
 
     auto program7 = elim_labels(program6);
 
-    write_file(file_name, program7);
-
     for (auto input : {0, 1, 2, 3, 5, 10}) {
-        REQUIRE(stoi(emulate(file_name, input, 0)) == sample_fibonacci(input));
+        REQUIRE(stoi(emulate(program7, input, 0)) == sample_fibonacci(input));
     }
 }
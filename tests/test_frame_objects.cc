@@ -0,0 +1,39 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "utils.h"
+
+TEST_CASE("objects that never leave a call live in its frame", "[frames]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_frame_objects.nl",
+    };
+    auto program = compile(input_file_paths);
+
+    // the heap holds before and the returned point, nothing in between
+    REQUIRE(emulate(program, 3, 7) == "16\n8\n6\n7\n8\n0\n");
+    REQUIRE(emulate(program, 10, 5) == "962\n8\n55\n21\n8\n0\n");
+    REQUIRE(emulate(program, 100, -3) == "141000\n8\n5050\n201\n8\n0\n");
+
+    CompileOptions options;
+    options.select_instructions = false;
+    auto unselected = compile(input_file_paths, options);
+    REQUIRE(emulate(unselected, 10, 5) == "962\n8\n55\n21\n8\n0\n");
+
+    options.gc = true;
+    auto collected = compile(input_file_paths, options);
+    REQUIRE(emulate(collected, 10, 5) == "962\n12\n55\n21\n12\n0\n");
+}
+
+TEST_CASE("objects stay on the heap without frame objects", "[frames]") {
+    CompileOptions options;
+    options.frame_objects = false;
+    auto program =
+        compile({examples_dir + "/test_frame_objects.nl"}, options);
+
+    // every call of depth leaves its value on the heap before the point
+    REQUIRE(emulate(program, 3, 7) == "16\n8\n6\n7\n40\n0\n");
+    REQUIRE(emulate(program, 10, 5) == "962\n8\n55\n21\n96\n0\n");
+}
@@ -0,0 +1,50 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "utils.h"
+
+static CompileOptions gc_options(bool select_instructions = false) {
+    CompileOptions options;
+    options.gc = true;
+    options.select_instructions = select_instructions;
+    return options;
+}
+
+TEST_CASE("collected objects survive while reachable", "[gc]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_gc.nl",
+    };
+    auto program = compile(input_file_paths, gc_options());
+
+    // without collecting the garbage does not fit in memory
+    REQUIRE(emulate(program, 3000, 100) == "100\n3000\n2999\nj\n55\n0\n");
+    REQUIRE(emulate(program, 100, 7) == "7\n100\n99\nv\n55\n0\n");
+
+    auto packed = compile(input_file_paths, gc_options(true));
+    REQUIRE(emulate(packed, 3000, 100) == "100\n3000\n2999\nj\n55\n0\n");
+}
+
+TEST_CASE("modules behave the same when collected", "[gc]") {
+    for (std::string name : {"test_list_module", "test_string_module"}) {
+        std::vector<std::string> input_file_paths = {
+            examples_dir + "/" + name + ".nl",
+        };
+        auto freed = compile(input_file_paths);
+        auto collected = compile(input_file_paths, gc_options());
+        for (int32_t test_code = 1; test_code <= 9; ++test_code) {
+            REQUIRE(
+                emulate(collected, test_code, 0) == emulate(freed, test_code, 0)
+            );
+        }
+    }
+}
+
+TEST_CASE("arrays print the same when collected", "[gc]") {
+    auto program = compile({examples_dir + "/test_arr.nl"}, gc_options());
+
+    // print reads the size just before the data
+    REQUIRE(emulate(program, 0, 0) == "0 1 1 2 3 5 8 13 21 34 \n0\n");
+}
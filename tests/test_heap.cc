@@ -1,25 +1,30 @@
 
 #include <catch2/catch_test_macros.hpp>
+#include <fstream>
 #include <string>
 #include <vector>
 
 #include "compile.h"
 #include "utils.h"
-#include "write_file.h"
 
-static std::string file_name = "test_heap.bin";
+// objects that never outlive main would otherwise go in its frame, these
+// tests are about where blocks land on the heap
+static CompileOptions heap_options() {
+    CompileOptions options;
+    options.frame_objects = false;
+    return options;
+}
 
 TEST_CASE("simple heap", "[heap]") {
     std::vector<std::string> input_file_paths = {
         examples_dir + "/test_heap.nl",
     };
     auto program = compile(input_file_paths);
-    write_file(file_name, program);
 
-    REQUIRE(emulate(file_name, 5, 5) == "1\n1\n1\n0\n");
-    REQUIRE(emulate(file_name, 5, 1) == "1\n1\n1\n0\n");
-    REQUIRE(emulate(file_name, 5, 6) == "1\n1\n0\n0\n");
-    REQUIRE(emulate(file_name, 5, 10) == "1\n1\n0\n0\n");
+    REQUIRE(emulate(program, 5, 5) == "1\n1\n1\n0\n");
+    REQUIRE(emulate(program, 5, 1) == "1\n1\n1\n0\n");
+    REQUIRE(emulate(program, 5, 6) == "1\n1\n0\n0\n");
+    REQUIRE(emulate(program, 5, 10) == "1\n1\n0\n0\n");
 }
 
 TEST_CASE("array", "[heap]") {
@@ -27,7 +32,48 @@ TEST_CASE("array", "[heap]") {
         examples_dir + "/test_arr.nl",
     };
     auto program = compile(input_file_paths);
-    write_file(file_name, program);
 
-    REQUIRE(emulate(file_name, 0, 0) == "0 1 1 2 3 5 8 13 21 34 \n0\n");
+    REQUIRE(emulate(program, 0, 0) == "0 1 1 2 3 5 8 13 21 34 \n0\n");
+}
+
+TEST_CASE("freed blocks are reused", "[heap]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_heap_reuse.nl",
+    };
+    auto program = compile(input_file_paths, heap_options());
+
+    // the heap grows no further once the rounds repeat block sizes
+    REQUIRE(emulate(program, 40, 150) == "28\ntrue\n604\n0\n");
+    REQUIRE(emulate(program, 1000, 150) == "28\ntrue\n604\n0\n");
+    // the merged block is taken whole when too little of it is left
+    REQUIRE(emulate(program, 40, 301) == "28\ntrue\n1452\n0\n");
+    REQUIRE(emulate(program, 40, 302) == "28\nfalse\n-1452\n0\n");
+    // small requests never take large blocks
+    REQUIRE(emulate(program, 0, 3) == "8\nfalse\n-1452\n0\n");
+}
+
+TEST_CASE("blocks merge with free blocks on both sides", "[heap]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let a: *i32 = new i32[4];"
+        "    let b: *i32 = new i32[17];"
+        "    let c: *i32 = new i32[x];"
+        "    let d: *i32 = new i32[1];"
+        "    delete b;"
+        "    delete a;"
+        "    delete c;"
+        "    let e: *i32 = new i32[x + 23];"
+        "    return e as i32 - a as i32;"
+        "}";
+
+    std::string file_name = test_file(".nl");
+    std::ofstream file {file_name};
+    file << input;
+    file.close();
+    auto program = compile({file_name}, heap_options());
+
+    // a, b and c merge into one block that e takes
+    REQUIRE(emulate(program, 1, 0) == "0\n");
+    REQUIRE(emulate(program, 5, 0) == "0\n");
 }
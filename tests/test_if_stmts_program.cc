@@ -24,12 +24,10 @@
 #include "var_access.h"
 #include "variable.h"
 #include "word.h"
-#include "write_file.h"
 
 struct Code;
 
 static uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
-static std::string file_name("test_if_stmts_program.bin");
 
 TEST_CASE("if statements program", "[programs]") {
     std::shared_ptr<Variable> var1 =
@@ -94,9 +92,7 @@ TEST_CASE("if statements program", "[programs]") {
 
     auto program7 = elim_labels(program6);
 
-    write_file(file_name, program7);
-
-    REQUIRE(stoi(emulate(file_name, 5, 10)) == not_equal_val);
-    REQUIRE(stoi(emulate(file_name, 12, 12)) == equal_val);
-    REQUIRE(stoi(emulate(file_name, 17, 12)) == not_equal_val);
+    REQUIRE(stoi(emulate(program7, 5, 10)) == not_equal_val);
+    REQUIRE(stoi(emulate(program7, 12, 12)) == equal_val);
+    REQUIRE(stoi(emulate(program7, 17, 12)) == not_equal_val);
 }
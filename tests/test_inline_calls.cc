@@ -0,0 +1,120 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bin_op.h"
+#include "block.h"
+#include "call.h"
+#include "compile.h"
+#include "if_stmt.h"
+#include "inline_calls.h"
+#include "operators.h"
+#include "procedure.h"
+#include "pseudo_assembly.h"
+#include "ret_stmt.h"
+#include "utils.h"
+#include "variable.h"
+#include "visitor.h"
+
+class CountCalls: public Visitor<void> {
+  public:
+    int count = 0;
+
+    void visit(std::shared_ptr<Call> call) override {
+        count += 1;
+        Visitor<void>::visit(call);
+    }
+};
+
+static int count_calls(std::shared_ptr<Procedure> proc) {
+    CountCalls count_calls;
+    proc->code->accept(count_calls);
+    return count_calls.count;
+}
+
+TEST_CASE("inline small procedure", "[inline]") {
+    auto x = std::make_shared<Variable>("x");
+    auto y = std::make_shared<Variable>("y");
+    auto max = std::make_shared<Procedure>(
+        "max",
+        std::vector<std::shared_ptr<Variable>> {x, y}
+    );
+    max->code = make_if(
+        x->to_expr(),
+        op::gt_cmp(),
+        y->to_expr(),
+        std::make_shared<RetStmt>(x->to_expr()),
+        std::make_shared<RetStmt>(y->to_expr())
+    );
+
+    auto a = std::make_shared<Variable>("a");
+    auto main = std::make_shared<Procedure>(
+        "main",
+        std::vector<std::shared_ptr<Variable>> {a}
+    );
+    main->code = std::make_shared<RetStmt>(
+        make_call(
+            max,
+            {a->to_expr(), make_call(max, {a->to_expr(), int_literal(3)})}
+        )
+    );
+
+    std::vector<std::shared_ptr<Procedure>> procedures = {main, max};
+
+    SECTION("disabled") {
+        inline_calls(procedures, 0);
+        REQUIRE(count_calls(main) == 2);
+    }
+
+    SECTION("below threshold") {
+        inline_calls(procedures, 40);
+        REQUIRE(count_calls(main) == 0);
+    }
+
+    SECTION("above threshold") {
+        inline_calls(procedures, ir_size(max->code) - 1);
+        REQUIRE(count_calls(main) == 2);
+    }
+}
+
+TEST_CASE("recursive procedure not inlined", "[inline]") {
+    auto n = std::make_shared<Variable>("n");
+    auto countdown = std::make_shared<Procedure>(
+        "countdown",
+        std::vector<std::shared_ptr<Variable>> {n}
+    );
+    countdown->code = make_if(
+        n->to_expr(),
+        op::eq_cmp(),
+        int_literal(0),
+        std::make_shared<RetStmt>(int_literal(0)),
+        std::make_shared<RetStmt>(make_call(
+            countdown,
+            {bin_op(n->to_expr(), op::minus(), int_literal(1))}
+        ))
+    );
+
+    std::vector<std::shared_ptr<Procedure>> procedures = {countdown};
+    inline_calls(procedures, 1000);
+    REQUIRE(count_calls(countdown) == 1);
+}
+
+TEST_CASE("inlined program output", "[inline]") {
+    std::vector<std::string> input_file_paths = {
+        examples_dir + "/test_math_module.nl",
+    };
+
+    for (uint32_t threshold : {0, 40, 1000}) {
+        CompileOptions options;
+        options.inline_threshold = threshold;
+        auto program = compile(input_file_paths, options);
+
+        REQUIRE(stoi(emulate(program, 1, -5)) == 5);
+        REQUIRE(stoi(emulate(program, 3, 5)) == 120);
+        REQUIRE(stoi(emulate(program, 5, 12)) == 60);
+        REQUIRE(emulate(program, 7, 5) == "true\n0\n");
+        REQUIRE(stoi(emulate(program, 8, 10)) == 55);
+    }
+}
@@ -4,18 +4,16 @@
 
 #include "compile.h"
 #include "utils.h"
-#include "write_file.h"
 
 class ListModuleFixture {
   private:
-    static std::string file_name;
+    static std::vector<std::shared_ptr<Code>> program;
     static std::vector<std::string> input_file_paths;
     static bool initialized;
 
     static void initialize() {
         if (!initialized) {
-            auto program = compile(input_file_paths);
-            write_file(file_name, program);
+            program = compile(input_file_paths);
             initialized = true;
         }
     }
@@ -26,11 +24,11 @@ class ListModuleFixture {
     }
 
     std::string test_list_function(int test_code, int test_value) {
-        return emulate(file_name, test_code, test_value);
+        return emulate(program, test_code, test_value);
     }
 };
 
-std::string ListModuleFixture::file_name = "test_list_module.bin";
+std::vector<std::shared_ptr<Code>> ListModuleFixture::program;
 std::vector<std::string> ListModuleFixture::input_file_paths = {
     examples_dir + "/test_list_module.nl"};
 bool ListModuleFixture::initialized = false;
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "utils.h"
+
+class LoopOptimizationsFixture {
+  private:
+    static std::vector<std::shared_ptr<Code>> program;
+    static std::vector<std::string> input_file_paths;
+    static bool initialized;
+
+    static void initialize() {
+        if (!initialized) {
+            program = compile(input_file_paths);
+            initialized = true;
+        }
+    }
+
+  public:
+    LoopOptimizationsFixture() {
+        initialize();
+    }
+
+    std::string test_loop(int test_code, int test_value) {
+        return emulate(program, test_code, test_value);
+    }
+};
+
+std::vector<std::shared_ptr<Code>> LoopOptimizationsFixture::program;
+std::vector<std::string> LoopOptimizationsFixture::input_file_paths = {
+    examples_dir + "/test_loop_optimizations.nl"};
+bool LoopOptimizationsFixture::initialized = false;
+
+TEST_CASE_METHOD(
+    LoopOptimizationsFixture,
+    "hoisted field loads",
+    "[loop_optimizations]"
+) {
+    REQUIRE(test_loop(1, 1) == "34\n");
+    REQUIRE(test_loop(1, -3) == "-102\n");
+    REQUIRE(test_loop(2, 0) == "4\n");
+    REQUIRE(test_loop(2, 9) == "9\n");
+}
+
+TEST_CASE_METHOD(
+    LoopOptimizationsFixture,
+    "induction variable indexing",
+    "[loop_optimizations]"
+) {
+    REQUIRE(test_loop(3, 0) == "36\n");
+    REQUIRE(test_loop(3, 2) == "25\n");
+    REQUIRE(test_loop(3, 8) == "0\n");
+    REQUIRE(test_loop(4, 0) == "1234567\n");
+    REQUIRE(test_loop(4, 2) == "36\n");
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "emulator.h"
+#include "utils.h"
+
+class MapModuleFixture {
+  private:
+    static std::vector<std::shared_ptr<Code>> program;
+    static std::vector<std::string> input_file_paths;
+    static bool initialized;
+
+    static void initialize() {
+        if (!initialized) {
+            program = compile(input_file_paths);
+            initialized = true;
+        }
+    }
+
+  public:
+    MapModuleFixture() {
+        initialize();
+    }
+
+    std::string test_map_function(int test_code, int test_value) {
+        return emulate(program, test_code, test_value);
+    }
+
+    uint64_t test_map_steps(int test_code, int test_value) {
+        return run(word_to_uint(program), test_code, test_value).steps;
+    }
+};
+
+std::vector<std::shared_ptr<Code>> MapModuleFixture::program;
+std::vector<std::string> MapModuleFixture::input_file_paths = {
+    examples_dir + "/test_map_module.nl"};
+bool MapModuleFixture::initialized = false;
+
+TEST_CASE_METHOD(MapModuleFixture, "map operations", "[map]") {
+    REQUIRE(
+        test_map_function(1, 0)
+        == "true\n5\n55\n-50\n7\n2\n-1\ntrue\n9\n0\ntrue\nfalse\n4\n0\n"
+    );
+    REQUIRE(
+        test_map_function(3, 0)
+        == "5\n2\n1\n1\nfalse\ntrue\nfalse\n4\n0\n"
+    );
+}
+
+TEST_CASE_METHOD(MapModuleFixture, "maps grow and shift back", "[map]") {
+    REQUIRE(test_map_function(2, 0) == "0\n0\n0\n0\n8\n0\n");
+    REQUIRE(test_map_function(2, 6) == "4\n4\n2\n12\n8\n0\n");
+    REQUIRE(test_map_function(2, 100) == "66\n66\n34\n3267\n256\n0\n");
+    REQUIRE(
+        test_map_function(2, 5000) == "3333\n3333\n1667\n8331667\n8192\n0\n"
+    );
+    REQUIRE(test_map_function(4, 100) == "17\ntrue\n-1\n99\n0\n");
+    REQUIRE(test_map_function(4, 1000) == "17\ntrue\n-1\n999\n0\n");
+}
+
+TEST_CASE_METHOD(MapModuleFixture, "map lookups match list scans", "[map]") {
+    REQUIRE(test_map_function(5, 300) == "44850\n0\n");
+    REQUIRE(test_map_function(6, 300) == "44850\n0\n");
+}
+
+TEST_CASE("maps with a word per char", "[map]") {
+    CompileOptions options;
+    options.select_instructions = false;
+    auto program = compile({examples_dir + "/test_map_module.nl"}, options);
+
+    REQUIRE(
+        emulate(program, 3, 0) == "5\n2\n1\n1\nfalse\ntrue\nfalse\n4\n0\n"
+    );
+    REQUIRE(emulate(program, 4, 1000) == "17\ntrue\n-1\n999\n0\n");
+    REQUIRE(emulate(program, 2, 100) == "66\n66\n34\n3267\n256\n0\n");
+}
+
+TEST_CASE_METHOD(MapModuleFixture, "map lookups beat list scans", "[map]") {
+    uint64_t map_steps = test_map_steps(5, 1000);
+    uint64_t list_steps = test_map_steps(6, 1000);
+
+    // about 685K against 21.6M steps, the scans grow with the square of the
+    // number of keys and the lookups only with the number
+    REQUIRE(map_steps * 20 < list_steps);
+    REQUIRE(test_map_steps(5, 2000) < map_steps * 3);
+    REQUIRE(test_map_steps(6, 500) * 3 < list_steps);
+}
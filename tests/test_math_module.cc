@@ -4,18 +4,16 @@
 
 #include "compile.h"
 #include "utils.h"
-#include "write_file.h"
 
 class MathModuleFixture {
   private:
-    static std::string file_name;
+    static std::vector<std::shared_ptr<Code>> program;
     static std::vector<std::string> input_file_paths;
     static bool initialized;
 
     static void initialize() {
         if (!initialized) {
-            auto program = compile(input_file_paths);
-            write_file(file_name, program);
+            program = compile(input_file_paths);
             initialized = true;
         }
     }
@@ -26,11 +24,11 @@ class MathModuleFixture {
     }
 
     std::string test_math_function(int function_code, int y) {
-        return emulate(file_name, function_code, y);
+        return emulate(program, function_code, y);
     }
 };
 
-std::string MathModuleFixture::file_name = "test_math_module.bin";
+std::vector<std::shared_ptr<Code>> MathModuleFixture::program;
 std::vector<std::string> MathModuleFixture::input_file_paths = {
     examples_dir + "/test_math_module.nl"};
 bool MathModuleFixture::initialized = false;
@@ -3,9 +3,6 @@
 #include <string>
 
 #include "utils.h"
-#include "write_file.h"
-
-static std::string file_name = "test_operators.bin";
 
 TEST_CASE("plus", "[operators]") {
     std::string input =
@@ -15,13 +12,12 @@ TEST_CASE("plus", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 3, 5)) == 3 + 5);
-    REQUIRE(stoi(emulate(file_name, 15, 6)) == 15 + 6);
-    REQUIRE(stoi(emulate(file_name, 0, -8)) == 0 + -8);
-    REQUIRE(stoi(emulate(file_name, -4, 3)) == -4 + 3);
-    REQUIRE(stoi(emulate(file_name, -21, -6)) == -21 + -6);
+    REQUIRE(stoi(emulate(program, 3, 5)) == 3 + 5);
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 + 6);
+    REQUIRE(stoi(emulate(program, 0, -8)) == 0 + -8);
+    REQUIRE(stoi(emulate(program, -4, 3)) == -4 + 3);
+    REQUIRE(stoi(emulate(program, -21, -6)) == -21 + -6);
 }
 
 TEST_CASE("minus", "[operators]") {
@@ -32,13 +28,12 @@ TEST_CASE("minus", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 3, 5)) == 3 - 5);
-    REQUIRE(stoi(emulate(file_name, 15, 6)) == 15 - 6);
-    REQUIRE(stoi(emulate(file_name, 0, -8)) == 0 - -8);
-    REQUIRE(stoi(emulate(file_name, -4, 3)) == -4 - 3);
-    REQUIRE(stoi(emulate(file_name, -21, -6)) == -21 - -6);
+    REQUIRE(stoi(emulate(program, 3, 5)) == 3 - 5);
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 - 6);
+    REQUIRE(stoi(emulate(program, 0, -8)) == 0 - -8);
+    REQUIRE(stoi(emulate(program, -4, 3)) == -4 - 3);
+    REQUIRE(stoi(emulate(program, -21, -6)) == -21 - -6);
 }
 
 TEST_CASE("times", "[operators]") {
@@ -49,13 +44,12 @@ TEST_CASE("times", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 3, 5)) == 3 * 5);
-    REQUIRE(stoi(emulate(file_name, 15, 6)) == 15 * 6);
-    REQUIRE(stoi(emulate(file_name, 0, -8)) == 0 * -8);
-    REQUIRE(stoi(emulate(file_name, -4, 3)) == -4 * 3);
-    REQUIRE(stoi(emulate(file_name, -21, -6)) == -21 * -6);
+    REQUIRE(stoi(emulate(program, 3, 5)) == 3 * 5);
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 * 6);
+    REQUIRE(stoi(emulate(program, 0, -8)) == 0 * -8);
+    REQUIRE(stoi(emulate(program, -4, 3)) == -4 * 3);
+    REQUIRE(stoi(emulate(program, -21, -6)) == -21 * -6);
 }
 
 TEST_CASE("divide", "[operators]") {
@@ -66,13 +60,12 @@ TEST_CASE("divide", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 3, 5)) == 3 / 5);
-    REQUIRE(stoi(emulate(file_name, 15, 6)) == 15 / 6);
-    REQUIRE(stoi(emulate(file_name, 0, -8)) == 0 / -8);
-    REQUIRE(stoi(emulate(file_name, -4, 3)) == -4 / 3);
-    REQUIRE(stoi(emulate(file_name, -21, -6)) == -21 / -6);
+    REQUIRE(stoi(emulate(program, 3, 5)) == 3 / 5);
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 / 6);
+    REQUIRE(stoi(emulate(program, 0, -8)) == 0 / -8);
+    REQUIRE(stoi(emulate(program, -4, 3)) == -4 / 3);
+    REQUIRE(stoi(emulate(program, -21, -6)) == -21 / -6);
 }
 
 TEST_CASE("mod", "[operators]") {
@@ -83,13 +76,12 @@ TEST_CASE("mod", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 3, 5)) == 3 % 5);
-    REQUIRE(stoi(emulate(file_name, 15, 6)) == 15 % 6);
-    REQUIRE(stoi(emulate(file_name, 0, -8)) == 0 % -8);
-    REQUIRE(stoi(emulate(file_name, -4, 3)) == -4 % 3);
-    REQUIRE(stoi(emulate(file_name, -21, -6)) == -21 % -6);
+    REQUIRE(stoi(emulate(program, 3, 5)) == 3 % 5);
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 % 6);
+    REQUIRE(stoi(emulate(program, 0, -8)) == 0 % -8);
+    REQUIRE(stoi(emulate(program, -4, 3)) == -4 % 3);
+    REQUIRE(stoi(emulate(program, -21, -6)) == -21 % -6);
 }
 
 TEST_CASE("equal", "[operators]") {
@@ -100,14 +92,13 @@ TEST_CASE("equal", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 == 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 == 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 == 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 == 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 == -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 == 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 == 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 == 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 == 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 == 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 == -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 == 3));
 }
 
 TEST_CASE("not equal", "[operators]") {
@@ -118,14 +109,13 @@ TEST_CASE("not equal", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 != 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 != 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 != 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 != 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 != -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 != 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 != 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 != 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 != 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 != 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 != -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 != 3));
 }
 
 TEST_CASE("greater than", "[operators]") {
@@ -136,14 +126,13 @@ TEST_CASE("greater than", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 > 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 > 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 > 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 > 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 > -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 > 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 > 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 > 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 > 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 > 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 > -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 > 3));
 }
 
 TEST_CASE("greater than or equal to", "[operators]") {
@@ -154,14 +143,13 @@ TEST_CASE("greater than or equal to", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 >= 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 >= 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 >= 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 >= 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 >= -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 >= 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 >= 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 >= 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 >= 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 >= 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 >= -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 >= 3));
 }
 
 TEST_CASE("less than", "[operators]") {
@@ -172,14 +160,13 @@ TEST_CASE("less than", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 < 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 < 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 < 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 < 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 < -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 < 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 < 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 < 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 < 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 < 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 < -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 < 3));
 }
 
 TEST_CASE("less than or equal to", "[operators]") {
@@ -190,14 +177,13 @@ TEST_CASE("less than or equal to", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 4, 5)) == (4 <= 5));
-    REQUIRE(stoi(emulate(file_name, 7, 7)) == (7 <= 7));
-    REQUIRE(stoi(emulate(file_name, 9, 6)) == (9 <= 6));
-    REQUIRE(stoi(emulate(file_name, -4, 4)) == (-4 <= 4));
-    REQUIRE(stoi(emulate(file_name, -15, -15)) == (-15 <= -15));
-    REQUIRE(stoi(emulate(file_name, -12, 3)) == (-12 <= 3));
+
+    REQUIRE(stoi(emulate(program, 4, 5)) == (4 <= 5));
+    REQUIRE(stoi(emulate(program, 7, 7)) == (7 <= 7));
+    REQUIRE(stoi(emulate(program, 9, 6)) == (9 <= 6));
+    REQUIRE(stoi(emulate(program, -4, 4)) == (-4 <= 4));
+    REQUIRE(stoi(emulate(program, -15, -15)) == (-15 <= -15));
+    REQUIRE(stoi(emulate(program, -12, 3)) == (-12 <= 3));
 }
 
 TEST_CASE("and", "[operators]") {
@@ -208,15 +194,14 @@ TEST_CASE("and", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 0, 0)) == (0 && 0));
-    REQUIRE(stoi(emulate(file_name, 0, 1)) == (0 && 1));
-    REQUIRE(stoi(emulate(file_name, 1, 0)) == (1 && 0));
-    REQUIRE(stoi(emulate(file_name, 1, 1)) == (1 && 1));
-    REQUIRE(stoi(emulate(file_name, 15, 0)) == (15 && 0));
-    REQUIRE(stoi(emulate(file_name, 0, 27)) == (0 && 27));
-    REQUIRE(stoi(emulate(file_name, -29, 12)) == (-29 && 12));
+
+    REQUIRE(stoi(emulate(program, 0, 0)) == (0 && 0));
+    REQUIRE(stoi(emulate(program, 0, 1)) == (0 && 1));
+    REQUIRE(stoi(emulate(program, 1, 0)) == (1 && 0));
+    REQUIRE(stoi(emulate(program, 1, 1)) == (1 && 1));
+    REQUIRE(stoi(emulate(program, 15, 0)) == (15 && 0));
+    REQUIRE(stoi(emulate(program, 0, 27)) == (0 && 27));
+    REQUIRE(stoi(emulate(program, -29, 12)) == (-29 && 12));
 }
 
 TEST_CASE("or", "[operators]") {
@@ -227,15 +212,14 @@ TEST_CASE("or", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
-
-    REQUIRE(stoi(emulate(file_name, 0, 0)) == (0 || 0));
-    REQUIRE(stoi(emulate(file_name, 0, 1)) == (0 || 1));
-    REQUIRE(stoi(emulate(file_name, 1, 0)) == (1 || 0));
-    REQUIRE(stoi(emulate(file_name, 1, 1)) == (1 || 1));
-    REQUIRE(stoi(emulate(file_name, 15, 0)) == (15 || 0));
-    REQUIRE(stoi(emulate(file_name, 0, 27)) == (0 || 27));
-    REQUIRE(stoi(emulate(file_name, -29, 12)) == (-29 || 12));
+
+    REQUIRE(stoi(emulate(program, 0, 0)) == (0 || 0));
+    REQUIRE(stoi(emulate(program, 0, 1)) == (0 || 1));
+    REQUIRE(stoi(emulate(program, 1, 0)) == (1 || 0));
+    REQUIRE(stoi(emulate(program, 1, 1)) == (1 || 1));
+    REQUIRE(stoi(emulate(program, 15, 0)) == (15 || 0));
+    REQUIRE(stoi(emulate(program, 0, 27)) == (0 || 27));
+    REQUIRE(stoi(emulate(program, -29, 12)) == (-29 || 12));
 }
 
 TEST_CASE("not", "[operators]") {
@@ -246,12 +230,11 @@ TEST_CASE("not", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 0, 0)) == (!0));
-    REQUIRE(stoi(emulate(file_name, 1, 0)) == (!1));
-    REQUIRE(stoi(emulate(file_name, -5, 0)) == (!-5));
-    REQUIRE(stoi(emulate(file_name, 25, 0)) == (!25));
+    REQUIRE(stoi(emulate(program, 0, 0)) == (!0));
+    REQUIRE(stoi(emulate(program, 1, 0)) == (!1));
+    REQUIRE(stoi(emulate(program, -5, 0)) == (!-5));
+    REQUIRE(stoi(emulate(program, 25, 0)) == (!25));
 }
 
 TEST_CASE("ampersand and star", "[operators]") {
@@ -265,8 +248,36 @@ TEST_CASE("ampersand and star", "[operators]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 15, 0)) == 15);
-    REQUIRE(stoi(emulate(file_name, 6341, 0)) == 6341);
+    REQUIRE(stoi(emulate(program, 15, 0)) == 15);
+    REQUIRE(stoi(emulate(program, 6341, 0)) == 6341);
+}
+
+TEST_CASE("chained operators", "[operators]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return x - y + 1 - x / y * 4;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 15, 6)) == 15 - 6 + 1 - 15 / 6 * 4);
+    REQUIRE(stoi(emulate(program, -21, 5)) == -21 - 5 + 1 - -21 / 5 * 4);
+}
+
+TEST_CASE("store through dereferenced expressions", "[operators]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    let p = &x;"
+        "    *(p + 0) = y;"
+        "    *((p as i32) as *i32) = x + y;"
+        "    return x;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 3, 5)) == 10);
+    REQUIRE(stoi(emulate(program, -4, 6)) == 12);
 }
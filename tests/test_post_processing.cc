@@ -4,9 +4,6 @@
 #include <string>
 
 #include "utils.h"
-#include "write_file.h"
-
-static std::string file_name("test_post_processing.bin");
 
 TEST_CASE("code gen", "[post_processing]") {
     std::string input =
@@ -17,9 +14,8 @@ TEST_CASE("code gen", "[post_processing]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 5, 7)) == 12);
+    REQUIRE(stoi(emulate(program, 5, 7)) == 12);
 }
 
 TEST_CASE("two functions", "[post_processing]") {
@@ -33,9 +29,8 @@ TEST_CASE("two functions", "[post_processing]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 5, 7)) == 12);
+    REQUIRE(stoi(emulate(program, 5, 7)) == 12);
 }
 
 TEST_CASE("max func", "[post_processing]") {
@@ -57,7 +52,6 @@ TEST_CASE("max func", "[post_processing]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 5, 7)) == 7);
+    REQUIRE(stoi(emulate(program, 5, 7)) == 7);
 }
@@ -0,0 +1,144 @@
+
+#include <stdint.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "compile.h"
+#include "profile.h"
+#include "utils.h"
+
+static void write_text(std::string path, std::string text) {
+    std::ofstream out {path};
+    out << text;
+}
+
+// addresses of the labels written by --label-map, by name
+static std::multimap<std::string, uint32_t> read_label_map(std::string path) {
+    std::ifstream file {path};
+    std::multimap<std::string, uint32_t> result;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields {line};
+        uint32_t address;
+        std::string name;
+        fields >> address;
+        std::getline(fields >> std::ws, name);
+        result.insert({name, address});
+    }
+    return result;
+}
+
+static uint32_t address(
+    const std::multimap<std::string, uint32_t>& labels,
+    std::string name
+) {
+    return labels.find(name)->second;
+}
+
+static const std::string program =
+    "mod main;"
+    "fn pick(x: i32) -> i32 {"
+    "    let result: i32 = 0;"
+    "    if (x < 10) {"
+    "        result = x + 1;"
+    "    } else {"
+    "        result = x - 1;"
+    "    }"
+    "    return result;"
+    "}"
+    "fn other(x: i32) -> i32 {"
+    "    return x * 2;"
+    "}"
+    "fn main(x: i32, y: i32) -> i32 {"
+    "    return pick(x) + other(y);"
+    "}";
+
+TEST_CASE("profiles add up repeated labels", "[profile]") {
+    std::string profile_name = test_file(".profile");
+    write_text(
+        profile_name,
+        "3 procedure main body\n"
+        "4 main if 0 then\n"
+        "5 procedure main body\n"
+    );
+
+    Profile profile = read_profile(profile_name);
+    REQUIRE(profile_count(profile, "procedure main body") == 8);
+    REQUIRE(profile_count(profile, "main if 0 then") == 4);
+    REQUIRE(profile_count(profile, "main if 0 else") == 0);
+}
+
+TEST_CASE("label map names if else sides", "[profile]") {
+    std::string source_name = test_file(".nl");
+    std::string label_map_name = test_file(".labels");
+    write_text(source_name, program);
+    CompileOptions options;
+    options.inline_threshold = 0;
+    options.label_map_path = label_map_name;
+    auto binary = compile({source_name}, options);
+
+    auto labels = read_label_map(label_map_name);
+    REQUIRE(labels.contains("procedure pick body"));
+    REQUIRE(
+        address(labels, "pick if 0 then") < address(labels, "pick if 0 else")
+    );
+    REQUIRE(
+        address(labels, "procedure pick") < address(labels, "procedure other")
+    );
+
+    REQUIRE(stoi(emulate(binary, 3, 1)) == 6);
+    REQUIRE(stoi(emulate(binary, 30, 1)) == 31);
+}
+
+TEST_CASE("profile moves the cold side out of line", "[profile]") {
+    std::string source_name = test_file(".nl");
+    std::string label_map_name = test_file(".labels");
+    std::string profile_name = test_file(".profile");
+    write_text(source_name, program);
+    write_text(
+        profile_name,
+        "1 pick if 0 then\n"
+        "100 pick if 0 else\n"
+        "101 procedure other body\n"
+        "1 procedure pick body\n"
+    );
+    CompileOptions options;
+    options.inline_threshold = 0;
+    options.profile_path = profile_name;
+    options.label_map_path = label_map_name;
+    auto binary = compile({source_name}, options);
+
+    // the hot else falls through, the hotter procedure comes first
+    auto labels = read_label_map(label_map_name);
+    REQUIRE(
+        address(labels, "pick if 0 else") < address(labels, "pick if 0 then")
+    );
+    REQUIRE(
+        address(labels, "procedure other") < address(labels, "procedure pick")
+    );
+
+    REQUIRE(stoi(emulate(binary, 3, 1)) == 6);
+    REQUIRE(stoi(emulate(binary, 30, 1)) == 31);
+}
+
+TEST_CASE("profile keeps cold procedures out of line", "[profile]") {
+    std::string source_name = test_file(".nl");
+    std::string label_map_name = test_file(".labels");
+    std::string profile_name = test_file(".profile");
+    write_text(source_name, program);
+    write_text(profile_name, "100 procedure pick body\n");
+    CompileOptions options;
+    options.profile_path = profile_name;
+    options.label_map_path = label_map_name;
+    auto binary = compile({source_name}, options);
+
+    // other never ran, so it is called rather than inlined into main
+    auto labels = read_label_map(label_map_name);
+    REQUIRE(labels.count("procedure pick body") == 2);
+    REQUIRE(labels.count("procedure other body") == 1);
+    REQUIRE(stoi(emulate(binary, 3, 4)) == 12);
+}
@@ -0,0 +1,149 @@
+
+#include <stdint.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+#include <memory>
+#include <vector>
+
+#include "assembly.h"
+#include "catch2/matchers/catch_matchers.hpp"
+#include "reg.h"
+#include "select_instructions.h"
+#include "utils.h"
+#include "word.h"
+
+struct Code;
+
+TEST_CASE("immediate instruction encodings", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_addi(Reg::Result, Reg::Scratch, (uint16_t)-4),
+        make_ori(Reg::Result, Reg::Zero, 0xbeef),
+        make_lui(Reg::Result, 0x1234),
+        make_sll(Reg::Result, Reg::Scratch, 2),
+        make_lb(Reg::Result, 3, Reg::Scratch),
+        make_lbu(Reg::Result, 3, Reg::Scratch),
+        make_sb(Reg::Result, 3, Reg::Scratch),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(program),
+        Catch::Matchers::Equals(std::vector<uint32_t> {
+            0x2083fffc,
+            0x3403beef,
+            0x3c031234,
+            0x00041880,
+            0x80830003,
+            0x90830003,
+            0xa0830003})
+    );
+}
+
+TEST_CASE("small constants become immediates", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Result),
+        make_word(5),
+        make_lis(Reg::Scratch),
+        make_word(-1),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(select_instructions(program)),
+        Catch::Matchers::Equals(word_to_uint({
+            make_addi(Reg::Result, Reg::Zero, 5),
+            make_addi(Reg::Scratch, Reg::Zero, (uint16_t)-1),
+        }))
+    );
+}
+
+TEST_CASE("large constants", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Result),
+        make_word(0xffff),
+        make_lis(Reg::Result),
+        make_word(0x10000),
+        make_lis(Reg::Result),
+        make_word(0x12345),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(select_instructions(program)),
+        Catch::Matchers::Equals(word_to_uint({
+            make_ori(Reg::Result, Reg::Zero, 0xffff),
+            make_lui(Reg::Result, 1),
+            make_lis(Reg::Result),
+            make_word(0x12345),
+        }))
+    );
+}
+
+TEST_CASE("constants fold into their consumer", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        // the constant's register is overwritten by the add
+        make_lis(Reg::Result),
+        make_word(8),
+        make_add(Reg::Result, Reg::Scratch, Reg::Result),
+        // Scratch3 is dead once the add has consumed it
+        make_lis(Reg::Scratch3),
+        make_word(12),
+        make_add(Reg::Scratch, Reg::FramePtr, Reg::Scratch3),
+        // past an unrelated instruction
+        make_lis(Reg::Result),
+        make_word(4),
+        make_add(Reg::Scratch, Reg::Zero, Reg::Scratch2),
+        make_mult(Reg::Scratch, Reg::Result),
+        make_mflo(Reg::Result),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(select_instructions(program)),
+        Catch::Matchers::Equals(word_to_uint({
+            make_addi(Reg::Result, Reg::Scratch, 8),
+            make_addi(Reg::Scratch, Reg::FramePtr, 12),
+            make_add(Reg::Scratch, Reg::Zero, Reg::Scratch2),
+            make_sll(Reg::Result, Reg::Scratch, 2),
+        }))
+    );
+}
+
+TEST_CASE("live constants are kept", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Result),
+        make_word(8),
+        make_add(Reg::Scratch, Reg::Scratch, Reg::Result),
+        make_add(Reg::Scratch, Reg::Scratch, Reg::Result),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(select_instructions(program)),
+        Catch::Matchers::Equals(word_to_uint({
+            make_addi(Reg::Result, Reg::Zero, 8),
+            make_add(Reg::Scratch, Reg::Scratch, Reg::Result),
+            make_add(Reg::Scratch, Reg::Scratch, Reg::Result),
+        }))
+    );
+}
+
+TEST_CASE("division by constants", "[select_instructions]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Result),
+        make_word(8),
+        make_div(Reg::Scratch, Reg::Result),
+        make_mflo(Reg::Result),
+        make_lis(Reg::Result),
+        make_word(8),
+        make_divu(Reg::Scratch, Reg::Result),
+        make_mfhi(Reg::Result),
+    };
+
+    REQUIRE_THAT(
+        word_to_uint(select_instructions(program)),
+        Catch::Matchers::Equals(word_to_uint({
+            make_sra(Reg::Scratch3, Reg::Scratch, 31),
+            make_srl(Reg::Scratch3, Reg::Scratch3, 29),
+            make_add(Reg::Scratch3, Reg::Scratch3, Reg::Scratch),
+            make_sra(Reg::Result, Reg::Scratch3, 3),
+            make_andi(Reg::Result, Reg::Scratch, 7),
+        }))
+    );
+}
@@ -0,0 +1,52 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "utils.h"
+
+TEST_CASE("multiply by constants", "[strength_reduction]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    if (y == 0) {"
+        "        return (x * 0) + (x * 1) + (x * 2) + (x * 3);"
+        "    }"
+        "    if (y == 1) {"
+        "        return (5 * x) + (x * -6) + (-1 * x);"
+        "    }"
+        "    if (y == 2) {"
+        "        return (x * 16) + (x * 7) + (x * 1000);"
+        "    }"
+        "    return x * 65536;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 7, 0)) == 42);
+    REQUIRE(stoi(emulate(program, -7, 0)) == -42);
+    REQUIRE(stoi(emulate(program, 7, 1)) == -14);
+    REQUIRE(stoi(emulate(program, -3, 2)) == -3069);
+    REQUIRE(stoi(emulate(program, -3, 3)) == -196608);
+}
+
+TEST_CASE("divide by constants", "[strength_reduction]") {
+    std::string input =
+        "mod main;"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    if (y == 0) {"
+        "        return x / 1 + x / -1 + x % 1 + x % -1;"
+        "    }"
+        "    if (y == 1) {"
+        "        return (x / 4) * 100 + x % 4;"
+        "    }"
+        "    return (x / 7) * 100 + x % 7;"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 13, 0)) == 0);
+    REQUIRE(stoi(emulate(program, 13, 1)) == 301);
+    REQUIRE(stoi(emulate(program, -13, 1)) == -301);
+    REQUIRE(stoi(emulate(program, 30, 2)) == 402);
+    REQUIRE(stoi(emulate(program, -30, 2)) == -402);
+}
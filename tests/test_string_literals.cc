@@ -0,0 +1,58 @@
+#include <stdint.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "compile.h"
+#include "utils.h"
+
+static std::vector<uint32_t>
+compile_source(std::string source, CompileOptions options = {}) {
+    std::string file_name = test_file(".nl");
+    std::ofstream file {file_name};
+    file << source;
+    file.close();
+    return word_to_uint(compile({file_name}, options));
+}
+
+static std::string program(std::string first, std::string second) {
+    return "mod main;"
+           "import print;"
+           "fn main(x: i32, y: i32) -> i32 {"
+           "    print(\""
+        + first
+        + "\");"
+          "    print(\""
+        + second
+        + "\");"
+          "    return 0;"
+          "}";
+}
+
+TEST_CASE("identical string literals share data", "[string_literals]") {
+    CompileOptions options;
+    options.select_instructions = false;
+    auto shared = compile_source(program("Hello", "Hello"), options);
+    auto separate = compile_source(program("Hello", "World"), options);
+
+    // "World" and its terminator take a word per char
+    REQUIRE(separate.size() == shared.size() + 6);
+}
+
+TEST_CASE("packed string literals", "[string_literals]") {
+    CompileOptions options;
+    options.select_instructions = true;
+    auto shared = compile_source(program("Hello", "Hello"), options);
+    auto separate = compile_source(program("Hello", "World"), options);
+
+    REQUIRE(separate.size() == shared.size() + 2);
+    // "Hell" then "o" padded out by the terminator
+    std::vector<uint32_t> hello = {0x6c6c6548, 0x6f};
+    REQUIRE(
+        std::search(shared.begin(), shared.end(), hello.begin(), hello.end())
+        != shared.end()
+    );
+}
@@ -4,18 +4,16 @@
 
 #include "compile.h"
 #include "utils.h"
-#include "write_file.h"
 
 class StringModuleFixture {
   private:
-    static std::string file_name;
+    static std::vector<std::shared_ptr<Code>> program;
     static std::vector<std::string> input_file_paths;
     static bool initialized;
 
     static void initialize() {
         if (!initialized) {
-            auto program = compile(input_file_paths);
-            write_file(file_name, program);
+            program = compile(input_file_paths);
             initialized = true;
         }
     }
@@ -26,11 +24,11 @@ class StringModuleFixture {
     }
 
     std::string test_string_function(int test_code, int test_value) {
-        return emulate(file_name, test_code, test_value);
+        return emulate(program, test_code, test_value);
     }
 };
 
-std::string StringModuleFixture::file_name = "test_string_module.bin";
+std::vector<std::shared_ptr<Code>> StringModuleFixture::program;
 std::vector<std::string> StringModuleFixture::input_file_paths = {
     examples_dir + "/test_string_module.nl"};
 bool StringModuleFixture::initialized = false;
@@ -0,0 +1,66 @@
+#include <stdint.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nl_type.h"
+#include "nl_type_bool.h"
+#include "nl_type_char.h"
+#include "nl_type_i32.h"
+#include "nl_type_ptr.h"
+#include "nl_type_struct.h"
+#include "program_context.h"
+#include "typed_access.h"
+
+static NLTypeStruct make_struct(bool compact) {
+    auto char_type = std::make_shared<NLTypeChar>();
+    return NLTypeStruct(
+        "Node",
+        {{"tag", char_type},
+         {"next", std::make_shared<NLTypePtr>(char_type)},
+         {"flag", std::make_shared<NLTypeBool>()},
+         {"size", std::make_shared<NLTypeI32>()}},
+        compact
+    );
+}
+
+TEST_CASE("word layout", "[struct_layout]") {
+    ProgramContext program_context;
+    auto layout = struct_layout(make_struct(true), program_context);
+
+    REQUIRE(layout.offsets.at("tag") == 0);
+    REQUIRE(layout.offsets.at("next") == 4);
+    REQUIRE(layout.offsets.at("flag") == 8);
+    REQUIRE(layout.offsets.at("size") == 12);
+    REQUIRE(layout.bytes == 16);
+}
+
+TEST_CASE("packed layout keeps alignment", "[struct_layout]") {
+    ProgramContext program_context;
+    program_context.packed_chars = true;
+    auto layout = struct_layout(make_struct(false), program_context);
+
+    REQUIRE(layout.offsets.at("tag") == 0);
+    REQUIRE(layout.offsets.at("next") == 4);
+    REQUIRE(layout.offsets.at("flag") == 8);
+    REQUIRE(layout.offsets.at("size") == 12);
+    REQUIRE(layout.bytes == 16);
+    REQUIRE(
+        element_bytes(std::make_shared<NLTypeChar>(), program_context) == 1
+    );
+}
+
+TEST_CASE("compact layout reorders fields", "[struct_layout]") {
+    ProgramContext program_context;
+    program_context.packed_chars = true;
+    auto layout = struct_layout(make_struct(true), program_context);
+
+    REQUIRE(layout.offsets.at("next") == 0);
+    REQUIRE(layout.offsets.at("size") == 4);
+    REQUIRE(layout.offsets.at("tag") == 8);
+    REQUIRE(layout.offsets.at("flag") == 9);
+    REQUIRE(layout.bytes == 12);
+}
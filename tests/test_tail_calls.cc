@@ -0,0 +1,122 @@
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "compile.h"
+#include "utils.h"
+
+TEST_CASE("self tail call", "[tail_calls]") {
+    std::string input =
+        "mod main;"
+        "fn sum(n: i32, acc: i32) -> i32 {"
+        "    if (n == 0) {"
+        "        return acc;"
+        "    }"
+        "    return sum(n - 1, acc + n);"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return sum(x, y);"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 10, 0)) == 55);
+    // far deeper than the stack could hold frames for
+    REQUIRE(stoi(emulate(program, 1000000, 0)) == 1784293664);
+}
+
+TEST_CASE("self tail call with stack parameters", "[tail_calls]") {
+    std::string input =
+        "mod main;"
+        "fn rotate(n: i32, a: i32, b: i32, c: i32, d: i32, e: i32) -> i32 {"
+        "    if (n == 0) {"
+        "        return a + 2 * b + 3 * c + 4 * d + 5 * e;"
+        "    }"
+        "    return rotate(n - 1, e, a, b, c, d);"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return rotate(x, y, 0, 0, 0, 0);"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 0, 1)) == 1);
+    REQUIRE(stoi(emulate(program, 3, 1)) == 4);
+    REQUIRE(stoi(emulate(program, 100003, 1)) == 4);
+}
+
+TEST_CASE("mutual tail calls", "[tail_calls]") {
+    std::string input =
+        "mod main;"
+        "fn is_even(n: i32) -> i32 {"
+        "    if (n == 0) {"
+        "        return 1;"
+        "    }"
+        "    return is_odd(n - 1);"
+        "}"
+        "fn is_odd(n: i32) -> i32 {"
+        "    if (n == 0) {"
+        "        return 0;"
+        "    }"
+        "    return is_even(n - 1);"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    return is_even(x);"
+        "}";
+
+    auto program = compile_test(input);
+
+    REQUIRE(stoi(emulate(program, 7, 0)) == 0);
+    REQUIRE(stoi(emulate(program, 1000000, 0)) == 1);
+}
+
+TEST_CASE("tail calls keep a frame that is pointed into", "[tail_calls]") {
+    std::string input =
+        "mod main;"
+        "fn read(p: *i32, x: i32) -> i32 {"
+        "    let local = 11;"
+        "    let q = &local;"
+        "    let i = 0;"
+        "    while (i < x) {"
+        "        *q = *q + i * i - i;"
+        "        *q = *q * 3 - *q * 2;"
+        "        i = i + 1;"
+        "    }"
+        "    return *p + *q - *q;"
+        "}"
+        "fn f(x: i32) -> i32 {"
+        "    let local = 777;"
+        "    return read(&local, x);"
+        "}"
+        "fn g(x: i32, p: *i32) -> i32 {"
+        "    let local = x;"
+        "    if (x == 0) {"
+        "        return *p;"
+        "    }"
+        "    return g(x - 1, &local);"
+        "}"
+        "fn main(x: i32, y: i32) -> i32 {"
+        "    if (y == 0) {"
+        "        return f(x);"
+        "    }"
+        "    return g(x, &y);"
+        "}";
+
+    std::string file_name = test_file(".nl");
+    std::ofstream file {file_name};
+    file << input;
+    file.close();
+
+    for (uint32_t inline_threshold : {40u, 0u}) {
+        CompileOptions options;
+        options.inline_threshold = inline_threshold;
+        auto program = compile({file_name}, options);
+
+        REQUIRE(stoi(emulate(program, 3, 0)) == 777);
+        // each call reads the local of the one before it
+        REQUIRE(stoi(emulate(program, 2, 5)) == 1);
+        REQUIRE(stoi(emulate(program, 0, 5)) == 5);
+    }
+}
@@ -3,9 +3,6 @@
 #include <string>
 
 #include "utils.h"
-#include "write_file.h"
-
-static std::string file_name = "test_while_loop.bin";
 
 TEST_CASE("while loop", "[loops]") {
     std::string input =
@@ -19,7 +16,6 @@ TEST_CASE("while loop", "[loops]") {
         "}";
 
     auto program = compile_test(input);
-    write_file(file_name, program);
 
-    REQUIRE(stoi(emulate(file_name, 10, 0)) == 10);
+    REQUIRE(stoi(emulate(program, 10, 0)) == 10);
 }
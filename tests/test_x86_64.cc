@@ -0,0 +1,192 @@
+
+#include <stdint.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "assembly.h"
+#include "beq_label.h"
+#include "compile.h"
+#include "define_label.h"
+#include "elim_labels.h"
+#include "emulator.h"
+#include "label.h"
+#include "reg.h"
+#include "use_label.h"
+#include "utils.h"
+#include "word.h"
+#include "write_file.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Code;
+
+struct NativeResult {
+    std::string output;
+    // wait status of the process
+    int status;
+};
+
+// writes program as an executable and runs it with input1 and input2
+static NativeResult run_native(
+    const LabelledProgram& program,
+    int32_t input1,
+    int32_t input2
+) {
+    std::string path = "./" + test_file("");
+    write_elf(path, program.code, program.data);
+    std::string arg1 = std::to_string(input1);
+    std::string arg2 = std::to_string(input2);
+
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        dup2(fds[1], 1);
+        close(fds[0]);
+        close(fds[1]);
+        execl(path.c_str(), path.c_str(), arg1.c_str(), arg2.c_str(), nullptr);
+        _exit(127);
+    }
+    close(fds[1]);
+    NativeResult result;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fds[0], buffer, sizeof(buffer))) > 0) {
+        result.output.append(buffer, size);
+    }
+    close(fds[0]);
+    waitpid(pid, &result.status, 0);
+    return result;
+}
+
+// runs program natively and in the emulator, which must agree on the output
+// and on the result as far as an exit status holds it
+static void require_same(
+    const LabelledProgram& program,
+    int32_t input1,
+    int32_t input2
+) {
+    auto words = program.code;
+    words.insert(words.end(), program.data.begin(), program.data.end());
+    auto emulated = run(word_to_uint(elim_labels(words)), input1, input2);
+    auto native = run_native(program, input1, input2);
+    REQUIRE(native.output == emulated.output);
+    REQUIRE(WIFEXITED(native.status));
+    REQUIRE(WEXITSTATUS(native.status) == (emulated.result & 0xff));
+}
+
+TEST_CASE("native inputs, result and printing", "[x86_64]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_lis(Reg::Scratch),
+        make_word(PRINT_ADDRESS),
+        make_addi(Reg::Scratch2, Reg::Input1, '0'),
+        make_sb(Reg::Scratch2, 0, Reg::Scratch),
+        make_sw(Reg::Input2, 0, Reg::Scratch),
+        make_sub(Reg::Result, Reg::Input1, Reg::Input2),
+        make_jr(Reg::Link),
+    };
+
+    auto result = run_native({program, {}}, 7, 'x');
+    REQUIRE(result.output == "7x");
+    REQUIRE(WIFEXITED(result.status));
+    REQUIRE(WEXITSTATUS(result.status) == ((7 - 'x') & 0xff));
+    require_same({program, {}}, 3, -5);
+}
+
+TEST_CASE("native division, shifts and bytes", "[x86_64]") {
+    std::vector<std::shared_ptr<Code>> program = {
+        make_div(Reg::Input1, Reg::Input2),
+        make_mflo(Reg::Result),
+        make_mfhi(Reg::Scratch),
+        make_sll(Reg::Result, Reg::Result, 4),
+        make_add(Reg::Result, Reg::Result, Reg::Scratch),
+        make_addi(Reg::Scratch, Reg::Zero, 1),
+        make_srav(Reg::Result, Reg::Result, Reg::Scratch),
+        make_sw(Reg::Result, (uint16_t)-4, Reg::StackPtr),
+        make_lb(Reg::Scratch, (uint16_t)-4, Reg::StackPtr),
+        make_slt(Reg::Scratch, Reg::Scratch, Reg::Zero),
+        make_sub(Reg::Result, Reg::Result, Reg::Scratch),
+        make_jr(Reg::Link),
+    };
+
+    require_same({program, {}}, 47, 5);
+    require_same({program, {}}, -47, 5);
+    require_same({program, {}}, INT32_MIN, -1);
+}
+
+TEST_CASE("native faults end the process with a signal", "[x86_64]") {
+    std::vector<std::shared_ptr<Code>> divide = {
+        make_div(Reg::Input1, Reg::Input2),
+        make_jr(Reg::Link),
+    };
+    REQUIRE(WIFSIGNALED(run_native({divide, {}}, 1, 0).status));
+
+    std::vector<std::shared_ptr<Code>> jump = {
+        make_addi(Reg::TargetPC, Reg::Zero, 2),
+        make_jr(Reg::TargetPC),
+    };
+    REQUIRE(WIFSIGNALED(run_native({jump, {}}, 0, 0).status));
+}
+
+TEST_CASE("native labels of the program and its data", "[x86_64]") {
+    auto value = std::make_shared<Label>("value");
+    auto skip = std::make_shared<Label>("skip");
+    auto square = std::make_shared<Label>("square");
+    std::vector<std::shared_ptr<Code>> code = {
+        make_add(Reg::Local1, Reg::Link, Reg::Zero),
+        make_lis(Reg::Scratch),
+        make_use(value),
+        make_lw(Reg::Result, 0, Reg::Scratch),
+        make_beq(Reg::Input1, Reg::Zero, skip),
+        make_lis(Reg::TargetPC),
+        make_use(square),
+        make_jalr(Reg::TargetPC),
+        make_define(skip),
+        make_add(Reg::Result, Reg::Result, Reg::Input2),
+        make_jr(Reg::Local1),
+        make_define(square),
+        make_mult(Reg::Result, Reg::Result),
+        make_mflo(Reg::Result),
+        make_jr(Reg::Link),
+    };
+    std::vector<std::shared_ptr<Code>> data = {
+        make_word(0),
+        make_define(value),
+        make_word(7),
+    };
+
+    require_same({code, data}, 1, 2);
+    require_same({code, data}, 0, 2);
+    REQUIRE(WEXITSTATUS(run_native({code, data}, 1, 2).status) == 51);
+}
+
+TEST_CASE("native examples match the emulator", "[x86_64]") {
+    auto print_module =
+        compile_labelled({examples_dir + "/test_print_module.nl"});
+    require_same(print_module, 5, -3);
+    require_same(print_module, 2, 1234);
+
+    auto list_module =
+        compile_labelled({examples_dir + "/test_list_module.nl"});
+    require_same(list_module, 3, 7);
+
+    CompileOptions options;
+    options.select_instructions = false;
+    auto string_module =
+        compile_labelled({examples_dir + "/test_string_module.nl"}, options);
+    require_same(string_module, 1, 5);
+
+    CompileOptions gc_options;
+    gc_options.gc = true;
+    auto gc = compile_labelled({examples_dir + "/test_gc.nl"}, gc_options);
+    require_same(gc, 3000, 100);
+}
+
+#endif
@@ -1,25 +1,19 @@
 
 #include "utils.h"
 
-#include <cstdlib>
-#include <fstream>
-#include <iostream>
+#include <catch2/interfaces/catch_interfaces_capture.hpp>
+#include <cctype>
 #include <map>
 #include <span>
-#include <sstream>
 #include <string>
 
 #include "assembly.h"
 #include "block.h"
 #include "call.h"
 #include "chunk.h"
-#include "elim_calls.h"
-#include "elim_if_stmts.h"
+#include "compile_procedure.h"
 #include "elim_labels.h"
-#include "elim_ret_stmts.h"
-#include "elim_scopes.h"
-#include "elim_vars_proc.h"
-#include "entry_exit.h"
+#include "emulator.h"
 #include "extract_symbols.h"
 #include "flatten.h"
 #include "nex_lang_parsing.h"
@@ -34,8 +28,6 @@
 struct TypedProcedure;
 struct Variable;
 
-static const uint32_t TERMINATION_PC = 0b11111110111000011101111010101101;
-
 std::vector<uint32_t> word_to_uint(std::vector<std::shared_ptr<Code>> program) {
     std::vector<uint32_t> result;
     for (auto code : program) {
@@ -46,22 +38,23 @@ std::vector<uint32_t> word_to_uint(std::vector<std::shared_ptr<Code>> program) {
     return result;
 }
 
-std::string emulate(std::string file_name, int32_t input1, int32_t input2) {
-    const std::string emulator_path(EMULATOR_PATH);
-    const std::string output_file("test_output.txt");
-
-    std::system((emulator_path + " " + file_name + " " + std::to_string(input1)
-                 + " " + std::to_string(input2) + " > " + output_file)
-                    .c_str());
+std::string emulate(
+    const std::vector<std::shared_ptr<Code>>& program,
+    int32_t input1,
+    int32_t input2
+) {
+    auto result = run_jit(word_to_uint(program), input1, input2);
+    return result.output + std::to_string(result.result) + "\n";
+}
 
-    std::ifstream file(output_file);
-    if (!file) {
-        std::cerr << "Output file not found!" << std::endl;
-        exit(1);
+std::string test_file(std::string extension) {
+    std::string name = Catch::getResultCapture().getCurrentTestName();
+    for (char& c : name) {
+        if (!std::isalnum((unsigned char)c)) {
+            c = '_';
+        }
     }
-    std::stringstream ss;
-    ss << file.rdbuf();
-    return ss.str();
+    return "test_" + name + extension;
 }
 
 std::vector<std::shared_ptr<Code>> compile_test(std::string input) {
@@ -88,11 +81,6 @@ std::vector<std::shared_ptr<Code>> compile_test(std::string input) {
         }
     }
 
-    std::map<std::shared_ptr<Procedure>, std::shared_ptr<Chunk>> param_chunks;
-    for (auto proc : procedures) {
-        param_chunks[proc] = std::make_shared<Chunk>(proc->parameters);
-    }
-
     auto start_proc = std::make_shared<Procedure>(
         "start_proc",
         std::vector<std::shared_ptr<Variable>> {}
@@ -106,37 +94,7 @@ std::vector<std::shared_ptr<Code>> compile_test(std::string input) {
     procedures.insert(procedures.begin(), start_proc);
 
     for (auto proc : procedures) {
-        ElimCalls elim_calls {proc, param_chunks};
-        proc->code = proc->code->accept(elim_calls);
-
-        ElimIfStmts elim_if_stmts;
-        proc->code = proc->code->accept(elim_if_stmts);
-
-        ElimRetStmts elim_ret_stmts {proc->end_label};
-        proc->code = proc->code->accept(elim_ret_stmts);
-
-        ElimScopes elim_scopes;
-        proc->code = proc->code->accept(elim_scopes);
-        auto local_vars = elim_scopes.get();
-
-        std::vector<std::shared_ptr<Variable>> all_local_vars = {
-            proc->param_ptr,
-            proc->dynamic_link,
-            proc->saved_pc};
-        all_local_vars
-            .insert(all_local_vars.end(), local_vars.begin(), local_vars.end());
-        std::shared_ptr<Chunk> local_vars_chunk =
-            std::make_shared<Chunk>(all_local_vars);
-
-        proc->code = add_entry_exit(proc, local_vars_chunk);
-
-        auto param_chunk = std::make_shared<Chunk>(proc->parameters);
-        ElimVarsProc elim_vars_proc(
-            local_vars_chunk,
-            param_chunk,
-            proc->param_ptr
-        );
-        proc->code = proc->code->accept(elim_vars_proc);
+        compile_procedure(proc);
     }
 
     std::vector<std::shared_ptr<Code>> all_code;
@@ -15,5 +15,13 @@ struct Code;
 static const std::string examples_dir(NL_EXAMPLES_PATH);
 
 std::vector<uint32_t> word_to_uint(std::vector<std::shared_ptr<Code>> program);
-std::string emulate(std::string file_path, int32_t input1, int32_t input2);
+// runs program in process, returns what it printed followed by its result
+std::string emulate(
+    const std::vector<std::shared_ptr<Code>>& program,
+    int32_t input1,
+    int32_t input2
+);
+// file name unique to the running test case, test cases run in parallel
+// processes and must not share files
+std::string test_file(std::string extension);
 std::vector<std::shared_ptr<Code>> compile_test(std::string input);